@@ -38,7 +38,8 @@ typedef enum {
 	kPathSavedGames,
 	kPathQuickSaves,
 	kPathImageCache,
-	kPathRecordings
+	kPathRecordings,
+	kPathCache
 } CSPathType;
 
 std::string get_data_path(CSPathType type);
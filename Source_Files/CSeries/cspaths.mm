@@ -144,6 +144,9 @@ std::string get_data_path(CSPathType type)
 		case kPathRecordings:
 			path = _get_local_data_path() + "/Recordings";
 			break;
+		case kPathCache:
+			path = _get_local_data_path() + "/Cache";
+			break;
 	}
 	return path;
 }
@@ -45,6 +45,14 @@ extern void myTMCleanup();
 extern bool take_mytm_mutex();
 extern bool release_mytm_mutex();
 
+// Like take_mytm_mutex(), but gives up at once when someone else holds the mutex
+extern bool try_take_mytm_mutex();
+
+// Work handed over by threads that found the mutex taken: whoever releases the mutex runs
+// it first (still holding the mutex) whenever pending() says there is some.  Pass NULLs to
+// stop.  pending() is called without the mutex, so it must be cheap and thread-safe.
+extern void set_mytm_deferred_work(bool (*pending)(void), void (*run)(void));
+
 // ghs: exception-safe version of above
 class MyTMMutexTaker
 {
@@ -84,6 +84,11 @@ struct myTMTask {
 // Only one TMTask should be scheduled at any given time, so they take this mutex.
 static SDL_mutex* sTMTaskMutex = NULL;
 
+// Work left behind for whoever holds the mutex next; see set_mytm_deferred_work()
+static std::atomic<bool (*)(void)> sDeferredWorkPending(NULL);
+static std::atomic<void (*)(void)> sDeferredWork(NULL);
+static int sMutexDepth = 0;	// the mutex is recursive; only touched with it held
+
 
 void
 mytm_initialize() {
@@ -107,16 +112,73 @@ take_mytm_mutex() {
     bool success = (SDL_LockMutex(sTMTaskMutex) != -1);
     if(!success)
         logAnomaly("take_mytm_mutex(): SDL_LockMutex() failed: %s", SDL_GetError());
+    else
+        sMutexDepth++;
+    return success;
+}
+
+
+
+bool
+try_take_mytm_mutex() {
+    bool success = (SDL_TryLockMutex(sTMTaskMutex) == 0);
+    if(success)
+        sMutexDepth++;
     return success;
 }
 
 
 
+void
+set_mytm_deferred_work(bool (*pending)(void), void (*run)(void)) {
+    sDeferredWorkPending = pending;
+    sDeferredWork = run;
+}
+
+
+
+static bool
+deferred_work_pending() {
+    bool (*pending)(void) = sDeferredWorkPending;
+    return pending && pending();
+}
+
+
+
+// Call with the mutex held once, not from inside some holder's own taking and releasing
+static void
+run_deferred_work() {
+    void (*run)(void) = sDeferredWork;
+    if(run && deferred_work_pending())
+        run();
+}
+
+
+
 bool
 release_mytm_mutex() {
+    bool outermost = (sMutexDepth == 1);
+    if(outermost)
+        run_deferred_work();
+
+    sMutexDepth--;
     bool success = (SDL_UnlockMutex(sTMTaskMutex) != -1);
-    if(!success)
+    if(!success) {
+        sMutexDepth++;
         logAnomaly("release_mytm_mutex(): SDL_UnlockMutex() failed: %s", SDL_GetError());
+    }
+
+    // Someone may have left work and then found the mutex still taken, just before we let go;
+    // nobody else would pick it up until the mutex is next released.
+    while(success && outermost) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(!deferred_work_pending() || !try_take_mytm_mutex())
+            break;
+        run_deferred_work();
+        sMutexDepth--;
+        SDL_UnlockMutex(sTMTaskMutex);
+    }
+
     return success;
 }
 
@@ -183,7 +245,9 @@ thread_loop(void* inData) {
         bool runAgain = true;
 
         // Lock out other tmtasks while we run ours
+        // (anything handed over while waiting for the mutex goes before the task, so it sees it)
         if(take_mytm_mutex()) {
+            run_deferred_work();
             runAgain = theTMTask->mFunction();
             release_mytm_mutex();
         }
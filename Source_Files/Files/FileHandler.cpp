@@ -91,7 +91,7 @@ namespace fs = boost::filesystem;
 
 // From shell_sdl.cpp
 extern vector<DirectorySpecifier> data_search_path;
-extern DirectorySpecifier local_data_dir, preferences_dir, saved_games_dir, quick_saves_dir, image_cache_dir, recordings_dir;
+extern DirectorySpecifier local_data_dir, preferences_dir, saved_games_dir, quick_saves_dir, image_cache_dir, recordings_dir, cache_dir;
 
 extern bool is_applesingle(SDL_RWops *f, bool rsrc_fork, int32 &offset, int32 &length);
 extern bool is_macbinary(SDL_RWops *f, int32 &data_length, int32 &rsrc_length);
@@ -742,6 +742,12 @@ void FileSpecifier::SetToRecordingsDir()
 	name = recordings_dir.name;
 }
 
+// Set to cache directory
+void FileSpecifier::SetToCacheDir()
+{
+	name = cache_dir.name;
+}
+
 static string local_path_separators(const char *path)
 {
 	string local_path = path;
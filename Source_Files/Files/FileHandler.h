@@ -322,6 +322,7 @@ public:
 	void SetToQuickSavesDir();		// Directory for auto-named saved games (per-user)
 	void SetToImageCacheDir();		// Directory for image cache (per-user)
 	void SetToRecordingsDir();		// Directory for recordings (per-user)
+	void SetToCacheDir();			// Directory for cached data worked out from other files (per-user)
 
 	void AddPart(const string &part);
 	FileSpecifier &operator+=(const FileSpecifier &other) {AddPart(other.name); return *this;}
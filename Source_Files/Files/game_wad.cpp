@@ -94,6 +94,9 @@ Feb 15, 2002 (Br'fin (Jeremy Parsons)):
 #include "player.h"
 #include "platforms.h"
 #include "flood_map.h"
+#include "polygon_adjacency.h"
+#include "collision_grid.h"
+#include "visibility_sets.h"
 #include "scenery.h"
 #include "lightsource.h"
 #include "media.h"
@@ -379,6 +382,7 @@ void complete_loading_level(
 	/* Scan, add the doors, recalculate, and generally tie up all loose ends */
 	/* Recalculate the redundant data.. */
 	load_redundant_map_data(_map_indexes, map_index_count);
+	build_polygon_adjacency();
 
 	static_platforms.clear();
 
@@ -942,6 +946,9 @@ void allocate_map_for_counts(
 	// Stuff that needs the max number of polygons
 	allocate_render_memory();
 	allocate_flood_map_memory();
+	clear_polygon_adjacency();
+	clear_collision_grid();
+	clear_visibility_sets();
 }
 
 void load_points(
@@ -1230,6 +1237,9 @@ void recalculate_redundant_map(
 	for(loop=0;loop<dynamic_world->polygon_count;++loop) recalculate_redundant_polygon_data(loop);
 	for(loop=0;loop<dynamic_world->line_count;++loop) recalculate_redundant_line_data(loop);
 	for(loop=0;loop<dynamic_world->endpoint_count;++loop) recalculate_redundant_endpoint_data(loop);
+	
+	/* precalculate_map_indexes() floods */
+	build_polygon_adjacency();
 }
 
 bool load_game_from_file(FileSpecifier& File, bool run_scripts)
@@ -2706,6 +2716,8 @@ static void complete_restoring_level(
 	ok_to_reset_scenery_solidity = false;
 	/* Loading games needs this done. */
 	reset_action_queues();
+
+	build_polygon_adjacency();
 }
 
 
@@ -0,0 +1,250 @@
+/*
+COLLISION_GRID.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "collision_grid.h"
+#include "map.h"
+#include "dynamic_limits.h"
+#include "monsters.h"
+#include "scenery.h"
+
+#include <algorithm>
+
+/* ---------- globals */
+
+static int32 cell_size= 0; /* zero if the grid isn't built */
+static int32 origin_x, origin_y;
+static int32 column_count, row_count;
+static std::vector<std::vector<short> > cells; /* unordered; queries sort what they find */
+static std::vector<int32> object_cells; /* per object, the cell it's filed in or NONE */
+static world_distance maximum_object_radius= 0;
+
+/* generation-stamped so queries don't have to clear it */
+static std::vector<uint32> polygon_marks;
+static uint32 polygon_mark_generation= 0;
+
+/* ---------- private prototypes */
+
+static int32 get_cell_column(int32 x);
+static int32 get_cell_row(int32 y);
+static int32 get_object_cell(struct object_data *object);
+static void unfile_object(short object_index, int32 cell_index);
+static void mark_polygon_neighbors(short polygon_index);
+
+/* ---------- code */
+
+void build_collision_grid(
+	void)
+{
+	int32 minimum_x= INT16_MAX, minimum_y= INT16_MAX;
+	int32 maximum_x= INT16_MIN, maximum_y= INT16_MIN;
+	short polygon_index;
+
+	clear_collision_grid();
+
+	if (get_dynamic_limit(_dynamic_limit_collision_grid)==0 || dynamic_world->endpoint_count==0) return;
+
+	for (short endpoint_index= 0; endpoint_index<dynamic_world->endpoint_count; ++endpoint_index)
+	{
+		world_point2d *vertex= &get_endpoint_data(endpoint_index)->vertex;
+
+		minimum_x= std::min<int32>(minimum_x, vertex->x), maximum_x= std::max<int32>(maximum_x, vertex->x);
+		minimum_y= std::min<int32>(minimum_y, vertex->y), maximum_y= std::max<int32>(maximum_y, vertex->y);
+	}
+
+	cell_size= get_dynamic_limit(_dynamic_limit_collision_grid);
+	origin_x= minimum_x, origin_y= minimum_y;
+	column_count= (maximum_x-minimum_x)/cell_size + 1;
+	row_count= (maximum_y-minimum_y)/cell_size + 1;
+	cells.resize(column_count*row_count);
+	object_cells.assign(MAXIMUM_OBJECTS_PER_MAP, NONE);
+	polygon_marks.assign(dynamic_world->polygon_count, 0);
+	polygon_mark_generation= 0;
+
+	/* MML and physics are loaded by now; nothing changes the definitions during a level */
+	maximum_object_radius= std::max(get_maximum_monster_radius(), get_maximum_scenery_radius());
+
+	/* only objects in a polygon's list; parasites ride along with their hosts */
+	for (polygon_index= 0; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+	{
+		short object_index;
+
+		for (object_index= get_polygon_data(polygon_index)->first_object; object_index!=NONE; object_index= get_object_data(object_index)->next_object)
+		{
+			add_object_to_collision_grid(object_index);
+		}
+	}
+}
+
+void clear_collision_grid(
+	void)
+{
+	cell_size= 0;
+	cells.clear();
+	object_cells.clear();
+	polygon_marks.clear();
+}
+
+bool collision_grid_enabled(
+	void)
+{
+	return cell_size!=0;
+}
+
+world_distance get_collision_grid_object_radius(
+	void)
+{
+	return maximum_object_radius;
+}
+
+void add_object_to_collision_grid(
+	short object_index)
+{
+	if (cell_size)
+	{
+		int32 cell_index= get_object_cell(get_object_data(object_index));
+
+		if (static_cast<size_t>(object_index)>=object_cells.size()) object_cells.resize(object_index+1, NONE);
+		if (object_cells[object_index]!=NONE) unfile_object(object_index, object_cells[object_index]);
+
+		cells[cell_index].push_back(object_index);
+		object_cells[object_index]= cell_index;
+	}
+}
+
+void remove_object_from_collision_grid(
+	short object_index)
+{
+	if (cell_size && static_cast<size_t>(object_index)<object_cells.size() && object_cells[object_index]!=NONE)
+	{
+		unfile_object(object_index, object_cells[object_index]);
+		object_cells[object_index]= NONE;
+	}
+}
+
+void move_object_in_collision_grid(
+	short object_index)
+{
+	if (cell_size && static_cast<size_t>(object_index)<object_cells.size() && object_cells[object_index]!=NONE)
+	{
+		int32 cell_index= get_object_cell(get_object_data(object_index));
+
+		if (cell_index!=object_cells[object_index])
+		{
+			unfile_object(object_index, object_cells[object_index]);
+			cells[cell_index].push_back(object_index);
+			object_cells[object_index]= cell_index;
+		}
+	}
+}
+
+void get_collision_grid_objects(
+	const short *polygon_indexes,
+	size_t polygon_count,
+	const world_point2d *p0,
+	const world_point2d *p1,
+	world_distance distance,
+	std::vector<short>& object_indexes)
+{
+	object_indexes.clear();
+	if (!cell_size) return;
+
+	if (++polygon_mark_generation==0)
+	{
+		std::fill(polygon_marks.begin(), polygon_marks.end(), 0);
+		polygon_mark_generation= 1;
+	}
+	for (size_t i= 0; i<polygon_count; ++i) mark_polygon_neighbors(polygon_indexes[i]);
+
+	int32 left= std::min<int32>(p0->x, p1->x) - distance, right= std::max<int32>(p0->x, p1->x) + distance;
+	int32 top= std::min<int32>(p0->y, p1->y) - distance, bottom= std::max<int32>(p0->y, p1->y) + distance;
+	int32 first_column= get_cell_column(left), last_column= get_cell_column(right);
+	int32 first_row= get_cell_row(top), last_row= get_cell_row(bottom);
+
+	for (int32 row= first_row; row<=last_row; ++row)
+	{
+		for (int32 column= first_column; column<=last_column; ++column)
+		{
+			const std::vector<short>& cell= cells[row*column_count + column];
+
+			for (size_t j= 0; j<cell.size(); ++j)
+			{
+				struct object_data *object= get_object_data(cell[j]);
+
+				if (object->location.x>=left && object->location.x<=right &&
+					object->location.y>=top && object->location.y<=bottom &&
+					polygon_marks[object->polygon]==polygon_mark_generation)
+				{
+					object_indexes.push_back(cell[j]);
+				}
+			}
+		}
+	}
+
+	/* cells are filed in whatever order objects moved; the index order is the same everywhere */
+	std::sort(object_indexes.begin(), object_indexes.end());
+}
+
+/* ---------- private code */
+
+/* objects can stray outside the map's bounding box; they go in the nearest edge cell */
+static int32 get_cell_column(
+	int32 x)
+{
+	return PIN((x-origin_x)/cell_size, 0, column_count-1);
+}
+
+static int32 get_cell_row(
+	int32 y)
+{
+	return PIN((y-origin_y)/cell_size, 0, row_count-1);
+}
+
+static int32 get_object_cell(
+	struct object_data *object)
+{
+	return get_cell_row(object->location.y)*column_count + get_cell_column(object->location.x);
+}
+
+static void unfile_object(
+	short object_index,
+	int32 cell_index)
+{
+	std::vector<short>& cell= cells[cell_index];
+	std::vector<short>::iterator it= std::find(cell.begin(), cell.end(), object_index);
+
+	assert(it!=cell.end());
+	*it= cell.back();
+	cell.pop_back();
+}
+
+/* the same neighborhood possible_intersecting_monsters() walks */
+static void mark_polygon_neighbors(
+	short polygon_index)
+{
+	struct polygon_data *polygon= get_polygon_data(polygon_index);
+	short *neighbor_indexes= get_map_indexes(polygon->first_neighbor_index, polygon->neighbor_count);
+
+	if (!neighbor_indexes) return;
+
+	for (short i= 0; i<polygon->neighbor_count; ++i)
+	{
+		if (!POLYGON_IS_DETACHED(get_polygon_data(neighbor_indexes[i]))) polygon_marks[neighbor_indexes[i]]= polygon_mark_generation;
+	}
+}
@@ -0,0 +1,61 @@
+#ifndef COLLISION_GRID_H
+#define COLLISION_GRID_H
+
+/*
+COLLISION_GRID.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	An optional uniform grid over the map's x,y extent that files every object in a polygon's
+	object list by the cell its center is in, so collision checks can find the objects near a
+	point or a segment without walking every object in every neighboring polygon.
+
+	The grid only exists when the collision_grid dynamic limit is nonzero.  Queries return their
+	objects sorted by object index, so results depend only on the world state and not on the
+	order objects happened to be filed in; that keeps films and network games in step, but the
+	order differs from the polygon-list walk, so the setting must match between recording and
+	playback.
+*/
+
+#include "cseries.h"
+#include "world.h"
+
+#include <vector>
+
+/* builds the grid over the current map and files every object already in a polygon; does
+	nothing unless the collision_grid dynamic limit is set */
+void build_collision_grid(void);
+void clear_collision_grid(void);
+
+bool collision_grid_enabled(void);
+
+/* the largest radius of any monster or scenery type, as of the last build_collision_grid() */
+world_distance get_collision_grid_object_radius(void);
+
+/* these do nothing if the grid isn't built; move_object_in_collision_grid() also does nothing
+	for objects that aren't filed (e.g., parasites) */
+void add_object_to_collision_grid(short object_index);
+void remove_object_from_collision_grid(short object_index);
+void move_object_in_collision_grid(short object_index);
+
+/* replaces object_indexes with the indexes, in ascending order, of every filed object whose center is
+	within distance (on each axis) of the bounding box of p0,p1 and whose polygon is a
+	non-detached neighbor of one of the given polygons */
+void get_collision_grid_objects(const short *polygon_indexes, size_t polygon_count,
+	const world_point2d *p0, const world_point2d *p1, world_distance distance, std::vector<short>& object_indexes);
+
+#endif
@@ -67,6 +67,7 @@ Feb 3, 2003 (Woody Zenfell):
 #include "computer_interface.h"
 //#include "music.h"
 #include "lightsource.h"
+#include "world_snapshot.h"
 #include "game_window.h"
 #include "items.h"
 #include "shell.h"	// screen_printf()
@@ -249,6 +250,7 @@ void initialize_control_panels_for_level(
 			struct control_panel_definition *definition= get_control_panel_definition(side->control_panel_type);
 			if (!definition)
 			{
+				world_changed(side);
 				SET_SIDE_CONTROL_PANEL(side,false);
 				continue;
 			}
@@ -272,12 +274,14 @@ void initialize_control_panels_for_level(
 					}
 					else
 					{
+						world_changed(side);
 						SET_SIDE_CONTROL_PANEL(side, false);
 						continue;
 					}
 					break;
 			}
 			
+			world_changed(side);
 			SET_CONTROL_PANEL_STATUS(side, status);
 			set_control_panel_texture(side);
 		}
@@ -467,6 +471,7 @@ void assume_correct_switch_position(
 			if (switch_type==definition->_class)
 			{
 				play_control_panel_sound(side_index, new_state ? _activating_sound : _deactivating_sound);
+				world_changed(side);
 				SET_CONTROL_PANEL_STATUS(side, new_state);
 				set_control_panel_texture(side);
 			}
@@ -490,7 +495,11 @@ void try_and_toggle_control_panel(
 			bool should_destroy_switch;
 			if (switch_can_be_toggled(side_index, false, &should_destroy_switch))
 			{
-				if (should_destroy_switch) SET_SIDE_CONTROL_PANEL(side, false);
+				if (should_destroy_switch)
+				{
+					world_changed(side);
+					SET_SIDE_CONTROL_PANEL(side, false);
+				}
 				bool make_sound = false, state= GET_CONTROL_PANEL_STATUS(side);
 				struct control_panel_definition *definition= get_control_panel_definition(side->control_panel_type);
 				// LP change: idiot-proofing
@@ -507,6 +516,7 @@ void try_and_toggle_control_panel(
 							definition->item != NONE) make_sound = true;
 						if (make_sound)
 						{
+							world_changed(side);
 							SET_CONTROL_PANEL_STATUS(side, state);
 							set_control_panel_texture(side);
 						}
@@ -620,6 +630,7 @@ short find_action_key_target(
 					{
 						if (should_destroy_panel && perform_panel_actions)
 						{
+							world_changed(get_side_data(itemhit));
 							SET_SIDE_CONTROL_PANEL(get_side_data(itemhit), false);
 						}
 						*target_type= _target_is_control_panel;
@@ -743,6 +754,7 @@ static void	change_panel_state(
 		case _panel_is_triple_shield_refuel:
 			player->control_panel_side_index= player->control_panel_side_index==panel_side_index ? NONE : panel_side_index;
 			state= get_recharge_status(panel_side_index);
+			world_changed(side);
 			SET_CONTROL_PANEL_STATUS(side, state);
 			if (!state)
 			{
@@ -782,6 +794,7 @@ static void	change_panel_state(
 				if (!side->control_panel_permutation) make_sound= true;
 				if (make_sound)
 				{
+					world_changed(side);
 					SET_CONTROL_PANEL_STATUS(side, state);
 					set_control_panel_texture(side);
 				}
@@ -863,6 +876,7 @@ void set_control_panel_texture(
 	// LP change: idiot-proofing
 	if (!definition) return;
 	
+	world_changed(side);
 	side->primary_texture.texture= BUILD_DESCRIPTOR(definition->collection,
 		GET_CONTROL_PANEL_STATUS(side) ? definition->active_shape : definition->inactive_shape);
 }
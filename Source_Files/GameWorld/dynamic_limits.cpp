@@ -54,6 +54,9 @@ static uint16 m2_dynamic_limits[NUMBER_OF_DYNAMIC_LIMITS] =
 	4096, // Ephemeral objects (render effects)
 	256,	// Garbage objects (corpses) across the whole map
 	10,	// Garbage objects (corpses) in a single polygon
+	255,	// Polygons reached by a single flood
+	0,	// Collision grid cell size (off)
+	0,	// Polygons a map needs for visibility sets (off)
 };
 
 // expanded defaults up to 1.0
@@ -70,6 +73,9 @@ static uint16 a1_1_0_dynamic_limits[NUMBER_OF_DYNAMIC_LIMITS] =
 	4096, // Ephemeral objects (render effects)
 	256,	// Garbage objects (corpses) across the whole map
 	10,	// Garbage objects (corpses) in a single polygon
+	255,	// Polygons reached by a single flood
+	0,	// Collision grid cell size (off)
+	0,	// Polygons a map needs for visibility sets (off)
 };
 
 // 1.1 reverts paths for classic scenario compatibility
@@ -86,6 +92,9 @@ static uint16 a1_1_1_dynamic_limits[NUMBER_OF_DYNAMIC_LIMITS] =
 	4096, // Ephemeral objects (render effects)
 	256,	// Garbage objects (corpses) across the whole map
 	10,	// Garbage objects (corpses) in a single polygon
+	255,	// Polygons reached by a single flood
+	0,	// Collision grid cell size (off)
+	0,	// Polygons a map needs for visibility sets (off)
 };
 
 static std::vector<uint16> dynamic_limits(NUMBER_OF_DYNAMIC_LIMITS);
@@ -149,6 +158,9 @@ void parse_mml_dynamic_limits(const InfoTree& root)
 	parse_limit_value(root, "ephemera", _dynamic_limit_ephemera);
 	parse_limit_value(root, "garbage", _dynamic_limit_garbage);
 	parse_limit_value(root, "garbage_per_polygon", _dynamic_limit_garbage_per_polygon);
+	parse_limit_value(root, "flood_nodes", _dynamic_limit_flood_nodes);
+	parse_limit_value(root, "collision_grid", _dynamic_limit_collision_grid);
+	parse_limit_value(root, "visibility_sets", _dynamic_limit_visibility_sets);
 
 	reallocate_dynamic_limits();
 }
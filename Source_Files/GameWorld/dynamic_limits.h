@@ -47,6 +47,9 @@ enum {
 	_dynamic_limit_ephemera,			// [1024] Ephemeral objects (render effects)
 	_dynamic_limit_garbage,				// Garbage objects (corpses) across the whole map
 	_dynamic_limit_garbage_per_polygon, // Garbage objects (corpses) within a single polygon
+	_dynamic_limit_flood_nodes,			// [255] Polygons a single flood (pathfinding, activation, etc.) may reach
+	_dynamic_limit_collision_grid,		// [0] Cell size of the object collision grid, in world units/1024 (0 disables it)
+	_dynamic_limit_visibility_sets,		// [0] Fewest polygons a map needs for potentially-visible sets to be built (0 disables them)
 	NUMBER_OF_DYNAMIC_LIMITS
 };
 
@@ -39,6 +39,7 @@ Aug 30, 2000 (Loren Petrich):
 #include "map.h"
 #include "interface.h"
 #include "effects.h"
+#include "world_snapshot.h"
 #include "SoundManager.h"
 #include "lua_script.h"
 
@@ -127,6 +128,7 @@ short new_effect(
 						effect->data= NONE;
 						effect->delay= definition->delay ? global_random()%definition->delay : 0;
 						MARK_SLOT_AS_USED(effect);
+						world_changed(effect);
 						
 						SET_OBJECT_OWNER(object, _object_is_effect);
 						object->permutation = effect_index;
@@ -42,14 +42,18 @@ on very small maps, choose_random_flood_node() may not terminate
 #include "cseries.h"
 #include "map.h"
 #include "flood_map.h"
+#include "polygon_adjacency.h"
+#include "dynamic_limits.h"
 
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <vector>
 
 /* ---------- constants */
 
-#define MAXIMUM_FLOOD_NODES 255
+// settable with MML; node indexes are shorts
+#define MAXIMUM_FLOOD_NODES (MIN(get_dynamic_limit(_dynamic_limit_flood_nodes), SHRT_MAX))
 #define UNVISITED NONE
 
 /* ---------- structures */
@@ -74,6 +78,14 @@ struct node_data /* 16 bytes */
 	int32 user_flags;
 };
 
+/* a polygon has been visited by the current flood only if its generation matches
+	flood_generation; this saves clearing the whole array every time a flood starts */
+struct visited_polygon_data
+{
+	uint32 generation;
+	int16 node_index;
+};
+
 }
 }
 
@@ -81,24 +93,31 @@ using namespace alephone::flood_map;
 
 /* ---------- globals */
 
-static short node_count= 0, last_node_index_expanded= NONE;
-static struct node_data *nodes = NULL;
-static short *visited_polygons = NULL;
+static short node_count= 0, maximum_node_count= 0, last_node_index_expanded= NONE;
+static std::vector<node_data> nodes;
+static std::vector<visited_polygon_data> visited_polygons;
+static uint32 flood_generation= 0;
 
 /* ---------- private prototypes */
 
 static void add_node(short parent_node_index, short polygon_index, short depth, int32 cost, int32 user_flags);
 
+static short get_visited_node_index(short polygon_index);
+static void set_visited_node_index(short polygon_index, short node_index);
+
 /* ---------- code */
 
 void allocate_flood_map_memory(
 	void)
 {
 	// Made reentrant because this must be called every time a map is loaded
-	if (nodes) delete []nodes;
-	nodes= new node_data[MAXIMUM_FLOOD_NODES];
-	if (visited_polygons) delete []visited_polygons;
-	visited_polygons= new short[MAXIMUM_POLYGONS_PER_MAP];
+	nodes.clear();
+	nodes.reserve(MAXIMUM_FLOOD_NODES);
+	
+	visited_polygons.assign(MAXIMUM_POLYGONS_PER_MAP, visited_polygon_data{0, UNVISITED});
+	flood_generation= 0;
+	node_count= 0;
+	last_node_index_expanded= NONE;
 }
 
 /* returns next polygon index or NONE if there are no more polygons left cheaper than maximum_cost */
@@ -117,10 +136,18 @@ short flood_map(
 	/* initialize ourselves if first_polygon_index!=NONE */
 	if (first_polygon_index!=NONE)
 	{
-		/* clear the visited polygon array */
-		objlist_set(visited_polygons, NONE, MAXIMUM_POLYGONS_PER_MAP);
+		/* invalidate the visited polygon array by starting a new generation; only clear
+			it outright on the (very) rare occasions the generation counter wraps */
+		if (++flood_generation==0)
+		{
+			for (auto& visited : visited_polygons) visited.generation= 0;
+			flood_generation= 1;
+		}
+		
+		nodes.clear();
 		
 		node_count= 0;
+		maximum_node_count= MAXIMUM_FLOOD_NODES;
 		last_node_index_expanded= NONE;
 		add_node(NONE, first_polygon_index, 0, 0, (flood_mode==_flagged_breadth_first) ? *((int32*)caller_data) : 0);
 	}
@@ -130,7 +157,7 @@ short flood_map(
 		case _best_first:
 			/* find the unexpanded node with the lowest cost */
 			lowest_cost= maximum_cost, lowest_cost_node_index= NONE;
-			for (node= nodes, node_index= 0; node_index<node_count; ++node_index, ++node)
+			for (node= nodes.data(), node_index= 0; node_index<node_count; ++node_index, ++node)
 			{
 				if (NODE_IS_UNEXPANDED(node)&&node->cost<lowest_cost)
 				{
@@ -144,7 +171,7 @@ short flood_map(
 		case _flagged_breadth_first:
 			/* find the next unexpanded node in the list under maximum_cost */
 			node_index= (last_node_index_expanded==NONE) ? 0 : (last_node_index_expanded+1);
-			for (node= nodes+node_index; node_index<node_count; ++node_index, ++node)
+			for (node= nodes.data()+node_index; node_index<node_count; ++node_index, ++node)
 			{
 				if (node->cost<maximum_cost) break;
 			}
@@ -174,14 +201,14 @@ short flood_map(
 	if (lowest_cost_node_index!=NONE)
 	{
 		struct polygon_data *polygon;
-		short i;
+		int32 edge_index, last_edge_index;
 		
 		/* for flood_depth() and reverse_flood_map(), remember which node we successfully expanded last */
 		last_node_index_expanded= lowest_cost_node_index;
 
 		/* get pointer to lowest cost node */
 		assert(lowest_cost_node_index>=0&&lowest_cost_node_index<node_count);
-		node= nodes+lowest_cost_node_index;
+		node= &nodes[lowest_cost_node_index];
 
 		polygon= get_polygon_data(node->polygon_index);
 		assert(!POLYGON_IS_DETACHED(polygon));
@@ -189,21 +216,24 @@ short flood_map(
 		/* mark node as expanded */
 		MARK_NODE_AS_EXPANDED(node);
 
-		for (i= 0; i<polygon->vertex_count; ++i)		
+		last_edge_index= get_polygon_last_edge(node->polygon_index);
+		for (edge_index= get_polygon_first_edge(node->polygon_index); edge_index<last_edge_index; ++edge_index)
 		{
-			short destination_polygon_index= polygon->adjacent_polygon_indexes[i];
+			short destination_polygon_index= polygon_adjacency.edge_neighbors[edge_index];
 			
 			if (destination_polygon_index!=NONE &&
-				(maximum_cost!=INT32_MAX || visited_polygons[destination_polygon_index]==UNVISITED))
+				(maximum_cost!=INT32_MAX || get_visited_node_index(destination_polygon_index)==UNVISITED))
 			{
-				int32 new_user_flags= node->user_flags;
-				int32 cost= cost_proc ? cost_proc(node->polygon_index, polygon->line_indexes[i], destination_polygon_index, (flood_mode==_flagged_breadth_first) ? &new_user_flags : caller_data) : polygon->area;
+				int32 new_user_flags= nodes[lowest_cost_node_index].user_flags;
+				int32 cost= cost_proc ? cost_proc(nodes[lowest_cost_node_index].polygon_index, polygon_adjacency.edge_lines[edge_index], destination_polygon_index, (flood_mode==_flagged_breadth_first) ? &new_user_flags : caller_data) : polygon->area;
 				
-				/* polygons with zero or negative costs are not added to the node list */
-				if (cost>0) add_node(lowest_cost_node_index, destination_polygon_index, node->depth+1, lowest_cost+cost, new_user_flags);
+				/* polygons with zero or negative costs are not added to the node list;
+					add_node() may reallocate, so don't hold on to node across it */
+				if (cost>0) add_node(lowest_cost_node_index, destination_polygon_index, nodes[lowest_cost_node_index].depth+1, lowest_cost+cost, new_user_flags);
 			}
 		}
 		
+		node= &nodes[lowest_cost_node_index];
 		polygon_index= node->polygon_index;
 		if (flood_mode==_flagged_breadth_first) *((int32*)caller_data)= node->user_flags;
 	}
@@ -229,7 +259,7 @@ short reverse_flood_map(
 		struct node_data *node;
 		
 		assert(last_node_index_expanded>=0&&last_node_index_expanded<node_count);
-		node= nodes+last_node_index_expanded;
+		node= &nodes[last_node_index_expanded];
 
 		last_node_index_expanded= node->parent_node_index;
 		polygon_index= node->polygon_index;
@@ -270,7 +300,7 @@ void choose_random_flood_node(
 			{
 				last_node_index_expanded= global_random()%node_count;
 			}
-			while (NODE_IS_UNEXPANDED(nodes+last_node_index_expanded));
+			while (NODE_IS_UNEXPANDED(&nodes[last_node_index_expanded]));
 
 			/* if we have no bias, this node is automatically suitable if it has been expanded;
 				if we have a bias, this node is only suitable if it is in the same general
@@ -278,7 +308,7 @@ void choose_random_flood_node(
 			suitable= true;
 			if (bias && (retries-= 1)>=0)
 			{
-				struct node_data *node= nodes+last_node_index_expanded;
+				struct node_data *node= &nodes[last_node_index_expanded];
 				world_point2d destination;
 				
 				find_center_of_polygon(node->polygon_index, &destination);
@@ -299,14 +329,14 @@ static void add_node(
 	int32 cost,
 	int32 user_flags)
 {
-	if (node_count<MAXIMUM_FLOOD_NODES)
+	if (node_count<maximum_node_count)
 	{
 		struct node_data *node;
 		short node_index;
 		
 		/* see if this polygon already exists in the node list anywhere */
 		assert(polygon_index>=0&&polygon_index<dynamic_world->polygon_count);
-		if ((node_index= visited_polygons[polygon_index])!=UNVISITED)
+		if ((node_index= get_visited_node_index(polygon_index))!=UNVISITED)
 		{
 			/* there is already a node referencing this polygon; if it has a higher cost
 				than the cost we are attempting to add, replace it (because we are doing
@@ -314,22 +344,19 @@ static void add_node(
 				expanded node, and in fact if we find a path to a node we have already
 				expanded we’re backtracking and can ignore the node) */
 			assert(node_index>=0&&node_index<node_count);
-			node= nodes+node_index;
+			node= &nodes[node_index];
 			if (NODE_IS_EXPANDED(node)||node->cost<=cost) node= (struct node_data *) NULL;
 		}
 		else
 		{
 			node_index= node_count;
-			node= nodes + node_index;
+			nodes.emplace_back();
+			node_count+= 1;
+			node= &nodes[node_index];
 		}
 		
 		if (node)
 		{
-			if (node_index==node_count)
-			{
-				node_count+= 1;
-			}
-			
 			node->flags= 0;
 			node->parent_node_index= parent_node_index;
 			node->polygon_index= polygon_index;
@@ -338,9 +365,27 @@ static void add_node(
 			node->user_flags= user_flags;
 			
 			assert(polygon_index>=0&&polygon_index<dynamic_world->polygon_count);
-			visited_polygons[polygon_index]= node_index;
+			set_visited_node_index(polygon_index, node_index);
 			
 //			dprintf("added polygon #%d to node #%d (nodes=%p,visited=%p)", polygon_index, node_index, nodes, visited_polygons);
 		}
 	}
 }
+
+static short get_visited_node_index(
+	short polygon_index)
+{
+	const visited_polygon_data& visited= visited_polygons[polygon_index];
+	
+	return visited.generation==flood_generation ? visited.node_index : UNVISITED;
+}
+
+static void set_visited_node_index(
+	short polygon_index,
+	short node_index)
+{
+	visited_polygon_data& visited= visited_polygons[polygon_index];
+	
+	visited.generation= flood_generation;
+	visited.node_index= node_index;
+}
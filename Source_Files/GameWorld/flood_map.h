@@ -51,6 +51,10 @@ short new_path(world_point2d *source_point, short source_polygon_index,
 bool move_along_path(short path_index, world_point2d *p);
 void delete_path(short path_index);
 
+/* raw access for world snapshots */
+void *get_path_array(void);
+size_t calculate_path_array_length(void);
+
 /* ---------- prototypes/FLOOD_MAP.C */
 
 void allocate_flood_map_memory(void);
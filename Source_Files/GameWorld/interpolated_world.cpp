@@ -22,10 +22,12 @@ INTERPOLATED_WORLD.CPP
 
 #include "interpolated_world.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <vector>
 
+#include "collision_grid.h"
 #include "dynamic_limits.h"
 #include "ephemera.h"
 #include "map.h"
@@ -121,9 +123,164 @@ struct ContrailInfo {
 // contrails don't move; store the location of the projectile from the previous
 // tick and use that for interpolation
 static std::vector<ContrailInfo> contrail_tracking;
+static std::vector<int16_t> tracked_contrails;
+
+// Most of the map stands still from one tick to the next, so only what the
+// simulation reports changed (see interpolated_world_object_changed() and
+// interpolated_world_polygon_changed()) is captured each tick. Whatever turns
+// out to differ from the previous tick goes on a moving list, and those lists
+// are all update_interpolated_world() has to interpolate and
+// exit_interpolated_world() has to put back.
+static std::vector<uint8_t> dirty_object_marks;
+static std::vector<int16_t> dirty_objects;
+static std::vector<uint8_t> dirty_polygon_marks;
+static std::vector<int16_t> dirty_polygons;
+
+static std::vector<int16_t> moving_objects;
+static std::vector<int16_t> moving_polygons;
+static std::vector<int16_t> moving_sides;
+static std::vector<int16_t> moving_lines;
+
+// sides and lines are captured through each polygon they border; stamp them
+// so each is only captured once per tick
+static std::vector<uint32_t> side_capture_stamps;
+static std::vector<uint32_t> line_capture_stamps;
+static uint32_t capture_stamp;
+
+static void capture_object(int16_t object_index)
+{
+	auto& tick_object = current_tick_objects[object_index];
+	auto object = &objects[object_index];
+
+	tick_object.location = object->location;
+	tick_object.polygon = object->polygon;
+	tick_object.flags = object->flags;
+	tick_object.next_object = object->next_object;
+}
+
+static void restore_object(int16_t object_index)
+{
+	auto& tick_object = current_tick_objects[object_index];
+	auto& object = objects[object_index];
+
+	object.location = tick_object.location;
+	object.polygon = tick_object.polygon;
+	object.next_object = tick_object.next_object;
+
+	// interpolation files objects by their in-between positions
+	move_object_in_collision_grid(object_index);
+}
+
+static void capture_side(int16_t side_index)
+{
+	if (side_index == NONE || side_capture_stamps[side_index] == capture_stamp)
+	{
+		return;
+	}
+
+	side_capture_stamps[side_index] = capture_stamp;
+	previous_tick_sides[side_index] = current_tick_sides[side_index];
+	current_tick_sides[side_index].y0 = map_sides[side_index].primary_texture.y0;
+
+	if (previous_tick_sides[side_index].y0 != current_tick_sides[side_index].y0)
+	{
+		moving_sides.push_back(side_index);
+	}
+}
+
+static void capture_line(int16_t line_index)
+{
+	if (line_capture_stamps[line_index] == capture_stamp)
+	{
+		return;
+	}
+
+	line_capture_stamps[line_index] = capture_stamp;
+	auto& prev = previous_tick_lines[line_index];
+	auto& next = current_tick_lines[line_index];
+	auto line = get_line_data(line_index);
+
+	prev = next;
+	next.highest_adjacent_floor = line->highest_adjacent_floor;
+	next.lowest_adjacent_ceiling = line->lowest_adjacent_ceiling;
+
+	if (prev.highest_adjacent_floor != next.highest_adjacent_floor ||
+		prev.lowest_adjacent_ceiling != next.lowest_adjacent_ceiling)
+	{
+		moving_lines.push_back(line_index);
+	}
+}
+
+static void capture_polygon(int16_t polygon_index)
+{
+	auto& prev = previous_tick_polygons[polygon_index];
+	auto& next = current_tick_polygons[polygon_index];
+	auto& polygon = map_polygons[polygon_index];
+
+	prev = next;
+	next.floor_height = polygon.floor_height;
+	next.ceiling_height = polygon.ceiling_height;
+	next.first_object = polygon.first_object;
+
+	if (prev.floor_height != next.floor_height ||
+		prev.ceiling_height != next.ceiling_height)
+	{
+		moving_polygons.push_back(polygon_index);
+	}
+
+	// keep the object list whole for exit_interpolated_world()
+	for (auto object_index = polygon.first_object; object_index != NONE; object_index = objects[object_index].next_object)
+	{
+		current_tick_objects[object_index].next_object = objects[object_index].next_object;
+	}
+
+	// a platform moves the textures on both sides of its lines
+	for (auto i = 0; i < polygon.vertex_count; ++i)
+	{
+		auto line_index = polygon.line_indexes[i];
+		auto line = get_line_data(line_index);
+
+		capture_line(line_index);
+		capture_side(line->clockwise_polygon_side_index);
+		capture_side(line->counterclockwise_polygon_side_index);
+	}
+}
+
+void interpolated_world_object_changed(int16_t object_index)
+{
+	if (object_index >= 0 &&
+		object_index < static_cast<int>(dirty_object_marks.size()) &&
+		!dirty_object_marks[object_index])
+	{
+		dirty_object_marks[object_index] = true;
+		dirty_objects.push_back(object_index);
+	}
+}
+
+void interpolated_world_polygon_changed(int16_t polygon_index)
+{
+	if (polygon_index >= 0 &&
+		polygon_index < static_cast<int>(dirty_polygon_marks.size()) &&
+		!dirty_polygon_marks[polygon_index])
+	{
+		dirty_polygon_marks[polygon_index] = true;
+		dirty_polygons.push_back(polygon_index);
+	}
+}
 
 void init_interpolated_world()
 {
+	dirty_object_marks.clear();
+	dirty_objects.clear();
+	dirty_polygon_marks.clear();
+	dirty_polygons.clear();
+
+	moving_objects.clear();
+	moving_polygons.clear();
+	moving_sides.clear();
+	moving_lines.clear();
+	tracked_contrails.clear();
+
 	if (get_fps_target() == 30)
 	{
 		world_is_interpolated = false;
@@ -133,13 +290,7 @@ void init_interpolated_world()
 	current_tick_objects.resize(MAXIMUM_OBJECTS_PER_MAP);
 	for (auto i = 0; i < MAXIMUM_OBJECTS_PER_MAP; ++i)
 	{
-		auto& tick_object = current_tick_objects[i];
-		auto object = &objects[i];
-
-		tick_object.location = object->location;
-		tick_object.polygon = object->polygon;
-		tick_object.flags = object->flags;
-		tick_object.next_object = object->next_object;
+		capture_object(i);
 	}
 	previous_tick_objects.assign(current_tick_objects.begin(),
 								 current_tick_objects.end());
@@ -177,6 +328,12 @@ void init_interpolated_world()
 	previous_tick_lines.assign(current_tick_lines.begin(),
 							   current_tick_lines.end());
 
+	dirty_object_marks.assign(MAXIMUM_OBJECTS_PER_MAP, false);
+	dirty_polygon_marks.assign(dynamic_world->polygon_count, false);
+	side_capture_stamps.assign(MAXIMUM_SIDES_PER_MAP, 0);
+	line_capture_stamps.assign(MAXIMUM_LINES_PER_MAP, 0);
+	capture_stamp = 0;
+
 	current_tick_ephemera.resize(get_dynamic_limit(_dynamic_limit_ephemera));
 	for (auto i = 0; i < get_dynamic_limit(_dynamic_limit_ephemera); ++i)
 	{
@@ -220,49 +377,75 @@ void init_interpolated_world()
 }
 
 extern void update_world_view_camera();
+extern bool replay_is_fast_forwarding();
 
 void enter_interpolated_world()
 {
-	if (get_fps_target() == 30)
+	// nothing is drawn while fast-forwarding
+	if (get_fps_target() == 30 || replay_is_fast_forwarding())
 	{
 		return;
 	}
 	
 	start_machine_tick = machine_tick_count();
-	
-	previous_tick_objects.assign(current_tick_objects.begin(),
-								 current_tick_objects.end());
-	
-	for (auto i = 0; i < MAXIMUM_OBJECTS_PER_MAP; ++i)
+
+	if (++capture_stamp == 0)
 	{
-		auto& tick_object = current_tick_objects[i];
-		auto object = &objects[i];
-		
-		tick_object.location = object->location;
-		tick_object.polygon = object->polygon;
-		tick_object.flags = object->flags;
-		tick_object.next_object = object->next_object;
+		std::fill(side_capture_stamps.begin(), side_capture_stamps.end(), 0);
+		std::fill(line_capture_stamps.begin(), line_capture_stamps.end(), 0);
+		capture_stamp = 1;
+	}
 
-		if (!SLOT_IS_USED(object))
-		{
-			contrail_tracking[i].projectile_index = NONE;
-		}
+	// whatever moved last tick and hasn't changed since has come to rest
+	for (auto i : moving_objects)
+	{
+		previous_tick_objects[i] = current_tick_objects[i];
 	}
+	moving_objects.clear();
 
-	previous_tick_polygons.assign(current_tick_polygons.begin(),
-								  current_tick_polygons.end());
+	for (auto i : moving_polygons)
+	{
+		previous_tick_polygons[i] = current_tick_polygons[i];
+	}
+	moving_polygons.clear();
 
-	for (auto i = 0; i < dynamic_world->polygon_count; ++i)
+	for (auto i : moving_sides)
 	{
-		auto& tick_polygon = current_tick_polygons[i];
-		auto& polygon = map_polygons[i];
+		previous_tick_sides[i] = current_tick_sides[i];
+	}
+	moving_sides.clear();
 
-		tick_polygon.floor_height = polygon.floor_height;
-		tick_polygon.ceiling_height = polygon.ceiling_height;
-		tick_polygon.first_object = polygon.first_object;
+	for (auto i : moving_lines)
+	{
+		previous_tick_lines[i] = current_tick_lines[i];
+	}
+	moving_lines.clear();
 
-		current_tick_polygon_ephemera[i] = polygon_ephemera[i];
+	for (auto i : dirty_objects)
+	{
+		dirty_object_marks[i] = false;
+
+		auto prev = &previous_tick_objects[i];
+		auto next = &current_tick_objects[i];
+
+		*prev = *next;
+		capture_object(i);
+
+		if (!SLOT_IS_USED(next))
+		{
+			contrail_tracking[i].projectile_index = NONE;
+		}
+
+		if (prev->flags != next->flags ||
+			prev->polygon != next->polygon ||
+			prev->location.x != next->location.x ||
+			prev->location.y != next->location.y ||
+			prev->location.z != next->location.z)
+		{
+			moving_objects.push_back(i);
+		}
 	}
+	dirty_objects.clear();
 
 	// Lua scripts can add sides
 	if (current_tick_sides.size() != MAXIMUM_SIDES_PER_MAP) {
@@ -271,26 +454,21 @@ void enter_interpolated_world()
 			 ++i)
 		{
 			current_tick_sides.push_back({map_sides[i].primary_texture.y0});
+			previous_tick_sides.push_back(current_tick_sides.back());
 		}
+		side_capture_stamps.resize(MAXIMUM_SIDES_PER_MAP, 0);
 	}
-	
-	previous_tick_sides.assign(current_tick_sides.begin(),
-							   current_tick_sides.end());
-	
-	for (auto i = 0; i < MAXIMUM_SIDES_PER_MAP; ++i)
+
+	for (auto i : dirty_polygons)
 	{
-		current_tick_sides[i].y0 = map_sides[i].primary_texture.y0;
+		dirty_polygon_marks[i] = false;
+		capture_polygon(i);
 	}
-	
-	previous_tick_lines.assign(current_tick_lines.begin(),
-							   current_tick_lines.end());
-	for (auto i = 0; i < MAXIMUM_LINES_PER_MAP; ++i)
-	{
-		auto& tick_line = current_tick_lines[i];
-		auto line = get_line_data(i);
+	dirty_polygons.clear();
 
-		tick_line.highest_adjacent_floor = line->highest_adjacent_floor;
-		tick_line.lowest_adjacent_ceiling = line->lowest_adjacent_ceiling;
+	for (auto i = 0; i < dynamic_world->polygon_count; ++i)
+	{
+		current_tick_polygon_ephemera[i] = polygon_ephemera[i];
 	}
 
 	previous_tick_ephemera.assign(current_tick_ephemera.begin(),
@@ -333,15 +511,28 @@ void enter_interpolated_world()
 		current_tick_weapon_display.push_back(data);
 	}
 
-	for (auto i = 0; i < contrail_tracking.size(); ++i)
+	// the contrail's previous tick is made up, so it moves for as long as it's
+	// tracked
+	auto tracked = tracked_contrails.begin();
+	for (auto i : tracked_contrails)
 	{
-		if (contrail_tracking[i].projectile_index != NONE)
+		if (contrail_tracking[i].projectile_index == NONE)
+		{
+			continue;
+		}
+
+		*tracked++ = i;
+
+		MARK_SLOT_AS_USED(&previous_tick_objects[i]);
+		previous_tick_objects[i].polygon = contrail_tracking[i].polygon;
+		previous_tick_objects[i].location = contrail_tracking[i].location;
+
+		if (std::find(moving_objects.begin(), moving_objects.end(), i) == moving_objects.end())
 		{
-			MARK_SLOT_AS_USED(&previous_tick_objects[i]);
-			previous_tick_objects[i].polygon = contrail_tracking[i].polygon;
-			previous_tick_objects[i].location = contrail_tracking[i].location;
+			moving_objects.push_back(i);
 		}
 	}
+	tracked_contrails.erase(tracked, tracked_contrails.end());
 
 	world_is_interpolated = true;
 }
@@ -353,35 +544,49 @@ void exit_interpolated_world()
 		return;
 	}
 
-	for (auto i = 0; i < MAXIMUM_OBJECTS_PER_MAP; ++i)
+	// interpolation only touches what's moving, but relinking an object marks
+	// it and the polygons it passed through dirty; put those back, too
+	for (auto i : moving_objects)
 	{
-		auto& tick_object = current_tick_objects[i];
-		auto& object = objects[i];
+		restore_object(i);
+	}
 
-		object.location = tick_object.location;
-		object.polygon = tick_object.polygon;
-		object.flags = tick_object.flags;
-		object.next_object = tick_object.next_object;
+	for (auto i : dirty_objects)
+	{
+		restore_object(i);
 	}
 
-	for (auto i = 0; i < dynamic_world->polygon_count; ++i)
+	for (auto i : moving_polygons)
 	{
 		auto& tick_polygon = current_tick_polygons[i];
 		auto& polygon = map_polygons[i];
 
 		polygon.floor_height = tick_polygon.floor_height;
 		polygon.ceiling_height = tick_polygon.ceiling_height;
-		polygon.first_object = tick_polygon.first_object;
+	}
 
+	for (auto i : dirty_polygons)
+	{
+		auto& polygon = map_polygons[i];
+
+		polygon.first_object = current_tick_polygons[i].first_object;
+		for (auto object_index = polygon.first_object; object_index != NONE; object_index = current_tick_objects[object_index].next_object)
+		{
+			objects[object_index].next_object = current_tick_objects[object_index].next_object;
+		}
+	}
+
+	for (auto i = 0; i < dynamic_world->polygon_count; ++i)
+	{
 		polygon_ephemera[i] = current_tick_polygon_ephemera[i];
 	}
 
-	for (auto i = 0; i < MAXIMUM_SIDES_PER_MAP; ++i)
+	for (auto i : moving_sides)
 	{
 		map_sides[i].primary_texture.y0 = current_tick_sides[i].y0;
 	}
 
-	for (auto i = 0; i < MAXIMUM_LINES_PER_MAP; ++i)
+	for (auto i : moving_lines)
 	{
 		auto& tick_line = current_tick_lines[i];
 		auto line = get_line_data(i);
@@ -490,7 +695,7 @@ void update_interpolated_world(float heartbeat_fraction)
 		return;
 	}
 
-	for (auto i = 0; i < dynamic_world->polygon_count; ++i)
+	for (auto i : moving_polygons)
 	{
 		if (!TEST_RENDER_FLAG(i, _polygon_is_visible))
 		{
@@ -514,23 +719,24 @@ void update_interpolated_world(float heartbeat_fraction)
 										  next.ceiling_height,
 										  heartbeat_fraction);
 		}
+	}
 
-		for (auto j = 0; j < polygon.vertex_count; ++j)
+	for (auto i : moving_sides)
+	{
+		auto polygon_index = map_sides[i].polygon_index;
+		if (polygon_index == NONE ||
+			!TEST_RENDER_FLAG(polygon_index, _polygon_is_visible))
 		{
-			auto side_index = polygon.side_indexes[j];
-			if (side_index != NONE &&
-				current_tick_sides[side_index].y0 !=
-				previous_tick_sides[side_index].y0)
-			{
-				map_sides[side_index].primary_texture.y0 = lerp(
-					previous_tick_sides[side_index].y0,
-					current_tick_sides[side_index].y0,
-					heartbeat_fraction);
-			}
+			continue;
 		}
+
+		map_sides[i].primary_texture.y0 = lerp(
+			previous_tick_sides[i].y0,
+			current_tick_sides[i].y0,
+			heartbeat_fraction);
 	}
 
-	for (auto i = 0; i < MAXIMUM_LINES_PER_MAP; ++i)
+	for (auto i : moving_lines)
 	{
 		auto line = get_line_data(i);
 		if ((line->clockwise_polygon_owner == NONE ||
@@ -562,7 +768,7 @@ void update_interpolated_world(float heartbeat_fraction)
 		}
 	}
 	
-	for (auto i = 0; i < MAXIMUM_OBJECTS_PER_MAP; ++i)
+	for (auto i : moving_objects)
 	{
 		auto prev = &previous_tick_objects[i];
 		auto next = &current_tick_objects[i];
@@ -817,6 +1023,11 @@ void track_contrail_interpolation(int16_t projectile_index, int16_t effect_index
 	{
 		auto& contrail = contrail_tracking[effect_index];
 
+		if (contrail.projectile_index == NONE)
+		{
+			tracked_contrails.push_back(effect_index);
+		}
+
 		contrail.projectile_index = projectile_index;
 		contrail.polygon = projectile->polygon;
 		contrail.location = projectile->location;
@@ -34,6 +34,11 @@ void exit_interpolated_world();
 void update_interpolated_world(float heartbeat_fraction);
 void interpolate_world_view(float heartbeat_fraction);
 
+// The simulation calls these when it moves an object, relinks it or changes a
+// polygon's heights or sides, so the next tick only captures what changed
+void interpolated_world_object_changed(int16_t object_index);
+void interpolated_world_polygon_changed(int16_t polygon_index);
+
 void track_contrail_interpolation(int16_t projectile_index, int16_t effect_index);
 bool get_interpolated_weapon_display_information(short* count, weapon_display_information* data);
 
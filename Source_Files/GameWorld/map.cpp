@@ -118,13 +118,16 @@ find_line_crossed leaving polygon could be sped up considerable by reversing the
 #include "Console.h"
 #include "InfoTree.h"
 #include "flood_map.h"
+#include "polygon_adjacency.h"
+#include "collision_grid.h"
+#include "visibility_sets.h"
+#include "interpolated_world.h"
+#include "world_snapshot.h"
 
 #include <string.h>
 #include <stdlib.h>
 #include <limits.h>
 
-#include <list>
-
 /* ---------- structures */
 
 /*
@@ -635,6 +638,7 @@ void reconnect_map_object_list(
 	struct polygon_data *polygon;
 
 	/* wipe first_object links from polygon structures */
+	world_changed(map_polygons, dynamic_world->polygon_count*sizeof(polygon_data));
 	for (polygon=map_polygons,i=0;i<dynamic_world->polygon_count;--i,++polygon)
 	{
 		polygon->first_object= NONE;
@@ -734,8 +738,11 @@ short new_map_object3d(
 		object->location= *location;
 
 		/* insert at head of linked list */
+		world_changed(polygon);
 		object->next_object= polygon->first_object;
 		polygon->first_object= object_index;
+		add_object_to_collision_grid(object_index);
+		interpolated_world_polygon_changed(polygon_index);
 	}
 	
 	return object_index;
@@ -801,6 +808,7 @@ void remove_parasitic_object(
 	struct object_data *host= get_object_data(host_index);
 	struct object_data *parasite= get_object_data(host->parasitic_object);
 
+	interpolated_world_object_changed(host->parasitic_object);
 	host->parasitic_object= NONE;
 	MARK_SLOT_AS_FREE(parasite);
 }
@@ -821,10 +829,15 @@ void remove_map_object(
 		struct object_data *parasite= get_object_data(object->parasitic_object);
 		
 		MARK_SLOT_AS_FREE(parasite);
+		interpolated_world_object_changed(object->parasitic_object);
 	}
 
 	L_Invalidate_Object(object_index);
+	world_changed(polygon);
 	*next_object= object->next_object;
+	remove_object_from_collision_grid(object_index);
+	interpolated_world_object_changed(object_index);
+	interpolated_world_polygon_changed(object->polygon);
 	MARK_SLOT_AS_FREE(object);
 }
 
@@ -847,7 +860,11 @@ remove_object_from_polygon_object_list(short object_index, short polygon_index)
 		assert(*next_object != NONE);
 	}
 
+	world_changed(polygon);
 	*next_object= object->next_object;
+	remove_object_from_collision_grid(object_index);
+	interpolated_world_object_changed(object_index);
+	interpolated_world_polygon_changed(polygon_index);
 
 	object->polygon= NONE;
 }
@@ -867,84 +884,16 @@ add_object_to_polygon_object_list(short object_index, short polygon_index)
 	struct object_data* object = get_object_data(object_index);
 	struct polygon_data* polygon= get_polygon_data(polygon_index);
 
+	world_changed(polygon);
 	object->next_object= polygon->first_object;
 	polygon->first_object= object_index;
 
 	object->polygon= polygon_index;
+	add_object_to_collision_grid(object_index);
+	interpolated_world_object_changed(object_index);
+	interpolated_world_polygon_changed(polygon_index);
 }
 
-typedef std::pair<short, short>	DeferredObjectListInsertion;
-typedef std::list<DeferredObjectListInsertion> DeferredObjectListInsertionList;
-static DeferredObjectListInsertionList sDeferredObjectListInsertions;
-
-void
-deferred_add_object_to_polygon_object_list(short object_index, short index_to_precede)
-{
-	sDeferredObjectListInsertions.push_back(DeferredObjectListInsertion(object_index, index_to_precede));
-}
-
-
-
-void
-perform_deferred_polygon_object_list_manipulations()
-{
-	// Loop while the list of insertions is non-empty (we may need to make multiple passes)
-	while(!sDeferredObjectListInsertions.empty())
-	{
-		// Pass over the list of insertions, inserting whatever we can.
-		bool something_changed = false;
-
-		for(DeferredObjectListInsertionList::iterator i = sDeferredObjectListInsertions.begin(); i != sDeferredObjectListInsertions.end(); )
-		{
-			short object_to_insert_index = (*i).first;
-			short object_index_to_precede = (*i).second;
-			object_data* object = get_object_data(object_to_insert_index);
-			polygon_data* polygon = get_polygon_data(object->polygon);
-
-			// Find object index we're supposed to predece... and insert the object before it
-			short* next_object_index_p = &(polygon->first_object);
-			bool inserted = false;
-
-			while(!inserted)
-			{
-				if(*next_object_index_p == object_index_to_precede)
-				{
-					object->next_object = *next_object_index_p;
-					*next_object_index_p = object_to_insert_index;
-					inserted = true;
-				}
-
-				if(*next_object_index_p == NONE)
-					break;
-
-				next_object_index_p = &(get_object_data(*next_object_index_p)->next_object);
-
-			} // Insert object before object it's supposed to precede
-
-			// Each branch of this if() will increment i
-			if(inserted)
-			{
-				// Most concise way to correctly remove-and-increment
-				sDeferredObjectListInsertions.erase(i++);
-				something_changed = true;
-			}
-			else
-				// Perhaps we were trying to insert before another object that's scheduled for insertion.
-				// In that case, maybe by the time we come around again, the other object will be inserted.
-				// For now, we leave the insertion pending.
-				++i;
-
-		} // Pass over the list of insertions, inserting whatever we can.
-
-		// We must make progress, otherwise my algorithm is flawed (we'd loop forever).  Progress here
-		// is performing insertions into the polygon object lists and removing the corresponding deferred
-		// insertions from the insertion list.
-		assert(something_changed);
-
-	} // Loop while the list of insertions is non-empty
-
-} // perform_deferred_polygon_object_list_manipulations
-
 
 
 /* if a new polygon index is supplied, it will be used, otherwise we’ll try to find the new
@@ -986,10 +935,13 @@ bool translate_map_object(
 		changed_polygons= true;
 	}
 	object->location= *new_location;
+	move_object_in_collision_grid(object_index);
+	interpolated_world_object_changed(object_index);
 
 	/* move (no saving throw) all parasitic objects along with their host */
 	while (object->parasitic_object!=NONE)
 	{
+		interpolated_world_object_changed(object->parasitic_object);
 		object= get_object_data(object->parasitic_object);
 		object->polygon= new_polygon_index;
 		object->location= *new_location;
@@ -1553,15 +1505,16 @@ short find_line_crossed_leaving_polygon(
 	world_point2d *p0, /* origin (not necessairly in polygon_index) */
 	world_point2d *p1) /* destination (not necessairly in polygon_index) */
 {
-	struct polygon_data *polygon= get_polygon_data(polygon_index);
+	int32 first_edge_index= get_polygon_first_edge(polygon_index);
+	int32 last_edge_index= get_polygon_last_edge(polygon_index);
 	short intersected_line_index= NONE;
-	short i;
+	int32 edge_index;
 	
-	for (i= 0; i<polygon->vertex_count; ++i)
+	for (edge_index= first_edge_index; edge_index<last_edge_index; ++edge_index)
 	{
 		/* e1 is clockwise from e0 */
-		world_point2d *e0= &get_endpoint_data(polygon->endpoint_indexes[i])->vertex;
-		world_point2d *e1= &get_endpoint_data(polygon->endpoint_indexes[i==polygon->vertex_count-1?0:i+1])->vertex;
+		const world_point2d *e0= &polygon_adjacency.edge_vertices[edge_index];
+		const world_point2d *e1= &polygon_adjacency.edge_vertices[edge_index==last_edge_index-1 ? first_edge_index : edge_index+1];
 		
 		/* if e0p1 cross e0e1 is negative, p1 is on the outside of edge e0e1 (a result of zero
 			means p1 is on the line e0e1) */
@@ -1573,7 +1526,7 @@ short find_line_crossed_leaving_polygon(
 				/* if p0e0 cross p0p1 is negative or zero, p0p1 crosses e0e1 on or to the right of e0 */
 				if ((e0->x-p0->x)*(p1->y-p0->y) - (e0->y-p0->y)*(p1->x-p0->x) >= 0)
 				{
-					intersected_line_index= polygon->line_indexes[i];
+					intersected_line_index= polygon_adjacency.edge_lines[edge_index];
 					break;
 				}
 			}
@@ -1765,6 +1718,7 @@ bool keep_line_segment_out_of_walls(
 	// Skip the whole thing if exclusion-zone indexes were not found
 	if (!indexes)
 	{
+		world_changed(polygon);
 		polygon->line_exclusion_zone_count = 0;
 		polygon->point_exclusion_zone_count = 0;
 		return clipped;
@@ -2117,7 +2071,11 @@ bool change_polygon_height(
 						break;
 					
 					default:
-						if (object->location.z==polygon->floor_height) object->location.z= new_floor_height;
+						if (object->location.z==polygon->floor_height)
+						{
+							object->location.z= new_floor_height;
+							interpolated_world_object_changed(object_index);
+						}
 						break;
 				}
 			}
@@ -2126,8 +2084,10 @@ bool change_polygon_height(
 		}
 
 		/* slam the polygon heights, directly */
+		world_changed(polygon);
 		polygon->floor_height= new_floor_height;
 		polygon->ceiling_height= new_ceiling_height;
+		interpolated_world_polygon_changed(polygon_index);
 		
 		/* the highest_adjacent_floor, lowest_adjacent_ceiling and supporting_polygon_index fields
 			of all of this polygon’s endpoints and lines are potentially invalid now.  to assure
@@ -2211,6 +2171,12 @@ bool line_is_obstructed(
 	short polygon_index= polygon_index1;
 	bool obstructed= false;
 	short line_index;
+
+	/* don't walk between polygons that can never see (or hear) each other */
+	if (for_sounds ? !polygon_may_hear_polygon(polygon_index1, polygon_index2) : !polygon_may_see_polygon(polygon_index1, polygon_index2))
+	{
+		return true;
+	}
 	
 	do
 	{
@@ -2228,8 +2194,7 @@ bool line_is_obstructed(
 		{
 			if (last_line && polygon_index==polygon_index2) break;
 
-			const auto line_data = get_line_data(line_index);
-			if (!LINE_IS_SOLID(line_data) || (for_sounds && LINE_HAS_TRANSPARENT_SIDE(line_data)))
+			if (!adjacent_line_is_solid(line_index) || (for_sounds && adjacent_line_has_transparent_side(line_index)))
 			{
 				/* transparent line, find adjacent polygon */
 				polygon_index= find_adjacent_polygon(polygon_index, line_index);
@@ -2370,15 +2335,16 @@ short _find_line_crossed_leaving_polygon(
 	world_point2d *p1, /* destination (not necessairly in polygon_index) */
 	bool *last_line) /* set if p1 is on the line leaving the last polygon */
 {
-	struct polygon_data *polygon= get_polygon_data(polygon_index);
+	int32 first_edge_index= get_polygon_first_edge(polygon_index);
+	int32 last_edge_index= get_polygon_last_edge(polygon_index);
 	short intersected_line_index= NONE;
-	short i;
+	int32 edge_index;
 	
-	for (i= 0; i<polygon->vertex_count; ++i)
+	for (edge_index= first_edge_index; edge_index<last_edge_index; ++edge_index)
 	{
 		/* e1 is clockwise from e0 */
-		world_point2d *e0= &get_endpoint_data(polygon->endpoint_indexes[i])->vertex;
-		world_point2d *e1= &get_endpoint_data(polygon->endpoint_indexes[i==polygon->vertex_count-1?0:i+1])->vertex;
+		const world_point2d *e0= &polygon_adjacency.edge_vertices[edge_index];
+		const world_point2d *e1= &polygon_adjacency.edge_vertices[edge_index==last_edge_index-1 ? first_edge_index : edge_index+1];
 		int32 not_on_line;
 		
 		/* if e0p1 cross e0e1 is negative, p1 is on the outside of edge e0e1 (a result of zero
@@ -2391,7 +2357,7 @@ short _find_line_crossed_leaving_polygon(
 				/* if p0e0 cross p0p1 is negative or zero, p0p1 crosses e0e1 on or to the right of e0 */
 				if ((e0->x-p0->x)*(p1->y-p0->y) - (e0->y-p0->y)*(p1->x-p0->x) >= 0)
 				{
-					intersected_line_index= polygon->line_indexes[i];
+					intersected_line_index= polygon_adjacency.edge_lines[edge_index];
 					*last_line= !not_on_line;
 					break;
 				}
@@ -2428,6 +2394,8 @@ static short _new_map_object(
 			object->sound_pitch= FIXED_ONE;
 			
 			MARK_SLOT_AS_USED(object);
+			world_changed(object);
+			interpolated_world_object_changed(object_index);
 				
 			/* Objects with a shape of UNONE are invisible. */
 			if(shape==UNONE)
@@ -2659,7 +2627,10 @@ void _sound_add_ambient_sources_proc(
 				if (image)
 					add_one_ambient_sound_source((struct ambient_sound_data *)data, (world_location3d *) NULL, listener, image->sound_index, image->volume);
 				else
+				{
+					world_changed(listener_polygon);
 					listener_polygon->ambient_sound_image_index = NONE;
+				}
 			}
 
 			// if we’re over media, play that ambient sound image
@@ -2780,7 +2751,10 @@ void handle_random_sound_image(
 		}
 		}
 		else
+		{
+			world_changed(polygon);
 			polygon->random_sound_image_index = NONE;
+		}
 	}
 }
 
@@ -1146,16 +1146,6 @@ void remove_map_object(short index);
 extern void remove_object_from_polygon_object_list(short object_index);
 extern void remove_object_from_polygon_object_list(short object_index, short polygon_index);
 
-// schedules object at object_index for later insertion into a polygon object list.  it'll be inserted
-// before the object with index index_to_precede (which had better be in the list or be scheduled for insertion
-// by the time perform_deferred_polygon_object_list_manipulations() is called, else A1 will assert).
-extern void deferred_add_object_to_polygon_object_list(short object_index, short index_to_precede);
-
-// actually does the insertions scheduled by deferred_add_object_to_polygon_object_list().  uses the polygon
-// index each scheduled object has _when this function is called_, not whatever polygon index it had when
-// deferred_add_object_to_polygon_object_list() was called!
-extern void perform_deferred_polygon_object_list_manipulations();
-
 
 
 struct shape_and_transfer_mode
@@ -53,7 +53,9 @@ const bool DoIncorrectCountVWarn = true;
 #include "editor.h"
 #include "map.h"
 #include "flood_map.h"
+#include "polygon_adjacency.h"
 #include "platforms.h"
+#include "world_snapshot.h"
 #include "Packing.h"
 
 #include <limits.h>
@@ -122,6 +124,7 @@ void recalculate_side_type(short side_index)
 {
 	side_data *side = get_side_data(side_index);
 	short opposite_index = find_adjacent_polygon(side->polygon_index, side->line_index);
+	world_changed(side);
 	polygon_data *polygon = get_polygon_data(side->polygon_index);
 	if (opposite_index != NONE)
 	{
@@ -190,6 +193,9 @@ short new_side(short polygon_index, short line_index)
 	SideList.push_back(side);
 	dynamic_world->side_count++;
 
+	world_changed(line);
+	world_changed(polygon);
+
 	if (line->clockwise_polygon_owner == polygon_index) 
 		line->clockwise_polygon_side_index = side_index;
 	else
@@ -208,6 +214,7 @@ void recalculate_redundant_polygon_data(
 {
 	struct polygon_data *polygon= get_polygon_data(polygon_index);
 
+	world_changed(polygon);
 	if (!POLYGON_IS_DETACHED(polygon))
 	{
 		calculate_clockwise_endpoints(polygon_index, polygon->endpoint_indexes);
@@ -278,6 +285,7 @@ void recalculate_redundant_endpoint_data(
 		}
 	}
 
+	world_changed(endpoint);
 	SET_ENDPOINT_SOLIDITY(endpoint, solid);
 	SET_ENDPOINT_TRANSPARENCY(endpoint, transparent);
 	SET_ENDPOINT_ELEVATION(endpoint, elevation);
@@ -299,6 +307,7 @@ void recalculate_redundant_line_data(
 	bool transparent_texture= false;
 	
 	/* recalculate line length */
+	world_changed(line);
 	line->length= distance2d(&(get_endpoint_data(line->endpoint_indexes[0])->vertex),
 		&(get_endpoint_data(line->endpoint_indexes[1])->vertex));
 
@@ -368,6 +377,7 @@ void recalculate_redundant_line_data(
 	SET_LINE_VARIABLE_ELEVATION(line, variable_elevation && !LINE_IS_SOLID(line));
 	SET_LINE_LANDSCAPE_STATUS(line, landscaped);
 	SET_LINE_HAS_TRANSPARENT_SIDE(line, transparent_texture);
+	update_line_adjacency(line_index);
 }
 
 void recalculate_redundant_side_data(
@@ -399,6 +409,7 @@ void recalculate_redundant_side_data(
 
 //	if (line_index==98) dprintf("line sides: %d,%d side_index==%d", line->clockwise_polygon_side_index, line->counterclockwise_polygon_side_index, side_index);
 	
+	world_changed(side);
 	side->exclusion_zone.e0= side->exclusion_zone.e2= *e0;
 	side->exclusion_zone.e1= side->exclusion_zone.e3= *e1;
 	push_out_line(&side->exclusion_zone.e0, &side->exclusion_zone.e1, MINIMUM_SEPARATION_FROM_WALL, line->length);
@@ -475,6 +486,7 @@ void guess_side_lightsource_indexes(
 	
 	struct line_data *line= get_line_data(side->line_index);
 	struct polygon_data *polygon= get_polygon_data(side->polygon_index);
+	world_changed(side);
     
 	short ceiling_index = polygon->ceiling_lightsource_index;
 	short floor_index = polygon->floor_lightsource_index;
@@ -80,6 +80,9 @@ Feb 8, 2003 (Woody Zenfell):
 #include "interface.h"
 #include "FilmProfile.h"
 #include "flood_map.h"
+#include "collision_grid.h"
+#include "visibility_sets.h"
+#include "world_snapshot.h"
 #include "effects.h"
 #include "monsters.h"
 #include "projectiles.h"
@@ -126,6 +129,7 @@ Feb 8, 2003 (Woody Zenfell):
 
 #include "ephemera.h"
 #include "interpolated_world.h"
+#include "tick_timings.h"
 
 #include "Plugins.h"
 #include "SoundsPatch.h"
@@ -165,7 +169,6 @@ void initialize_marathon(
 	// allocate_render_memory();
 	allocate_pathfinding_memory();
 	// allocate_flood_map_memory();
-	allocate_texture_tables();
 	initialize_weapon_manager();
 	initialize_game_window();
 	initialize_scenery();
@@ -201,38 +204,22 @@ set_prediction_wanted(bool inPrediction)
 	sPredictionWanted= inPrediction;
 }
 
-static player_data sSavedPlayerData[MAXIMUM_NUMBER_OF_PLAYERS];
-static monster_data sSavedPlayerMonsterData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static object_data sSavedPlayerParasiticObjectData[MAXIMUM_NUMBER_OF_PLAYERS];
-static short sSavedPlayerObjectNextObject[MAXIMUM_NUMBER_OF_PLAYERS];
+// Everything the simulation owns, as it was before we started predicting
+static WorldSnapshot sPredictionSnapshot;
 
 // For sanity-checking...
 static int32 sSavedTickCount;
 static uint16 sSavedRandomSeed;
 
 
-// ZZZ: If not already in predictive mode, save off partial game-state for later restoration.
+// ZZZ: If not already in predictive mode, save off game-state for later restoration.
 static void
 enter_predictive_mode()
 {
 	if(sPredictedTicks == 0)
 	{
-		for(short i = 0; i < dynamic_world->player_count; i++)
-		{
-			sSavedPlayerData[i] = *get_player_data(i);
-			if(sSavedPlayerData[i].monster_index != NONE)
-			{
-				sSavedPlayerMonsterData[i] = *get_monster_data(sSavedPlayerData[i].monster_index);
-				if(sSavedPlayerMonsterData[i].object_index != NONE)
-				{
-					sSavedPlayerObjectData[i] = *get_object_data(sSavedPlayerMonsterData[i].object_index);
-					sSavedPlayerObjectNextObject[i] = sSavedPlayerObjectData[i].next_object;
-					if(sSavedPlayerObjectData[i].parasitic_object != NONE)
-						sSavedPlayerParasiticObjectData[i] = *get_object_data(sSavedPlayerObjectData[i].parasitic_object);
-				}
-			}
-		}
+		// only the blocks that changed since we last predicted get copied
+		sPredictionSnapshot.take();
 		
 		// Sanity checking
 		sSavedTickCount = dynamic_world->tick_count;
@@ -286,62 +273,36 @@ exit_predictive_mode()
 {
 	if(sPredictedTicks > 0)
 	{
+		// Sanity checking
+		if(sSavedTickCount != dynamic_world->tick_count)
+			logWarning("saved tick count %d != dynamic_world->tick_count %d", sSavedTickCount, dynamic_world->tick_count);
+
+		if(sSavedRandomSeed != get_random_seed())
+			logWarning("saved random seed %d != get_random_seed() %d", sSavedRandomSeed, get_random_seed());
+
+		// We *don't* restore this tiny part of the game-state back because
+		// otherwise the player can't use [] to scroll the inventory panel.
+		// [] scrolling happens outside the normal input/update system, so that's
+		// enough to persuade me that not restoring this won't OOS any more often
+		// than []-scrolling did before prediction.  :)
+		int16 saved_interface_flags[MAXIMUM_NUMBER_OF_PLAYERS];
+		int16 saved_interface_decay[MAXIMUM_NUMBER_OF_PLAYERS];
 		for(short i = 0; i < dynamic_world->player_count; i++)
 		{
-			player_data* player = get_player_data(i);
-			
-			assert(player->monster_index == sSavedPlayerData[i].monster_index);
+			saved_interface_flags[i] = get_player_data(i)->interface_flags;
+			saved_interface_decay[i] = get_player_data(i)->interface_decay;
+		}
 
-			{
-				// We *don't* restore this tiny part of the game-state back because
-				// otherwise the player can't use [] to scroll the inventory panel.
-				// [] scrolling happens outside the normal input/update system, so that's
-				// enough to persuade me that not restoring this won't OOS any more often
-				// than []-scrolling did before prediction.  :)
-				int16 saved_interface_flags = player->interface_flags;
-				int16 saved_interface_decay = player->interface_decay;
-				
-				*player = sSavedPlayerData[i];
-
-				player->interface_flags = saved_interface_flags;
-				player->interface_decay = saved_interface_decay;
-			}
+		if(!sPredictionSnapshot.restore())
+			logError("couldn't restore the world after prediction");
 
-			if(sSavedPlayerData[i].monster_index != NONE)
-			{
-				assert(get_monster_data(sSavedPlayerData[i].monster_index)->object_index == sSavedPlayerMonsterData[i].object_index);
-
-				*get_monster_data(sSavedPlayerData[i].monster_index) = sSavedPlayerMonsterData[i];
-				
-				if(sSavedPlayerMonsterData[i].object_index != NONE)
-				{
-					assert(get_object_data(sSavedPlayerMonsterData[i].object_index)->parasitic_object == sSavedPlayerObjectData[i].parasitic_object);
-
-					remove_object_from_polygon_object_list(sSavedPlayerMonsterData[i].object_index);
-					
-					*get_object_data(sSavedPlayerMonsterData[i].object_index) = sSavedPlayerObjectData[i];
-
-					// We have to defer this insertion since the object lists could still have other players
-					// in their predictive locations etc. - we need to reconstruct everything exactly as it
-					// was when we entered predictive mode.
-					deferred_add_object_to_polygon_object_list(sSavedPlayerMonsterData[i].object_index, sSavedPlayerObjectNextObject[i]);
-					
-					if(sSavedPlayerObjectData[i].parasitic_object != NONE)
-						*get_object_data(sSavedPlayerObjectData[i].parasitic_object) = sSavedPlayerParasiticObjectData[i];
-				}
-			}
+		for(short i = 0; i < dynamic_world->player_count; i++)
+		{
+			get_player_data(i)->interface_flags = saved_interface_flags[i];
+			get_player_data(i)->interface_decay = saved_interface_decay[i];
 		}
-
-		perform_deferred_polygon_object_list_manipulations();
 		
 		sPredictedTicks = 0;
-
-		// Sanity checking
-		if(sSavedTickCount != dynamic_world->tick_count)
-			logWarning("saved tick count %d != dynamic_world->tick_count %d", sSavedTickCount, dynamic_world->tick_count);
-
-		if(sSavedRandomSeed != get_random_seed())
-			logWarning("saved random seed %d != get_random_seed() %d", sSavedRandomSeed, get_random_seed());
 	}
 }
 
@@ -397,6 +358,8 @@ extern void update_world_view_camera();
 static int
 update_world_elements_one_tick(bool& call_postidle)
 {
+	TickTimingSplits splits;
+
 	if (m1_solo_player_in_terminal()) 
 	{
 		update_m1_solo_player_in_terminal(GameQueue);
@@ -408,15 +371,24 @@ update_world_elements_one_tick(bool& call_postidle)
 		L_Call_Idle();
 		call_postidle = true;
 		
+		splits.mark(_tick_timing_other);
 		update_lights();
+		splits.mark(_tick_timing_lights);
 		update_medias();
+		splits.mark(_tick_timing_media);
 		update_platforms();
+		splits.mark(_tick_timing_platforms);
 		
 		update_control_panels(); // don't put after update_players
+		splits.mark(_tick_timing_other);
 		update_players(GameQueue, false);
+		splits.mark(_tick_timing_players);
 		move_projectiles();
+		splits.mark(_tick_timing_projectiles);
 		move_monsters();
+		splits.mark(_tick_timing_monsters);
 		update_effects();
+		splits.mark(_tick_timing_effects);
 		recreate_objects();
 		
 		handle_random_sound_image();
@@ -455,6 +427,13 @@ update_world_elements_one_tick(bool& call_postidle)
 
         dynamic_world->tick_count+= 1;
         dynamic_world->game_information.game_time_remaining-= 1;
+        if(record_world_hash())
+        {
+#if !defined(DISABLE_NETWORKING)
+                if(game_is_networked)
+                        NetReportWorldHash(dynamic_world->tick_count, get_world_hashes().back().second);
+#endif // !defined(DISABLE_NETWORKING)
+        }
 
         return kUpdateNormalCompletion;
 }
@@ -548,7 +527,7 @@ update_world()
 		game_timed_out();
 		theElapsedTime = 0;
 	} 
-	else if (theElapsedTime)
+	else if (theElapsedTime && !replay_is_fast_forwarding())
 	{
 		update_interface(theElapsedTime);
 		update_fades(true);
@@ -668,6 +647,12 @@ bool entering_map(bool restoring_saved)
 
 	/* and since no monsters have paths, we should make sure no paths think they have monsters */
 	reset_paths();
+
+	/* file whatever objects are already placed; the rest are filed as they're created */
+	build_collision_grid();
+
+	/* start working out (or reading back) which polygons can see which */
+	build_visibility_sets();
 	
 	/* mark our shape collections for loading and load them */
 	mark_environment_collections(static_world->environment_code, true);
@@ -688,9 +673,14 @@ bool entering_map(bool restoring_saved)
 	load_all_monster_sounds();
 	load_all_game_sounds(static_world->environment_code);
 
+	/* the sets were built while everything else loaded; finish them before the first tick,
+		so monsters see the same sets on every machine and in every replay */
+	wait_for_visibility_sets();
+
 #if !defined(DISABLE_NETWORKING)
 	/* tell the keyboard controller to start recording keyboard flags */
 	if (game_is_networked) success= NetSync(); /* make sure everybody is ready */
+	if (game_is_networked) set_world_hash_interval(NetGetWorldHashInterval());
 #endif // !defined(DISABLE_NETWORKING)
 
 	/* make sure nobody’s holding a weapon illegal in the new environment */
@@ -708,6 +698,7 @@ bool entering_map(bool restoring_saved)
 	L_Call_Init(restoring_saved);
 
 	init_interpolated_world();
+	world_replaced();
 
 #if !defined(DISABLE_NETWORKING)
 	NetSetChatCallbacks(InGameChatCallbacks::instance());
@@ -788,6 +779,7 @@ void changed_polygon(
 			/*  for must be explored flags to work across cooperative net games */
 			if(player)
 			{
+				world_changed(new_polygon);
 				new_polygon->type= _polygon_is_normal;
 			}
 			break;
@@ -100,6 +100,11 @@ Jan 12, 2003 (Loren Petrich)
 #include "interface.h"
 #include "FilmProfile.h"
 #include "flood_map.h"
+#include "polygon_adjacency.h"
+#include "collision_grid.h"
+#include "visibility_sets.h"
+#include "interpolated_world.h"
+#include "world_snapshot.h"
 #include "effects.h"
 #include "monsters.h"
 #include "projectiles.h"
@@ -419,6 +424,7 @@ short new_monster(
 					monster->sound_location= object->location;
 					monster->sound_location.z += definition->height - (definition->height >> 1);
 					MARK_SLOT_AS_USED(monster);
+					world_changed(monster);
 					
 					/* initialize the monster’s object */
 					if (definition->flags&_monster_is_invisible) object->transfer_mode= _xfer_invisibility;
@@ -925,7 +931,6 @@ static int32 monster_activation_flood_proc(
 	int32 *flags=(int32 *)data;
 	struct polygon_data *destination_polygon= get_polygon_data(destination_polygon_index);
 	struct polygon_data *source_polygon= get_polygon_data(source_polygon_index);
-	struct line_data *line= get_line_data(line_index);
 	bool obey_glue= (static_world->environment_flags&_environment_glue_m1);
 	bool limit_activation= (static_world->environment_flags&_environment_activation_ranges);
 	int32 cost= limit_activation ? source_polygon->area : 1;
@@ -969,7 +974,7 @@ static int32 monster_activation_flood_proc(
 		cost= -1;
 	}
 
-	if (!((*flags)&_pass_solid_lines) && LINE_IS_SOLID(line)) cost= -1;
+	if (!((*flags)&_pass_solid_lines) && adjacent_line_is_solid(line_index)) cost= -1;
 
 	if (cost>0 && limit_activation)
 	{
@@ -1137,6 +1142,38 @@ void deactivate_monster(
 	}
 }
 
+/* visible monsters that aren't dying or teleporting, and optionally solid scenery */
+static bool object_is_possible_intersection(
+	struct object_data *object,
+	bool include_scenery)
+{
+	bool solid_object= false;
+	
+	if (!OBJECT_IS_INVISIBLE(object))
+	{
+		switch (GET_OBJECT_OWNER(object))
+		{
+			case _object_is_monster:
+			{
+				struct monster_data *monster= get_monster_data(object->permutation);
+			
+				if (!MONSTER_IS_DYING(monster) && !MONSTER_IS_TELEPORTING(monster))
+				{
+					solid_object= true;
+				}
+				
+				break;
+			}
+			
+			case _object_is_scenery:
+				if (include_scenery && OBJECT_IS_SOLID(object)) solid_object= true;
+				break;
+		}
+	}
+	
+	return solid_object;
+}
+
 /* returns a list of object indexes of all monsters in or adjacent to the given polygon,
 	up to maximum_object_count. */
 // LP change: called with growable list
@@ -1164,45 +1201,22 @@ bool possible_intersecting_monsters(
 			while (object_index!=NONE)
 			{
 				struct object_data *object= get_object_data(object_index);
-				bool solid_object= false;
 				
-				if (!OBJECT_IS_INVISIBLE(object))
+				if (object_is_possible_intersection(object, include_scenery))
 				{
-					switch (GET_OBJECT_OWNER(object))
-					{
-						case _object_is_monster:
-						{
-							struct monster_data *monster= get_monster_data(object->permutation);
-						
-							if (!MONSTER_IS_DYING(monster) && !MONSTER_IS_TELEPORTING(monster))
-							{
-								solid_object= true;
-							}
-							
-							break;
-						}
-						
-						case _object_is_scenery:
-							if (include_scenery && OBJECT_IS_SOLID(object)) solid_object= true;
-							break;
-					}
+					found_solid_object= true;
 					
-					if (solid_object)
+					// LP change:
+					if (IntersectedObjectsPtr && IntersectedObjectsPtr->size()<maximum_object_count) /* do we have enough space to add it? */
 					{
-						found_solid_object= true;
+						unsigned j;
 						
-						// LP change:
-						if (IntersectedObjectsPtr && IntersectedObjectsPtr->size()<maximum_object_count) /* do we have enough space to add it? */
-						{
-							unsigned j;
-							
-							/* only add this object_index if it's not already in the list */
-							vector<short>& IntersectedObjects = *IntersectedObjectsPtr;
-							for (j=0; j<IntersectedObjects.size() && IntersectedObjects[j]!=object_index; ++j)
-								;
-							if (j==IntersectedObjects.size())
-								IntersectedObjects.push_back(object_index);
-						}
+						/* only add this object_index if it's not already in the list */
+						vector<short>& IntersectedObjects = *IntersectedObjectsPtr;
+						for (j=0; j<IntersectedObjects.size() && IntersectedObjects[j]!=object_index; ++j)
+							;
+						if (j==IntersectedObjects.size())
+							IntersectedObjects.push_back(object_index);
 					}
 				}
 				
@@ -1214,6 +1228,31 @@ bool possible_intersecting_monsters(
 	return found_solid_object;
 }
 
+/* the collision grid version of possible_intersecting_monsters(): appends, in object index order,
+	every possible intersection in the neighborhoods of the given polygons whose center is within
+	distance (on each axis) of the bounding box of p0,p1.  the caller must add the largest object
+	radius to distance itself; there is no cap. */
+void possible_intersecting_monsters_near(
+	vector<short> *IntersectedObjectsPtr,
+	const short *polygon_indexes,
+	size_t polygon_count,
+	world_point2d *p0,
+	world_point2d *p1,
+	world_distance distance,
+	bool include_scenery)
+{
+	static vector<short> candidates;
+
+	get_collision_grid_objects(polygon_indexes, polygon_count, p0, p1, distance, candidates);
+	for (size_t i=0;i<candidates.size();++i)
+	{
+		if (object_is_possible_intersection(get_object_data(candidates[i]), include_scenery))
+		{
+			IntersectedObjectsPtr->push_back(candidates[i]);
+		}
+	}
+}
+
 /* when a target changes polygons, all monsters locked on it must recalculate their paths.
 	target is an index into the monster list. */
 void monster_moved(
@@ -1282,7 +1321,15 @@ short legal_player_move(
 
 	get_monster_dimensions(monster_index, &radius, &height);	
 	std::vector<short> IntersectedObjects;
-	possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, object->polygon, true);
+	if (collision_grid_enabled())
+	{
+		possible_intersecting_monsters_near(&IntersectedObjects, &object->polygon, 1, (world_point2d *)new_location, (world_point2d *)new_location,
+			radius+get_collision_grid_object_radius(), true);
+	}
+	else
+	{
+		possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, object->polygon, true);
+	}
 	monster_count = IntersectedObjects.size();
 	for (size_t i=0;i<monster_count;++i)
 	{
@@ -1354,7 +1401,15 @@ short legal_monster_move(
 	get_monster_dimensions(monster_index, &radius, &height);	
 	
 	std::vector<short> IntersectedObjects;
-	possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, object->polygon, true);
+	if (collision_grid_enabled())
+	{
+		possible_intersecting_monsters_near(&IntersectedObjects, &object->polygon, 1, (world_point2d *)new_location, (world_point2d *)new_location,
+			radius+get_collision_grid_object_radius(), true);
+	}
+	else
+	{
+		possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, object->polygon, true);
+	}
 	monster_count= IntersectedObjects.size();
 	for (size_t i=0;i<monster_count;++i)
 	{
@@ -1413,6 +1468,21 @@ void get_monster_dimensions(
 	*height= definition->height;
 }
 
+world_distance get_maximum_monster_radius(
+	void)
+{
+	world_distance maximum_radius= 0;
+
+	for (short monster_type= 0; monster_type<NUMBER_OF_MONSTER_TYPES; ++monster_type)
+	{
+		struct monster_definition *definition= get_monster_definition(monster_type);
+		
+		if (definition->radius>maximum_radius) maximum_radius= definition->radius;
+	}
+	
+	return maximum_radius;
+}
+
 void damage_monsters_in_radius(
 	short primary_target_index,
 	short aggressor_index,
@@ -1430,7 +1500,15 @@ void damage_monsters_in_radius(
 	(void) (primary_target_index);
 	
 	std::vector<short> IntersectedObjects;
-	possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, epicenter_polygon_index, false);
+	if (collision_grid_enabled())
+	{
+		possible_intersecting_monsters_near(&IntersectedObjects, &epicenter_polygon_index, 1, (world_point2d *)epicenter, (world_point2d *)epicenter,
+			radius+get_collision_grid_object_radius(), false);
+	}
+	else
+	{
+		possible_intersecting_monsters(&IntersectedObjects, LOCAL_INTERSECTING_MONSTER_BUFFER_SIZE, epicenter_polygon_index, false);
+	}
 	object_count= IntersectedObjects.size();
         struct object_data *aggressor = NULL;
 	if (film_profile.infinity_tag_fix && aggressor_index != NONE)
@@ -1765,7 +1843,11 @@ void adjust_monster_for_polygon_height_change(
 	{
 		struct object_data *object= get_object_data(monster->object_index);
 		
-		if (object->location.z==polygon->floor_height) object->location.z= new_floor_height;
+		if (object->location.z==polygon->floor_height)
+		{
+			object->location.z= new_floor_height;
+			interpolated_world_object_changed(monster->object_index);
+		}
 	}
 }
 
@@ -1946,6 +2028,8 @@ static void update_monster_vertical_physics_model(
 		monster->desired_height= floor_height;
 	}
 
+	if (object->location.z!=old_height) interpolated_world_object_changed(monster->object_index);
+
 	monster->sound_location= object->location;
 	monster->sound_polygon_index= object->polygon;
 	monster->sound_location.z+= definition->height - (definition->height>>1);
@@ -2389,6 +2473,12 @@ static bool clear_line_of_sight(
 			}
 		}
 
+		/* polygons that can never see each other needn't be walked */
+		if (target_visible && !polygon_may_see_polygon(viewer_object->polygon, target_object->polygon))
+		{
+			target_visible= false;
+		}
+
 		/* make sure there are no non-transparent lines between the viewer and the target */
 		if (target_visible)
 		{
@@ -3191,7 +3281,7 @@ int32 monster_pathfinding_cost_function(
 	struct monster_definition *definition= data->definition;
 	struct polygon_data *destination_polygon= get_polygon_data(destination_polygon_index);
 	struct polygon_data *source_polygon= get_polygon_data(source_polygon_index);
-	struct line_data *line= get_line_data(line_index);
+	const struct adjacent_line_data *line= get_adjacent_line_data(line_index);
 	bool respect_polygon_heights= true;
 	struct object_data *object;
 	short object_index;
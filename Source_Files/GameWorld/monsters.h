@@ -299,8 +299,11 @@ struct monster_definition *get_monster_definition_external(const short type);
 #define GLOBAL_INTERSECTING_MONSTER_BUFFER_SIZE (get_dynamic_limit(_dynamic_limit_global_collision))
 bool possible_intersecting_monsters(vector<short> *IntersectedObjectsPtr, unsigned maximum_object_count, short polygon_index, bool include_scenery);
 #define monsters_nearby(polygon_index) possible_intersecting_monsters(0, 0, (polygon_index), false)
+void possible_intersecting_monsters_near(vector<short> *IntersectedObjectsPtr, const short *polygon_indexes, size_t polygon_count,
+	world_point2d *p0, world_point2d *p1, world_distance distance, bool include_scenery);
 
 void get_monster_dimensions(short monster_index, world_distance *radius, world_distance *height);
+world_distance get_maximum_monster_radius(void);
 
 void activate_nearby_monsters(short target_index, short caller_index, short flags, int32 max_range = -1);
 
@@ -323,6 +323,18 @@ void delete_path(
 	paths[path_index].step_count= NONE;
 }
 
+void *get_path_array(
+	void)
+{
+	return paths;
+}
+
+size_t calculate_path_array_length(
+	void)
+{
+	return MAXIMUM_PATHS*sizeof(struct path_definition);
+}
+
 /* ---------- private code */
 
 static void calculate_midpoint_of_shared_line(
@@ -67,6 +67,9 @@ Jun 30, 2002 (tiennou):
 #include "world.h"
 #include "map.h"
 #include "platforms.h"
+#include "polygon_adjacency.h"
+#include "interpolated_world.h"
+#include "world_snapshot.h"
 #include "lightsource.h"
 #include "SoundManager.h"
 #include "player.h"
@@ -150,6 +153,7 @@ short new_platform(
 		platform= platforms+platform_index;
 
 		/* remember the platform_index in the polygon’s .permutation field */
+		world_changed(polygon);
 		polygon->permutation= platform_index;
 		polygon->type= _polygon_is_platform;
 		
@@ -213,6 +217,7 @@ short new_platform(
 		
 		polygon->floor_height= platform->floor_height;
 		polygon->ceiling_height= platform->ceiling_height;
+		interpolated_world_polygon_changed(polygon_index);
 		adjust_platform_endpoint_and_line_heights(platform_index);
 		adjust_platform_for_media(platform_index, true);
 	}
@@ -849,6 +854,9 @@ void adjust_platform_endpoint_and_line_heights(
 		struct polygon_data *adjacent_polygon;
 		short j;
 		
+		world_changed(endpoint);
+		world_changed(line);
+
 		/* adjust line heights and set proper line transparency and solidity */
 		// Skip this step if line indexes were not found
 		if (polygon->adjacent_polygon_indexes[i]!=NONE && line_indexes)
@@ -877,6 +885,7 @@ void adjust_platform_endpoint_and_line_heights(
 			line->highest_adjacent_floor= polygon->floor_height;
 			line->lowest_adjacent_ceiling= polygon->ceiling_height;
 		}
+		update_line_adjacency(polygon->line_indexes[i]);
 
 		/* adjust endpoint heights */
 		// Skip this step if no polygon indexes were found
@@ -1046,6 +1055,7 @@ void adjust_platform_sides(
 			if (side_index!=NONE)
 			{
 				side= get_side_data(side_index);
+				world_changed(side);
 				switch (side->type)
 				{
 					case _full_side:
@@ -1062,6 +1072,7 @@ void adjust_platform_sides(
 		if (side_index!=NONE)
 		{
 			side = get_side_data(side_index);
+			world_changed(side);
 			switch (side->type)
 			{
 				case _split_side: /* secondary */
@@ -0,0 +1,86 @@
+/*
+POLYGON_ADJACENCY.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "polygon_adjacency.h"
+
+polygon_adjacency_data polygon_adjacency;
+
+void build_polygon_adjacency(
+	void)
+{
+	short polygon_index, line_index;
+	int32 edge_count= 0;
+
+	clear_polygon_adjacency();
+
+	polygon_adjacency.first_edge.reserve(dynamic_world->polygon_count+1);
+	for (polygon_index= 0; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+	{
+		polygon_adjacency.first_edge.push_back(edge_count);
+		edge_count+= get_polygon_data(polygon_index)->vertex_count;
+	}
+	polygon_adjacency.first_edge.push_back(edge_count);
+
+	polygon_adjacency.edge_neighbors.reserve(edge_count);
+	polygon_adjacency.edge_lines.reserve(edge_count);
+	polygon_adjacency.edge_vertices.reserve(edge_count);
+	for (polygon_index= 0; polygon_index<dynamic_world->polygon_count; ++polygon_index)
+	{
+		struct polygon_data *polygon= get_polygon_data(polygon_index);
+
+		for (short i= 0; i<polygon->vertex_count; ++i)
+		{
+			polygon_adjacency.edge_neighbors.push_back(polygon->adjacent_polygon_indexes[i]);
+			polygon_adjacency.edge_lines.push_back(polygon->line_indexes[i]);
+			polygon_adjacency.edge_vertices.push_back(get_endpoint_data(polygon->endpoint_indexes[i])->vertex);
+		}
+	}
+
+	polygon_adjacency.lines.resize(dynamic_world->line_count);
+	for (line_index= 0; line_index<dynamic_world->line_count; ++line_index)
+	{
+		update_line_adjacency(line_index);
+	}
+}
+
+void clear_polygon_adjacency(
+	void)
+{
+	polygon_adjacency.first_edge.clear();
+	polygon_adjacency.edge_neighbors.clear();
+	polygon_adjacency.edge_lines.clear();
+	polygon_adjacency.edge_vertices.clear();
+	polygon_adjacency.lines.clear();
+}
+
+void update_line_adjacency(
+	short line_index)
+{
+	if (line_index>=0 && static_cast<size_t>(line_index)<polygon_adjacency.lines.size())
+	{
+		struct line_data *line= get_line_data(line_index);
+		struct adjacent_line_data *adjacent_line= &polygon_adjacency.lines[line_index];
+
+		adjacent_line->flags= line->flags;
+		adjacent_line->highest_adjacent_floor= line->highest_adjacent_floor;
+		adjacent_line->lowest_adjacent_ceiling= line->lowest_adjacent_ceiling;
+		adjacent_line->length= line->length;
+	}
+}
@@ -0,0 +1,97 @@
+#ifndef POLYGON_ADJACENCY_H
+#define POLYGON_ADJACENCY_H
+
+/*
+POLYGON_ADJACENCY.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	A compact copy of the map's polygon graph for the simulation's traversals (floods, line of
+	sight, sound obstruction, the monster pathfinding cost function), so they don't have to touch
+	the 128-byte polygon_data and 32-byte line_data records on every hop.
+
+	Each polygon's edges are stored contiguously, in the same clockwise order as its
+	endpoint_indexes/line_indexes/adjacent_polygon_indexes; edge i of polygon p is at
+	get_polygon_first_edge(p)+i.  Line flags, heights and lengths are mirrored per line and must
+	be refreshed with update_line_adjacency() whenever they change.
+*/
+
+#include "cseries.h"
+#include "world.h"
+#include "map.h"
+
+#include <vector>
+
+/* the fields of line_data that traversals read, under the same names so the LINE_IS_ macros work */
+struct adjacent_line_data /* 8 bytes */
+{
+	uint16 flags;
+	world_distance highest_adjacent_floor, lowest_adjacent_ceiling;
+	world_distance length;
+};
+
+struct polygon_adjacency_data
+{
+	/* per polygon, plus one past the end; edges of polygon p are [first_edge[p], first_edge[p+1]) */
+	std::vector<int32> first_edge;
+
+	/* per edge */
+	std::vector<int16> edge_neighbors; /* adjacent polygon or NONE */
+	std::vector<int16> edge_lines;
+	std::vector<world_point2d> edge_vertices; /* the edge runs clockwise from this vertex to the next edge's */
+
+	/* per line */
+	std::vector<adjacent_line_data> lines;
+};
+
+extern polygon_adjacency_data polygon_adjacency;
+
+/* call once the map's geometry and redundant data are complete */
+void build_polygon_adjacency(void);
+void clear_polygon_adjacency(void);
+
+/* copy the line's flags, heights and length into the adjacency data; does nothing if it isn't built */
+void update_line_adjacency(short line_index);
+
+inline int32 get_polygon_first_edge(short polygon_index)
+{
+	assert(polygon_index>=0 && static_cast<size_t>(polygon_index)+1<polygon_adjacency.first_edge.size());
+	return polygon_adjacency.first_edge[polygon_index];
+}
+
+inline int32 get_polygon_last_edge(short polygon_index) /* one past */
+{
+	return polygon_adjacency.first_edge[polygon_index+1];
+}
+
+inline const struct adjacent_line_data *get_adjacent_line_data(short line_index)
+{
+	assert(line_index>=0 && static_cast<size_t>(line_index)<polygon_adjacency.lines.size());
+	return &polygon_adjacency.lines[line_index];
+}
+
+inline bool adjacent_line_is_solid(short line_index)
+{
+	return polygon_adjacency.lines[line_index].flags&SOLID_LINE_BIT;
+}
+
+inline bool adjacent_line_has_transparent_side(short line_index)
+{
+	return polygon_adjacency.lines[line_index].flags&LINE_HAS_TRANSPARENT_SIDE_BIT;
+}
+
+#endif
@@ -83,6 +83,8 @@ Oct 13, 2000 (Loren Petrich)
 
 #include "cseries.h"
 #include "map.h"
+#include "collision_grid.h"
+#include "world_snapshot.h"
 #include "interface.h"
 #include "effects.h"
 #include "monsters.h"
@@ -142,6 +144,7 @@ short human_projectile_override= NONE;
 
 // LP addition: growable list of intersected objects
 static vector<short> IntersectedObjects;
+static vector<short> CrossedPolygons; /* with the collision grid, the polygons whose neighborhoods we search */
 
 /* ---------- private prototypes */
 
@@ -298,6 +301,7 @@ short new_projectile(
 				projectile->distance_travelled= 0;
 				projectile->damage_scale= damage_scale;
 				MARK_SLOT_AS_USED(projectile);
+				world_changed(projectile);
 
 				SET_OBJECT_OWNER(object, _object_is_projectile);
 				object->sound_pitch= definition->sound_pitch;
@@ -796,6 +800,7 @@ uint16 translate_projectile(
 
 	contact= _hit_nothing;
 	IntersectedObjects.clear();
+	CrossedPolygons.clear();
 	old_polygon= get_polygon_data(old_polygon_index);
 	if (new_polygon_index) *new_polygon_index= old_polygon_index;
 	do
@@ -816,8 +821,15 @@ uint16 translate_projectile(
 		/* add this polygon’s monsters to our non-redundant list of possible intersections */
 		if (!(definition->flags & _passes_through_objects))
 		{
-			possible_intersecting_monsters(&IntersectedObjects, GLOBAL_INTERSECTING_MONSTER_BUFFER_SIZE, old_polygon_index, true);
-			intersected_object_count = IntersectedObjects.size();
+			if (collision_grid_enabled())
+			{
+				CrossedPolygons.push_back(old_polygon_index);
+			}
+			else
+			{
+				possible_intersecting_monsters(&IntersectedObjects, GLOBAL_INTERSECTING_MONSTER_BUFFER_SIZE, old_polygon_index, true);
+				intersected_object_count = IntersectedObjects.size();
+			}
 		}
 		
  		line_index= find_line_crossed_leaving_polygon(old_polygon_index, (world_point2d *)old_location, (world_point2d *)new_location);
@@ -971,6 +983,14 @@ uint16 translate_projectile(
 		world_distance best_radius = 0;
 		short best_intersection_object = NONE;
 		
+		/* the grid can only be asked once we know how far we got; leave room for near misses */
+		if (collision_grid_enabled())
+		{
+			possible_intersecting_monsters_near(&IntersectedObjects, CrossedPolygons.data(), CrossedPolygons.size(),
+				(world_point2d *)old_location, (world_point2d *)new_location, 4*(get_collision_grid_object_radius()+definition->radius), true);
+			intersected_object_count = IntersectedObjects.size();
+		}
+		
 		distance_traveled= distance2d((world_point2d *)old_location, (world_point2d *)new_location);
 		for (size_t i=0;i<intersected_object_count;++i)
 		{
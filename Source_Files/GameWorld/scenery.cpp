@@ -187,6 +187,21 @@ void get_scenery_dimensions(
 	*height= definition->height;
 }
 
+world_distance get_maximum_scenery_radius(
+	void)
+{
+	world_distance maximum_radius= 0;
+
+	for (short scenery_type= 0; scenery_type<NUMBER_OF_SCENERY_DEFINITIONS; ++scenery_type)
+	{
+		struct scenery_definition *definition= get_scenery_definition(scenery_type);
+		
+		if (definition && definition->radius>maximum_radius) maximum_radius= definition->radius;
+	}
+	
+	return maximum_radius;
+}
+
 void damage_scenery(
 	short object_index)
 {
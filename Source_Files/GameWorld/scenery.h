@@ -44,6 +44,7 @@ void randomize_scenery_shape(short object_index);
 void randomize_scenery_shapes(void);
 
 void get_scenery_dimensions(short scenery_type, world_distance *radius, world_distance *height);
+world_distance get_maximum_scenery_radius(void);
 void damage_scenery(short object_index);
 
 bool get_scenery_collection(short scenery_type, short &collection);
@@ -0,0 +1,97 @@
+/*
+TICK_TIMINGS.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "tick_timings.h"
+
+#include <cassert>
+
+using clock_type = std::chrono::steady_clock;
+
+static bool timings_enabled = false;
+static tick_timings_data timings;
+
+static const char* timing_names[NUMBER_OF_TICK_TIMINGS] = {
+	"lights",
+	"media",
+	"platforms",
+	"players",
+	"projectiles",
+	"monsters",
+	"effects",
+	"other"
+};
+
+static uint64_t elapsed_nanoseconds(clock_type::time_point from, clock_type::time_point to)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+void set_tick_timings_enabled(bool enabled)
+{
+	timings_enabled = enabled;
+}
+
+bool tick_timings_enabled()
+{
+	return timings_enabled;
+}
+
+void reset_tick_timings()
+{
+	timings = tick_timings_data{};
+}
+
+const tick_timings_data& get_tick_timings()
+{
+	return timings;
+}
+
+const char* get_tick_timing_name(int16_t which)
+{
+	assert(which >= 0 && which < NUMBER_OF_TICK_TIMINGS);
+	return timing_names[which];
+}
+
+TickTimingSplits::TickTimingSplits() :
+	enabled_{timings_enabled}
+{
+	if (enabled_)
+	{
+		start_ = last_ = clock_type::now();
+	}
+}
+
+TickTimingSplits::~TickTimingSplits()
+{
+	if (enabled_)
+	{
+		auto now = clock_type::now();
+		timings.nanoseconds[_tick_timing_other] += elapsed_nanoseconds(last_, now);
+		timings.total_nanoseconds += elapsed_nanoseconds(start_, now);
+		++timings.ticks;
+	}
+}
+
+void TickTimingSplits::record(int16_t which)
+{
+	auto now = clock_type::now();
+	timings.nanoseconds[which] += elapsed_nanoseconds(last_, now);
+	last_ = now;
+}
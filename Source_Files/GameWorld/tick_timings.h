@@ -0,0 +1,82 @@
+#ifndef TICK_TIMINGS_H
+#define TICK_TIMINGS_H
+
+/*
+TICK_TIMINGS.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Wall-clock accounting of the steps of update_world_elements_one_tick(),
+	used by the headless film benchmark; costs one branch per step when off
+*/
+
+#include <chrono>
+#include <cstdint>
+
+enum // tick timing steps
+{
+	_tick_timing_lights,
+	_tick_timing_media,
+	_tick_timing_platforms,
+	_tick_timing_players,
+	_tick_timing_projectiles,
+	_tick_timing_monsters,
+	_tick_timing_effects,
+	_tick_timing_other, // Lua idle, control panels, scenery, items, etc.
+	NUMBER_OF_TICK_TIMINGS
+};
+
+struct tick_timings_data
+{
+	uint64_t ticks;
+	uint64_t total_nanoseconds;
+	uint64_t nanoseconds[NUMBER_OF_TICK_TIMINGS];
+};
+
+void set_tick_timings_enabled(bool enabled);
+bool tick_timings_enabled();
+
+void reset_tick_timings();
+const tick_timings_data& get_tick_timings();
+
+const char* get_tick_timing_name(int16_t which);
+
+// attributes the time since the previous mark (or construction) to a step;
+// the destructor counts the tick and its total time
+class TickTimingSplits
+{
+public:
+	TickTimingSplits();
+	~TickTimingSplits();
+
+	void mark(int16_t which)
+	{
+		if (enabled_)
+		{
+			record(which);
+		}
+	}
+
+private:
+	void record(int16_t which);
+
+	bool enabled_;
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::steady_clock::time_point last_;
+};
+
+#endif
@@ -0,0 +1,630 @@
+/*
+VISIBILITY_SETS.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Each polygon's set comes from a portal flow: for every line leaving the polygon (the source
+	portal), a depth-first walk through the lines beyond, clipping each one to the part that a
+	straight line through both the source portal and the line the walk came in by could reach.
+	That is a superset of what any single straight line could reach, so it is conservative.
+	Clipping only depends on the source portal and the clipped line the walk came in by, so a
+	line whose clipped part has already been walked from the same source portal needn't be
+	walked again.
+*/
+
+#include "visibility_sets.h"
+#include "map.h"
+#include "polygon_adjacency.h"
+#include "dynamic_limits.h"
+#include "FileHandler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/* ---------- constants */
+
+enum {
+	MAXIMUM_VISIBILITY_SET_POLYGONS= 16384, /* 32M of sets */
+	MAXIMUM_CLIPS_PER_POLYGON= 1<<20 /* past which a polygon's set is everything it floods to */
+};
+
+/* how far (in world units/1024) a line may pass outside a portal and still count as going
+	through it; covers objects sitting on the edges of their polygons and rounding in the
+	integer walks */
+static const double PORTAL_TOLERANCE= 4.0;
+
+static const uint32 VISIBILITY_SETS_TAG= FOUR_CHARS_TO_INT('v', 'i', 's', '1');
+
+/* ---------- structures */
+
+/* copied from the map when the build starts, so the builder never reads live map data */
+struct visibility_geometry
+{
+	int32 polygon_count;
+	std::vector<int32> first_edge;
+	std::vector<int16> edge_neighbors;
+	std::vector<int16> edge_lines;
+	std::vector<int16> edge_endpoints;
+	std::vector<world_point2d> edge_vertices;
+	std::vector<uint8> edge_is_window; /* one-sided with a transparent side; sound escapes through it */
+};
+
+struct visibility_sets_data
+{
+	int32 polygon_count;
+	int32 words_per_row; /* polygon_count bits, then one for escaping through a window */
+	std::vector<uint64_t> bits;
+};
+
+struct portal
+{
+	double x0, y0, x1, y1;
+};
+
+/* ---------- globals */
+
+/* sets belongs to the builder thread until it has been joined */
+static visibility_sets_data sets;
+static bool sets_requested= false;
+static bool sets_ready= false;
+static std::atomic<bool> build_cancelled(false);
+
+static struct visibility_builder
+{
+	std::thread thread;
+
+	~visibility_builder()
+	{
+		build_cancelled= true;
+		if (thread.joinable()) thread.join();
+	}
+} builder;
+
+/* ---------- private prototypes */
+
+static void build_thread(visibility_geometry geometry);
+
+static uint64_t hash_geometry(const visibility_geometry& geometry);
+static FileSpecifier get_cache_file(uint64_t key, const char *extension);
+static bool read_cached_sets(uint64_t key, int32 polygon_count, visibility_sets_data& result);
+static void write_cached_sets(uint64_t key, visibility_sets_data& result);
+
+static bool work_out_sets(const visibility_geometry& geometry, visibility_sets_data& result);
+static bool clip_to_view(portal& next, const portal& source, const portal& pass, double beyond_source);
+static bool clip_portal(portal& p, double px, double py, double qx, double qy, double sign);
+static double side_of_line(double px, double py, double qx, double qy, double rx, double ry);
+static void dilate_sets(const visibility_geometry& geometry, visibility_sets_data& result);
+
+static inline void set_bit(uint64_t *row, int32 bit)
+{
+	row[bit>>6]|= uint64_t(1)<<(bit&63);
+}
+
+static inline bool test_bit(const uint64_t *row, int32 bit)
+{
+	return (row[bit>>6]>>(bit&63))&1;
+}
+
+/* ---------- code */
+
+void build_visibility_sets(
+	void)
+{
+	clear_visibility_sets();
+
+	int32 polygon_count= dynamic_world->polygon_count;
+	uint16 minimum_polygon_count= get_dynamic_limit(_dynamic_limit_visibility_sets);
+	if (!minimum_polygon_count || polygon_count<minimum_polygon_count || polygon_count>MAXIMUM_VISIBILITY_SET_POLYGONS) return;
+	if (polygon_adjacency.first_edge.size()!=static_cast<size_t>(polygon_count)+1) return;
+
+	visibility_geometry geometry;
+	geometry.polygon_count= polygon_count;
+	geometry.first_edge= polygon_adjacency.first_edge;
+	geometry.edge_neighbors= polygon_adjacency.edge_neighbors;
+	geometry.edge_lines= polygon_adjacency.edge_lines;
+	geometry.edge_vertices= polygon_adjacency.edge_vertices;
+	geometry.edge_endpoints.resize(geometry.edge_lines.size());
+	geometry.edge_is_window.resize(geometry.edge_lines.size());
+	for (short polygon_index= 0; polygon_index<polygon_count; ++polygon_index)
+	{
+		struct polygon_data *polygon= get_polygon_data(polygon_index);
+		int32 first_edge= get_polygon_first_edge(polygon_index);
+
+		for (short i= 0; i<polygon->vertex_count; ++i)
+		{
+			int32 edge= first_edge+i;
+
+			geometry.edge_endpoints[edge]= polygon->endpoint_indexes[i];
+			geometry.edge_is_window[edge]= geometry.edge_neighbors[edge]==NONE &&
+				adjacent_line_has_transparent_side(geometry.edge_lines[edge]);
+		}
+	}
+
+	sets_requested= true;
+	builder.thread= std::thread(build_thread, std::move(geometry));
+}
+
+void clear_visibility_sets(
+	void)
+{
+	if (builder.thread.joinable())
+	{
+		build_cancelled= true;
+		builder.thread.join();
+	}
+	build_cancelled= false;
+
+	sets_requested= false;
+	sets_ready= false;
+	sets.polygon_count= 0;
+	sets.words_per_row= 0;
+	std::vector<uint64_t>().swap(sets.bits);
+}
+
+/* true if the sets can be used; joins the builder the first time, so every check sees
+	the finished sets however long they took */
+static inline bool visibility_sets_available(
+	void)
+{
+	if (!sets_ready)
+	{
+		if (!sets_requested) return false;
+
+		builder.thread.join();
+		sets_ready= true;
+	}
+
+	return !sets.bits.empty();
+}
+
+bool wait_for_visibility_sets(
+	void)
+{
+	return visibility_sets_available();
+}
+
+bool polygon_may_see_polygon(
+	short polygon_index1,
+	short polygon_index2)
+{
+	if (!visibility_sets_available()) return true;
+	if (polygon_index1<0 || polygon_index1>=sets.polygon_count || polygon_index2<0 || polygon_index2>=sets.polygon_count) return true;
+
+	return test_bit(&sets.bits[polygon_index1*sets.words_per_row], polygon_index2);
+}
+
+bool polygon_may_hear_polygon(
+	short polygon_index1,
+	short polygon_index2)
+{
+	if (!visibility_sets_available()) return true;
+	if (polygon_index1<0 || polygon_index1>=sets.polygon_count || polygon_index2<0 || polygon_index2>=sets.polygon_count) return true;
+
+	const uint64_t *row= &sets.bits[polygon_index1*sets.words_per_row];
+	return test_bit(row, polygon_index2) || test_bit(row, sets.polygon_count);
+}
+
+/* ---------- private code */
+
+static void build_thread(
+	visibility_geometry geometry)
+{
+	uint64_t key= hash_geometry(geometry);
+	visibility_sets_data result;
+
+	if (read_cached_sets(key, geometry.polygon_count, result) || work_out_sets(geometry, result))
+	{
+		write_cached_sets(key, result);
+		sets= std::move(result);
+	}
+
+}
+
+/* FNV-1a over everything the sets are worked out from */
+static uint64_t hash_geometry(
+	const visibility_geometry& geometry)
+{
+	uint64_t hash= 14695981039346656037ULL;
+	auto add= [&hash](const void *data, size_t size) {
+		const uint8 *bytes= static_cast<const uint8 *>(data);
+		for (size_t i= 0; i<size; ++i)
+		{
+			hash= (hash^bytes[i])*1099511628211ULL;
+		}
+	};
+
+	add(&VISIBILITY_SETS_TAG, sizeof(VISIBILITY_SETS_TAG));
+	add(&geometry.polygon_count, sizeof(geometry.polygon_count));
+	add(geometry.first_edge.data(), geometry.first_edge.size()*sizeof(int32));
+	add(geometry.edge_neighbors.data(), geometry.edge_neighbors.size()*sizeof(int16));
+	add(geometry.edge_endpoints.data(), geometry.edge_endpoints.size()*sizeof(int16));
+	add(geometry.edge_is_window.data(), geometry.edge_is_window.size());
+	for (const world_point2d& vertex : geometry.edge_vertices)
+	{
+		add(&vertex.x, sizeof(vertex.x));
+		add(&vertex.y, sizeof(vertex.y));
+	}
+
+	return hash;
+}
+
+static FileSpecifier get_cache_file(
+	uint64_t key,
+	const char *extension)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(key), extension);
+
+	FileSpecifier file;
+	file.SetToCacheDir();
+	file+= "Visibility Sets";
+	file.MakeDirectory();
+	file+= name;
+
+	return file;
+}
+
+static bool read_cached_sets(
+	uint64_t key,
+	int32 polygon_count,
+	visibility_sets_data& result)
+{
+	FileSpecifier file= get_cache_file(key, "vis");
+	OpenedFile opened_file;
+	if (!file.Exists() || !file.Open(opened_file)) return false;
+
+	uint32 tag= 0;
+	int32 file_polygon_count= 0;
+	uint64_t file_key= 0;
+	if (!opened_file.Read(sizeof(tag), &tag) || tag!=VISIBILITY_SETS_TAG) return false;
+	if (!opened_file.Read(sizeof(file_polygon_count), &file_polygon_count) || file_polygon_count!=polygon_count) return false;
+	if (!opened_file.Read(sizeof(file_key), &file_key) || file_key!=key) return false;
+
+	result.polygon_count= polygon_count;
+	result.words_per_row= (polygon_count+1+63)/64;
+	result.bits.resize(static_cast<size_t>(polygon_count)*result.words_per_row);
+	if (!opened_file.Read(static_cast<int32>(result.bits.size()*sizeof(uint64_t)), result.bits.data()))
+	{
+		result.bits.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/* written under another name and renamed, so a half-written file is never read */
+static void write_cached_sets(
+	uint64_t key,
+	visibility_sets_data& result)
+{
+	FileSpecifier file= get_cache_file(key, "vis");
+	if (file.Exists()) return;
+
+	FileSpecifier temporary_file= get_cache_file(key, "tmp");
+	OpenedFile opened_file;
+	if (!temporary_file.Open(opened_file, true)) return;
+
+	uint32 tag= VISIBILITY_SETS_TAG;
+	bool written= opened_file.Write(sizeof(tag), &tag) &&
+		opened_file.Write(sizeof(result.polygon_count), &result.polygon_count) &&
+		opened_file.Write(sizeof(key), &key) &&
+		opened_file.Write(static_cast<int32>(result.bits.size()*sizeof(uint64_t)), result.bits.data());
+	opened_file.Close();
+
+	if (!written || !temporary_file.Rename(file)) temporary_file.Delete();
+}
+
+/* false if cancelled */
+static bool work_out_sets(
+	const visibility_geometry& geometry,
+	visibility_sets_data& result)
+{
+	int32 polygon_count= geometry.polygon_count;
+	size_t edge_count= geometry.edge_lines.size();
+
+	result.polygon_count= polygon_count;
+	result.words_per_row= (polygon_count+1+63)/64;
+	result.bits.assign(static_cast<size_t>(polygon_count)*result.words_per_row, 0);
+
+	/* the parts of each line already walked from the current source portal, along the line
+		from its edge's first vertex (0) to its second (1) */
+	std::vector<std::vector<std::pair<double, double> > > walked_parts(edge_count);
+	std::vector<uint32> walked_generation(edge_count, 0);
+	uint32 generation= 0;
+
+	struct walk_step
+	{
+		short polygon_index;
+		short entry_line_index;
+		portal pass;
+	};
+	std::vector<walk_step> steps;
+	std::vector<short> flood;
+
+	auto get_edge_portal= [&geometry](int32 polygon_index, int32 edge) {
+		int32 next_edge= edge+1<geometry.first_edge[polygon_index+1] ? edge+1 : geometry.first_edge[polygon_index];
+		const world_point2d& v0= geometry.edge_vertices[edge];
+		const world_point2d& v1= geometry.edge_vertices[next_edge];
+		portal p= { double(v0.x), double(v0.y), double(v1.x), double(v1.y) };
+		return p;
+	};
+
+	for (int32 polygon_index= 0; polygon_index<polygon_count; ++polygon_index)
+	{
+		if (build_cancelled) return false;
+
+		uint64_t *row= &result.bits[static_cast<size_t>(polygon_index)*result.words_per_row];
+		int32 first_edge= geometry.first_edge[polygon_index];
+		int32 last_edge= geometry.first_edge[polygon_index+1];
+		int32 clips= 0;
+
+		set_bit(row, polygon_index);
+
+		double center_x= 0, center_y= 0;
+		for (int32 edge= first_edge; edge<last_edge; ++edge)
+		{
+			center_x+= geometry.edge_vertices[edge].x;
+			center_y+= geometry.edge_vertices[edge].y;
+		}
+		if (last_edge>first_edge)
+		{
+			center_x/= last_edge-first_edge;
+			center_y/= last_edge-first_edge;
+		}
+
+		for (int32 source_edge= first_edge; source_edge<last_edge && clips<=MAXIMUM_CLIPS_PER_POLYGON; ++source_edge)
+		{
+			if (geometry.edge_is_window[source_edge]) set_bit(row, polygon_count);
+
+			short neighbor_index= geometry.edge_neighbors[source_edge];
+			if (neighbor_index==NONE) continue;
+			set_bit(row, neighbor_index);
+
+			portal source= get_edge_portal(polygon_index, source_edge);
+			double center_side= side_of_line(source.x0, source.y0, source.x1, source.y1, center_x, center_y);
+			double beyond_source= center_side<0 ? 1 : center_side>0 ? -1 : 0;
+
+			++generation;
+			steps.clear();
+			steps.push_back(walk_step{neighbor_index, geometry.edge_lines[source_edge], source});
+
+			while (!steps.empty() && clips<=MAXIMUM_CLIPS_PER_POLYGON)
+			{
+				walk_step step= steps.back();
+				steps.pop_back();
+
+				if (!(clips&0xffff) && build_cancelled) return false;
+
+				for (int32 edge= geometry.first_edge[step.polygon_index]; edge<geometry.first_edge[step.polygon_index+1]; ++edge)
+				{
+					if (geometry.edge_lines[edge]==step.entry_line_index) continue;
+					short next_polygon_index= geometry.edge_neighbors[edge];
+					if (next_polygon_index==NONE && !geometry.edge_is_window[edge]) continue;
+
+					portal next= get_edge_portal(step.polygon_index, edge);
+					portal line= next;
+					++clips;
+					if (!clip_to_view(next, source, step.pass, beyond_source)) continue;
+
+					if (next_polygon_index==NONE)
+					{
+						set_bit(row, polygon_count);
+						continue;
+					}
+					set_bit(row, next_polygon_index);
+
+					/* skip it if this part of the line has already been walked */
+					double dx= line.x1-line.x0, dy= line.y1-line.y0;
+					double length2= dx*dx+dy*dy;
+					if (length2<=0) continue;
+					double t0= ((next.x0-line.x0)*dx+(next.y0-line.y0)*dy)/length2;
+					double t1= ((next.x1-line.x0)*dx+(next.y1-line.y0)*dy)/length2;
+					if (t0>t1) std::swap(t0, t1);
+
+					std::vector<std::pair<double, double> >& parts= walked_parts[edge];
+					if (walked_generation[edge]!=generation)
+					{
+						walked_generation[edge]= generation;
+						parts.clear();
+					}
+					bool walked= false;
+					for (const auto& part : parts)
+					{
+						if (part.first<=t0 && t1<=part.second)
+						{
+							walked= true;
+							break;
+						}
+					}
+					if (walked) continue;
+					parts.push_back(std::make_pair(t0, t1));
+
+					steps.push_back(walk_step{next_polygon_index, geometry.edge_lines[edge], next});
+				}
+			}
+		}
+
+		/* too much to walk; fall back to everything this polygon's lines lead to */
+		if (clips>MAXIMUM_CLIPS_PER_POLYGON)
+		{
+			flood.clear();
+			flood.push_back(static_cast<short>(polygon_index));
+			while (!flood.empty())
+			{
+				short flood_polygon_index= flood.back();
+				flood.pop_back();
+
+				for (int32 edge= geometry.first_edge[flood_polygon_index]; edge<geometry.first_edge[flood_polygon_index+1]; ++edge)
+				{
+					short next_polygon_index= geometry.edge_neighbors[edge];
+
+					if (geometry.edge_is_window[edge]) set_bit(row, polygon_count);
+					if (next_polygon_index==NONE || test_bit(row, next_polygon_index)) continue;
+					set_bit(row, next_polygon_index);
+					flood.push_back(next_polygon_index);
+				}
+			}
+		}
+	}
+
+	dilate_sets(geometry, result);
+
+	return true;
+}
+
+/* keeps the part of next that some straight line through both source and pass could reach,
+	on the far side of source */
+static bool clip_to_view(
+	portal& next,
+	const portal& source,
+	const portal& pass,
+	double beyond_source)
+{
+	if (beyond_source!=0 && !clip_portal(next, source.x0, source.y0, source.x1, source.y1, beyond_source)) return false;
+
+	const double source_x[2]= { source.x0, source.x1 }, source_y[2]= { source.y0, source.y1 };
+	const double pass_x[2]= { pass.x0, pass.x1 }, pass_y[2]= { pass.y0, pass.y1 };
+
+	/* the lines through one end of each portal that have the other ends on opposite sides
+		bound everything that can be seen through both */
+	for (int i= 0; i<2; ++i)
+	{
+		for (int j= 0; j<2; ++j)
+		{
+			double source_side= side_of_line(source_x[i], source_y[i], pass_x[j], pass_y[j], source_x[1-i], source_y[1-i]);
+			double pass_side= side_of_line(source_x[i], source_y[i], pass_x[j], pass_y[j], pass_x[1-j], pass_y[1-j]);
+
+			if ((source_side<0 && pass_side>0) || (source_side>0 && pass_side<0))
+			{
+				if (!clip_portal(next, source_x[i], source_y[i], pass_x[j], pass_y[j], pass_side>0 ? 1 : -1)) return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+/* keeps the part of p that is on the sign side of the line through (px,py) and (qx,qy), or
+	within PORTAL_TOLERANCE of it */
+static bool clip_portal(
+	portal& p,
+	double px,
+	double py,
+	double qx,
+	double qy,
+	double sign)
+{
+	double side0= sign*side_of_line(px, py, qx, qy, p.x0, p.y0);
+	double side1= sign*side_of_line(px, py, qx, qy, p.x1, p.y1);
+
+	if (side0<-PORTAL_TOLERANCE && side1<-PORTAL_TOLERANCE) return false;
+	if (side0<-PORTAL_TOLERANCE)
+	{
+		double t= (-PORTAL_TOLERANCE-side0)/(side1-side0);
+		p.x0+= t*(p.x1-p.x0);
+		p.y0+= t*(p.y1-p.y0);
+	}
+	else if (side1<-PORTAL_TOLERANCE)
+	{
+		double t= (-PORTAL_TOLERANCE-side1)/(side0-side1);
+		p.x1+= t*(p.x0-p.x1);
+		p.y1+= t*(p.y0-p.y1);
+	}
+
+	return true;
+}
+
+/* signed distance of (rx,ry) from the line through (px,py) and (qx,qy); zero if they coincide */
+static double side_of_line(
+	double px,
+	double py,
+	double qx,
+	double qy,
+	double rx,
+	double ry)
+{
+	double dx= qx-px, dy= qy-py;
+	double length= std::sqrt(dx*dx+dy*dy);
+
+	return length>0 ? (dx*(ry-py)-dy*(rx-px))/length : 0;
+}
+
+/* line_is_obstructed() lets a walk that ends in the wrong polygon through if that polygon shares
+	an endpoint with the right one, so everything sharing an endpoint with a polygon in a set goes
+	in the set too */
+static void dilate_sets(
+	const visibility_geometry& geometry,
+	visibility_sets_data& result)
+{
+	int32 polygon_count= geometry.polygon_count;
+	int16 endpoint_count= 0;
+	for (int16 endpoint_index : geometry.edge_endpoints)
+	{
+		endpoint_count= std::max<int16>(endpoint_count, endpoint_index+1);
+	}
+
+	/* the polygons around each endpoint */
+	std::vector<int32> first_endpoint_polygon(endpoint_count+1, 0);
+	std::vector<short> endpoint_polygons(geometry.edge_endpoints.size());
+	for (int16 endpoint_index : geometry.edge_endpoints)
+	{
+		if (endpoint_index>=0) ++first_endpoint_polygon[endpoint_index+1];
+	}
+	for (int16 endpoint_index= 0; endpoint_index<endpoint_count; ++endpoint_index)
+	{
+		first_endpoint_polygon[endpoint_index+1]+= first_endpoint_polygon[endpoint_index];
+	}
+	std::vector<int32> fill(first_endpoint_polygon.begin(), first_endpoint_polygon.end()-1);
+	for (int32 polygon_index= 0; polygon_index<polygon_count; ++polygon_index)
+	{
+		for (int32 edge= geometry.first_edge[polygon_index]; edge<geometry.first_edge[polygon_index+1]; ++edge)
+		{
+			int16 endpoint_index= geometry.edge_endpoints[edge];
+			if (endpoint_index>=0) endpoint_polygons[fill[endpoint_index]++]= static_cast<short>(polygon_index);
+		}
+	}
+
+	std::vector<uint64_t> dilated(result.words_per_row);
+	for (int32 polygon_index= 0; polygon_index<polygon_count; ++polygon_index)
+	{
+		uint64_t *row= &result.bits[static_cast<size_t>(polygon_index)*result.words_per_row];
+		dilated.assign(row, row+result.words_per_row);
+
+		for (int32 seen_index= 0; seen_index<polygon_count; ++seen_index)
+		{
+			if (!test_bit(row, seen_index)) continue;
+
+			for (int32 edge= geometry.first_edge[seen_index]; edge<geometry.first_edge[seen_index+1]; ++edge)
+			{
+				int16 endpoint_index= geometry.edge_endpoints[edge];
+				if (endpoint_index<0) continue;
+
+				for (int32 i= first_endpoint_polygon[endpoint_index]; i<first_endpoint_polygon[endpoint_index+1]; ++i)
+				{
+					set_bit(dilated.data(), endpoint_polygons[i]);
+				}
+			}
+		}
+
+		std::copy(dilated.begin(), dilated.end(), row);
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef VISIBILITY_SETS_H
+#define VISIBILITY_SETS_H
+
+/*
+VISIBILITY_SETS.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Optional potentially-visible sets: for every polygon, a bit for each polygon that some
+	straight line from inside it could reach by passing only through lines with polygons on both
+	sides.  Every such line counts as open, whatever its flags and whatever state the platforms
+	are in, so the sets stay correct as doors open and Lua changes lines; they are conservative,
+	and only ever let line of sight and sound obstruction checks give up early on walks that
+	could not have succeeded.
+
+	The sets only exist when the map has at least as many polygons as the visibility_sets
+	dynamic limit (which is off by default).  They are worked out in a background thread while
+	the rest of the level loads, and kept in the cache directory under a hash of the level's
+	geometry, so the next time the level is played they are just read back.  The level doesn't
+	start until they are finished, so the simulation sees the same sets from its first tick
+	on every machine, however long they took to build.
+*/
+
+#include "cseries.h"
+
+/* starts building (or reading back) the sets for the current map, replacing any previous
+	ones; does nothing unless the visibility_sets dynamic limit asks for them */
+void build_visibility_sets(void);
+void clear_visibility_sets(void);
+
+/* blocks until the sets are finished; false if there are none for this map.  entering_map()
+	calls this before the first tick */
+bool wait_for_visibility_sets(void);
+
+/* false only if nothing in polygon_index2, or sharing an endpoint with a polygon that is,
+	can be seen along a straight line from polygon_index1; true if there are no sets for this
+	map.  Blocks until the sets are finished */
+bool polygon_may_see_polygon(short polygon_index1, short polygon_index2);
+
+/* the same for sound, which also escapes through one-sided lines with a transparent side */
+bool polygon_may_hear_polygon(short polygon_index1, short polygon_index2);
+
+#endif
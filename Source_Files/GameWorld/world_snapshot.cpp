@@ -0,0 +1,648 @@
+/*
+WORLD_SNAPSHOT.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "world_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "cseries.h"
+#include "map.h"
+#include "monsters.h"
+#include "projectiles.h"
+#include "effects.h"
+#include "platforms.h"
+#include "media.h"
+#include "lightsource.h"
+#include "player.h"
+#include "weapons.h"
+#include "flood_map.h"
+#include "polygon_adjacency.h"
+#include "collision_grid.h"
+#include "interpolated_world.h"
+#include "Logging.h"
+#include "Packing.h"
+
+// small enough that a moving monster or projectile dirties little besides itself
+static const size_t block_size = 4096;
+
+static int32 world_hash_interval = 0;
+static std::vector<std::pair<int32, uint64_t>> world_hashes;
+
+enum {
+	_region_dynamic_world,
+	_region_players,
+	_region_weapons,
+	_region_objects,
+	_region_monsters,
+	_region_paths,
+	_region_projectiles,
+	_region_effects,
+	_region_platforms,
+	_region_medias,
+	_region_lights,
+	_region_polygons,
+	_region_lines,
+	_region_sides,
+	_region_endpoints,
+	NUMBER_OF_SNAPSHOT_REGIONS
+};
+
+struct region_location {
+	uint8* data;
+	size_t size;
+};
+
+template <typename T>
+static region_location vector_region(std::vector<T>& v)
+{
+	return { reinterpret_cast<uint8*>(v.data()), v.size() * sizeof(T) };
+}
+
+static region_location get_region_location(int which)
+{
+	switch (which)
+	{
+		case _region_dynamic_world:
+			return { reinterpret_cast<uint8*>(dynamic_world), sizeof(dynamic_data) };
+		case _region_players:
+			return { reinterpret_cast<uint8*>(players), MAXIMUM_NUMBER_OF_PLAYERS * sizeof(player_data) };
+		case _region_weapons:
+			return { static_cast<uint8*>(get_weapon_array()), static_cast<size_t>(calculate_weapon_array_length()) };
+		case _region_objects: return vector_region(ObjectList);
+		case _region_monsters: return vector_region(MonsterList);
+		case _region_paths:
+			return { static_cast<uint8*>(get_path_array()), calculate_path_array_length() };
+		case _region_projectiles: return vector_region(ProjectileList);
+		case _region_effects: return vector_region(EffectList);
+		case _region_platforms: return vector_region(PlatformList);
+		case _region_medias: return vector_region(MediaList);
+		case _region_lights: return vector_region(LightList);
+		case _region_polygons: return vector_region(PolygonList);
+		case _region_lines: return vector_region(LineList);
+		case _region_sides: return vector_region(SideList);
+		case _region_endpoints: return vector_region(EndpointList);
+	}
+
+	assert(false);
+	return { nullptr, 0 };
+}
+
+// how take() and restore() find the blocks that may have changed
+enum {
+	_region_always_compared,	// small, or changes every tick
+	_region_used_slots,		// blocks with a used slot, plus those marked when one is allocated
+	_region_marked			// only blocks marked by world_changed()
+};
+
+static int get_region_tracking(int which)
+{
+	switch (which)
+	{
+		case _region_objects:
+		case _region_monsters:
+		case _region_projectiles:
+		case _region_effects:
+			return _region_used_slots;
+
+		case _region_polygons:
+		case _region_lines:
+		case _region_sides:
+		case _region_endpoints:
+			return _region_marked;
+	}
+
+	return _region_always_compared;
+}
+
+// world_generation advances with every take() and restore(); a block marked since a
+// snapshot was taken has a later generation than the snapshot
+static uint64_t world_generation = 1;
+static uint64_t replaced_generation = 0;
+
+struct region_generations {
+	uint64_t latest = 0;
+	std::vector<uint64_t> blocks;
+};
+
+static region_generations generations[NUMBER_OF_SNAPSHOT_REGIONS];
+
+static void mark_region_changed(int which, size_t offset, size_t length)
+{
+	auto& region = generations[which];
+	size_t last_block = (offset + length - 1) / block_size;
+	if (region.blocks.size() <= last_block)
+		region.blocks.resize(last_block + 1);
+
+	for (size_t j = offset / block_size; j <= last_block; ++j)
+	{
+		region.blocks[j] = world_generation;
+	}
+	region.latest = world_generation;
+}
+
+void world_changed(const void* data, size_t size)
+{
+	if (size == 0)
+		return;
+
+	auto address = reinterpret_cast<uintptr_t>(data);
+	for (int i = 0; i < NUMBER_OF_SNAPSHOT_REGIONS; ++i)
+	{
+		if (get_region_tracking(i) == _region_always_compared)
+			continue;
+
+		auto location = get_region_location(i);
+		auto start = reinterpret_cast<uintptr_t>(location.data);
+		if (address >= start && address + size <= start + location.size)
+		{
+			mark_region_changed(i, address - start, size);
+			return;
+		}
+	}
+}
+
+void world_replaced()
+{
+	replaced_generation = world_generation;
+	for (auto& region : generations)
+	{
+		region = region_generations();
+	}
+}
+
+static bool block_marked_since(int which, size_t block, uint64_t generation)
+{
+	const auto& region = generations[which];
+	return region.latest > generation && block < region.blocks.size() && region.blocks[block] > generation;
+}
+
+// for each block, whether any record overlapping it is in use
+template <typename T>
+static void find_used_blocks(const std::vector<T>& records, std::vector<bool>& used)
+{
+	used.assign((records.size() * sizeof(T) + block_size - 1) / block_size, false);
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		if (SLOT_IS_USED(&records[i]))
+		{
+			for (size_t j = i * sizeof(T) / block_size; j <= ((i + 1) * sizeof(T) - 1) / block_size; ++j)
+			{
+				used[j] = true;
+			}
+		}
+	}
+}
+
+static void find_used_blocks(int which, std::vector<bool>& used)
+{
+	switch (which)
+	{
+		case _region_objects: find_used_blocks(ObjectList, used); break;
+		case _region_monsters: find_used_blocks(MonsterList, used); break;
+		case _region_projectiles: find_used_blocks(ProjectileList, used); break;
+		case _region_effects: find_used_blocks(EffectList, used); break;
+		default: used.clear(); break;
+	}
+}
+
+// restore() writes the arrays directly, behind the interpolated world's back
+static void mark_block_changed(int which, size_t offset, size_t length)
+{
+	switch (which)
+	{
+		case _region_objects:
+			for (auto i = offset / sizeof(object_data); i < (offset + length + sizeof(object_data) - 1) / sizeof(object_data); ++i)
+			{
+				interpolated_world_object_changed(static_cast<int16>(i));
+			}
+			break;
+
+		case _region_polygons:
+			for (auto i = offset / sizeof(polygon_data); i < (offset + length + sizeof(polygon_data) - 1) / sizeof(polygon_data); ++i)
+			{
+				interpolated_world_polygon_changed(static_cast<int16>(i));
+			}
+			break;
+
+		case _region_lines:
+			for (auto i = offset / sizeof(line_data); i < (offset + length + sizeof(line_data) - 1) / sizeof(line_data); ++i)
+			{
+				auto line = &LineList[i];
+				interpolated_world_polygon_changed(line->clockwise_polygon_owner);
+				interpolated_world_polygon_changed(line->counterclockwise_polygon_owner);
+			}
+			break;
+
+		case _region_sides:
+			for (auto i = offset / sizeof(side_data); i < (offset + length + sizeof(side_data) - 1) / sizeof(side_data); ++i)
+			{
+				interpolated_world_polygon_changed(SideList[i].polygon_index);
+			}
+			break;
+	}
+}
+
+// turn this on to check after every restore() that no block was missed because
+// something changed the world without calling world_changed(); the renderer's transformed
+// endpoints are scratch space and will show up here too
+// #define VERIFY_WORLD_SNAPSHOTS
+
+void WorldSnapshot::clear()
+{
+	regions_.clear();
+	bytes_copied_ = 0;
+	taken_at_ = 0;
+}
+
+bool WorldSnapshot::block_may_differ(int which, size_t block, const std::vector<bool>& used) const
+{
+	switch (get_region_tracking(which))
+	{
+		case _region_used_slots:
+			if (used[block] || regions_[which].used[block])
+				return true;
+			break;
+
+		case _region_marked:
+			break;
+
+		default:
+			return true;
+	}
+
+	return block_marked_since(which, block, taken_at_);
+}
+
+void WorldSnapshot::take()
+{
+	bytes_copied_ = 0;
+	regions_.resize(NUMBER_OF_SNAPSHOT_REGIONS);
+
+	// a snapshot from before a level change has nothing to go on
+	bool complete = taken_at_ < replaced_generation;
+
+	std::vector<bool> used;
+	for (int i = 0; i < NUMBER_OF_SNAPSHOT_REGIONS; ++i)
+	{
+		auto location = get_region_location(i);
+		auto& region = regions_[i];
+
+		if (region.size != location.size)
+		{
+			region.size = location.size;
+			region.blocks.clear();
+		}
+		region.blocks.resize((region.size + block_size - 1) / block_size);
+
+		find_used_blocks(i, used);
+		if (region.used.size() != used.size())
+			region.used.assign(used.size(), true);
+
+		for (size_t j = 0; j < region.blocks.size(); ++j)
+		{
+			auto& block = region.blocks[j];
+			if (block && !complete && !block_may_differ(i, j, used))
+				continue;
+
+			const uint8* live = location.data + j * block_size;
+			size_t length = std::min(block_size, region.size - j * block_size);
+
+			if (!block || std::memcmp(block->data(), live, length) != 0)
+			{
+				block = std::make_shared<const std::vector<uint8>>(live, live + length);
+				bytes_copied_ += length;
+			}
+		}
+
+		region.used = used;
+	}
+
+	random_seed_ = get_random_seed();
+	taken_at_ = world_generation++;
+}
+
+bool WorldSnapshot::restore()
+{
+	if (empty() || taken_at_ < replaced_generation)
+		return false;
+
+	for (int i = 0; i < NUMBER_OF_SNAPSHOT_REGIONS; ++i)
+	{
+		if (regions_[i].size != get_region_location(i).size)
+			return false;
+	}
+
+	bool changed[NUMBER_OF_SNAPSHOT_REGIONS] = {};
+	std::vector<bool> used;
+	for (int i = 0; i < NUMBER_OF_SNAPSHOT_REGIONS; ++i)
+	{
+		auto location = get_region_location(i);
+		const auto& region = regions_[i];
+
+		find_used_blocks(i, used);
+		for (size_t j = 0; j < region.blocks.size(); ++j)
+		{
+			if (!block_may_differ(i, j, used))
+				continue;
+
+			uint8* live = location.data + j * block_size;
+			const auto& block = *region.blocks[j];
+
+			if (std::memcmp(block.data(), live, block.size()) != 0)
+			{
+				std::memcpy(live, block.data(), block.size());
+				mark_block_changed(i, j * block_size, block.size());
+				changed[i] = true;
+
+				// so other snapshots know this block has changed under them
+				if (get_region_tracking(i) != _region_always_compared)
+					mark_region_changed(i, j * block_size, block.size());
+			}
+		}
+	}
+
+#ifdef VERIFY_WORLD_SNAPSHOTS
+	for (int i = 0; i < NUMBER_OF_SNAPSHOT_REGIONS; ++i)
+	{
+		auto location = get_region_location(i);
+		const auto& region = regions_[i];
+		for (size_t j = 0; j < region.blocks.size(); ++j)
+		{
+			const auto& block = *region.blocks[j];
+			if (std::memcmp(block.data(), location.data + j * block_size, block.size()) != 0)
+				logError("world snapshot region %d block %d changed without world_changed()", i, static_cast<int>(j));
+		}
+	}
+#endif
+
+	set_random_seed(random_seed_);
+	taken_at_ = world_generation++;
+
+	// derived state that isn't part of the snapshot
+	if (changed[_region_lines])
+	{
+		for (short line_index = 0; line_index < dynamic_world->line_count; ++line_index)
+		{
+			update_line_adjacency(line_index);
+		}
+	}
+
+	if ((changed[_region_objects] || changed[_region_polygons]) && collision_grid_enabled())
+	{
+		build_collision_grid();
+	}
+
+	return true;
+}
+
+// xxHash64-style rounds: four independent lanes over 32-byte stripes, so the loop
+// pipelines (and vectorizes) instead of waiting on one multiply per byte
+class WorldHasher
+{
+public:
+	void add(const void* data, size_t size)
+	{
+		auto bytes = static_cast<const uint8*>(data);
+		total_size_ += size;
+
+		if (pending_size_)
+		{
+			size_t count = std::min(size, stripe_size - pending_size_);
+			std::memcpy(pending_ + pending_size_, bytes, count);
+			pending_size_ += count;
+			bytes += count;
+			size -= count;
+
+			if (pending_size_ < stripe_size)
+				return;
+
+			add_stripe(pending_);
+			pending_size_ = 0;
+		}
+
+		for (; size >= stripe_size; bytes += stripe_size, size -= stripe_size)
+		{
+			add_stripe(bytes);
+		}
+
+		std::memcpy(pending_, bytes, size);
+		pending_size_ = size;
+	}
+
+	uint64_t finish() const
+	{
+		uint64_t hash = rotate(lanes_[0], 1) + rotate(lanes_[1], 7) + rotate(lanes_[2], 12) + rotate(lanes_[3], 18);
+		for (auto lane : lanes_)
+		{
+			hash = (hash ^ round(0, lane)) * prime1 + prime4;
+		}
+		hash += total_size_;
+
+		size_t i = 0;
+		for (; i + 8 <= pending_size_; i += 8)
+		{
+			hash = rotate(hash ^ round(0, load(pending_ + i)), 27) * prime1 + prime4;
+		}
+		for (; i < pending_size_; ++i)
+		{
+			hash = rotate(hash ^ (pending_[i] * prime5), 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+private:
+	static const uint64_t prime1 = 11400714785074694791ULL;
+	static const uint64_t prime2 = 14029467366897019727ULL;
+	static const uint64_t prime3 = 1609587929392839161ULL;
+	static const uint64_t prime4 = 9650029242287828579ULL;
+	static const uint64_t prime5 = 2870177450012600261ULL;
+	static const size_t stripe_size = 32;
+
+	static uint64_t rotate(uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); }
+	static uint64_t round(uint64_t lane, uint64_t value) { return rotate(lane + value * prime2, 31) * prime1; }
+
+	// little-endian whatever the machine, so every peer hashes the same values
+	static uint64_t load(const uint8* bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 7; i >= 0; --i)
+		{
+			value = (value << 8) | bytes[i];
+		}
+		return value;
+	}
+
+	void add_stripe(const uint8* bytes)
+	{
+		for (int lane = 0; lane < 4; ++lane)
+		{
+			lanes_[lane] = round(lanes_[lane], load(bytes + lane * 8));
+		}
+	}
+
+	uint64_t lanes_[4] = { prime1 + prime2, prime2, 0, 0 - prime1 };
+	uint8 pending_[stripe_size];
+	size_t pending_size_ = 0;
+	uint64_t total_size_ = 0;
+};
+
+// Keeps a hash of each record of one kind, so a world hash only packs and hashes the
+// records whose bytes changed since the last one; the records are hashed as they're
+// packed into saved games (field by field, big-endian, with no padding), so the hash
+// doesn't depend on the compiler or the machine
+template <typename T>
+class RecordHashes
+{
+public:
+	typedef uint8* (*pack_function)(uint8*, T*, size_t);
+
+	RecordHashes(pack_function pack, int packed_size) : pack_(pack), packed_(packed_size) { }
+
+	// sum of the hashes of every record, each hashed together with its index
+	uint64_t update(const T* records, size_t count)
+	{
+		if (copies_.size() != count)
+		{
+			copies_.resize(count);
+			hashes_.resize(count);
+			sum_ = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				std::memcpy(&copies_[i], &records[i], sizeof(T));
+				hashes_[i] = hash_record(i);
+				sum_ += hashes_[i];
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (std::memcmp(&copies_[i], &records[i], sizeof(T)) == 0)
+					continue;
+
+				std::memcpy(&copies_[i], &records[i], sizeof(T));
+				sum_ -= hashes_[i];
+				hashes_[i] = hash_record(i);
+				sum_ += hashes_[i];
+			}
+		}
+
+		return sum_;
+	}
+
+private:
+	pack_function pack_;
+	std::vector<uint8> packed_;
+	std::vector<T> copies_;
+	std::vector<uint64_t> hashes_;
+	uint64_t sum_ = 0;
+
+	uint64_t hash_record(size_t index)
+	{
+		uint8 header[4];
+		uint8* stream = header;
+		ValueToStream(stream, static_cast<uint32>(index));
+		pack_(packed_.data(), &copies_[index], 1);
+
+		WorldHasher hasher;
+		hasher.add(header, sizeof(header));
+		hasher.add(packed_.data(), packed_.size());
+		return hasher.finish();
+	}
+};
+
+static RecordHashes<player_data> player_hashes(pack_player_data, SIZEOF_player_data);
+static RecordHashes<monster_data> monster_hashes(pack_monster_data, SIZEOF_monster_data);
+static RecordHashes<object_data> object_hashes(pack_object_data, SIZEOF_object_data);
+static RecordHashes<projectile_data> projectile_hashes(pack_projectile_data, SIZEOF_projectile_data);
+static RecordHashes<platform_data> platform_hashes(pack_platform_data, SIZEOF_platform_data);
+
+uint64_t calculate_world_hash()
+{
+	// fields each machine keeps for its own interface, which are free to differ; the
+	// others (netdead, step_height, run_key) aren't packed
+	player_data players[MAXIMUM_NUMBER_OF_PLAYERS];
+	for (short player_index = 0; player_index < dynamic_world->player_count; ++player_index)
+	{
+		players[player_index] = *get_player_data(player_index);
+		players[player_index].interface_flags = 0;
+		players[player_index].interface_decay = 0;
+	}
+
+	uint64_t sums[] = {
+		player_hashes.update(players, dynamic_world->player_count),
+		monster_hashes.update(MonsterList.data(), MonsterList.size()),
+		object_hashes.update(ObjectList.data(), ObjectList.size()),
+		projectile_hashes.update(ProjectileList.data(), ProjectileList.size()),
+		platform_hashes.update(PlatformList.data(), PlatformList.size())
+	};
+
+	uint8 values[sizeof(sums) + 6];
+	uint8* stream = values;
+	for (auto sum : sums)
+	{
+		ValueToStream(stream, static_cast<uint32>(sum >> 32));
+		ValueToStream(stream, static_cast<uint32>(sum));
+	}
+	ValueToStream(stream, get_random_seed());
+	ValueToStream(stream, dynamic_world->tick_count);
+
+	WorldHasher hasher;
+	hasher.add(values, sizeof(values));
+	return hasher.finish();
+}
+
+void set_world_hash_interval(int32 interval)
+{
+	world_hash_interval = interval;
+}
+
+int32 get_world_hash_interval()
+{
+	return world_hash_interval;
+}
+
+void reset_world_hashes()
+{
+	world_hashes.clear();
+}
+
+const std::vector<std::pair<int32, uint64_t>>& get_world_hashes()
+{
+	return world_hashes;
+}
+
+bool record_world_hash()
+{
+	if (world_hash_interval > 0 && dynamic_world->tick_count % world_hash_interval == 0)
+	{
+		world_hashes.push_back({ dynamic_world->tick_count, calculate_world_hash() });
+		return true;
+	}
+
+	return false;
+}
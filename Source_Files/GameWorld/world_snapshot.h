@@ -0,0 +1,112 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+/*
+WORLD_SNAPSHOT.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	In-memory copies of the simulation state, for putting the world back after running it
+	ahead (prediction, rollback) without going through a game_wad.
+
+	A snapshot covers dynamic_world, the random seed, players and their weapons, and the
+	object, monster, path, projectile, effect, platform, media, light, polygon, line, side and
+	endpoint arrays.  It does not cover Lua state, sounds or anything else outside the
+	simulation's arrays.
+
+	Each array is kept as fixed-size blocks that are shared between copies of a snapshot, so
+	a ring of snapshots over several ticks only stores the blocks that changed between them:
+	copy the previous snapshot, then take() only copies the blocks the world has changed
+	since.  restore() likewise only writes the blocks that differ from the live world.
+
+	Neither compares the whole world to find those blocks.  The object, monster, projectile
+	and effect arrays are only compared where a slot is in use (new slots are marked as
+	they're allocated), and the map geometry only where the code that changes it has called
+	world_changed(); the rest is small enough to compare every time.
+
+	The core of the same state (players, monsters, objects, projectiles, platforms and the random
+	seed) can also be hashed cheaply enough to do every tick, to check that two runs of the
+	simulation, or the machines in a network game, still agree.
+*/
+
+#include "cstypes.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+class WorldSnapshot
+{
+public:
+	bool empty() const { return regions_.empty(); }
+	void clear();
+
+	// Brings the snapshot up to date with the live world; unchanged blocks are kept
+	// (and stay shared with any copies of this snapshot)
+	void take();
+
+	// Puts the world back the way it was at take().  Returns false without touching
+	// anything if the arrays have been reallocated or reloaded since (e.g. by a level change)
+	bool restore();
+
+	// Bytes the last take() had to copy
+	size_t bytes_copied() const { return bytes_copied_; }
+
+private:
+	typedef std::shared_ptr<const std::vector<uint8>> Block;
+
+	struct Region {
+		size_t size;
+		std::vector<Block> blocks;
+		std::vector<bool> used;		// blocks with a slot in use at take()
+	};
+
+	bool block_may_differ(int which, size_t block, const std::vector<bool>& used) const;
+
+	std::vector<Region> regions_;
+	uint16 random_seed_ = 0;
+	size_t bytes_copied_ = 0;
+	uint64_t taken_at_ = 0;
+};
+
+// Tells snapshots that part of the map geometry (polygons, lines, sides, endpoints) is
+// about to change, or that an object, monster, projectile or effect slot has just been
+// allocated; anything else is ignored
+void world_changed(const void* data, size_t size);
+
+template <typename T>
+void world_changed(const T* record) { world_changed(record, sizeof(T)); }
+
+// After loading a level or a saved game; every snapshot taken before is out of date
+void world_replaced();
+
+// Hash of the core simulation state and the tick count, leaving out the fields of
+// player_data that only drive the local interface; only records that changed since the
+// last call are hashed again
+uint64_t calculate_world_hash();
+
+// Every interval ticks (0 turns it off), update_world_elements_one_tick() records
+// the tick count and world hash, for replay verification, films and network games
+void set_world_hash_interval(int32 interval);
+int32 get_world_hash_interval();
+void reset_world_hashes();
+const std::vector<std::pair<int32, uint64_t>>& get_world_hashes();
+
+// Returns true if it recorded a hash for the current tick
+bool record_world_hash();
+
+#endif
@@ -31,6 +31,9 @@ LUA_MAP.CPP
 #include "lua_templates.h"
 #include "lightsource.h"
 #include "map.h"
+#include "interpolated_world.h"
+#include "world_snapshot.h"
+#include "polygon_adjacency.h"
 #include "media.h"
 #include "platforms.h"
 #include "player.h"
@@ -283,7 +286,10 @@ static int Lua_Line_Set_Decorative(lua_State* L)
 	if (!lua_isboolean(L, 2))
 		return luaL_error(L, ("decorative: incorrect argument type"));
 
-	get_line_data(Lua_Line::Index(L, 1))->set_decorative(lua_toboolean(L, 2));
+	short line_index = Lua_Line::Index(L, 1);
+	world_changed(get_line_data(line_index));
+	get_line_data(line_index)->set_decorative(lua_toboolean(L, 2));
+	update_line_adjacency(line_index);
 	return 0;
 }
 
@@ -724,6 +730,7 @@ static int Lua_Polygon_Floor_Set_Collection(lua_State *L)
 	short collection_index = Lua_Collection::ToIndex(L, 2);
 
 	polygon_data *polygon = get_polygon_data(polygon_index);
+	world_changed(polygon);
 	polygon->floor_texture = BUILD_DESCRIPTOR(collection_index, GET_DESCRIPTOR_SHAPE(polygon->floor_texture));
 	return 0;
 }
@@ -736,7 +743,9 @@ static int Lua_Polygon_Floor_Set_Height(lua_State *L)
 	}
 
 	struct polygon_data *polygon = get_polygon_data(Lua_Polygon_Floor::Index(L, 1));
+	world_changed(polygon);
 	polygon->floor_height = static_cast<world_distance>(lua_tonumber(L,2)*WORLD_ONE);
+	interpolated_world_polygon_changed(Lua_Polygon_Floor::Index(L, 1));
 	for (short i = 0; i < polygon->vertex_count; ++i)
 	{
 		recalculate_redundant_endpoint_data(polygon->endpoint_indexes[i]);
@@ -747,6 +756,7 @@ static int Lua_Polygon_Floor_Set_Height(lua_State *L)
 
 static int Lua_Polygon_Floor_Set_Light(lua_State *L)
 {
+	world_changed(get_polygon_data(Lua_Polygon_Floor::Index(L, 1)));
 	short light_index;
 	if (lua_isnumber(L, 2))
 	{
@@ -766,6 +776,7 @@ static int Lua_Polygon_Floor_Set_Light(lua_State *L)
 static int Lua_Polygon_Floor_Set_Texture_Index(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Floor::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_index: incorrect argument type");
 
@@ -780,6 +791,7 @@ static int Lua_Polygon_Floor_Set_Texture_Index(lua_State *L)
 static int Lua_Polygon_Floor_Set_Texture_X(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Floor::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_x: incorrect argument type");
 
@@ -790,6 +802,7 @@ static int Lua_Polygon_Floor_Set_Texture_X(lua_State *L)
 static int Lua_Polygon_Floor_Set_Texture_Y(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Floor::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_y: incorrect argument type");
 
@@ -800,6 +813,7 @@ static int Lua_Polygon_Floor_Set_Texture_Y(lua_State *L)
 static int Lua_Polygon_Floor_Set_Transfer_Mode(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Floor::Index(L, 1));
+	world_changed(polygon);
 	polygon->floor_transfer_mode = Lua_TransferMode::ToIndex(L, 2);
 	return 0;
 }
@@ -878,6 +892,7 @@ static int Lua_Polygon_Ceiling_Set_Collection(lua_State *L)
 	short collection_index = Lua_Collection::ToIndex(L, 2);
 
 	polygon_data *polygon = get_polygon_data(polygon_index);
+	world_changed(polygon);
 	polygon->ceiling_texture = BUILD_DESCRIPTOR(collection_index, GET_DESCRIPTOR_SHAPE(polygon->ceiling_texture));
 	return 0;
 }
@@ -890,7 +905,9 @@ static int Lua_Polygon_Ceiling_Set_Height(lua_State *L)
 	}
 
 	struct polygon_data *polygon = get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1));
+	world_changed(polygon);
 	polygon->ceiling_height = static_cast<world_distance>(lua_tonumber(L,2)*WORLD_ONE);
+	interpolated_world_polygon_changed(Lua_Polygon_Ceiling::Index(L, 1));
 	for (short i = 0; i < polygon->vertex_count; ++i)
 	{
 		recalculate_redundant_endpoint_data(polygon->endpoint_indexes[i]);
@@ -901,6 +918,7 @@ static int Lua_Polygon_Ceiling_Set_Height(lua_State *L)
 
 static int Lua_Polygon_Ceiling_Set_Light(lua_State *L)
 {
+	world_changed(get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1)));
 	short light_index;
 	if (lua_isnumber(L, 2))
 	{
@@ -920,6 +938,7 @@ static int Lua_Polygon_Ceiling_Set_Light(lua_State *L)
 static int Lua_Polygon_Ceiling_Set_Texture_Index(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_index: incorrect argument type");
 
@@ -934,6 +953,7 @@ static int Lua_Polygon_Ceiling_Set_Texture_Index(lua_State *L)
 static int Lua_Polygon_Ceiling_Set_Texture_X(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_x: incorrect argument type");
 
@@ -944,6 +964,7 @@ static int Lua_Polygon_Ceiling_Set_Texture_X(lua_State *L)
 static int Lua_Polygon_Ceiling_Set_Texture_Y(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1));
+	world_changed(polygon);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_y: incorrect argument type");
 
@@ -954,6 +975,7 @@ static int Lua_Polygon_Ceiling_Set_Texture_Y(lua_State *L)
 static int Lua_Polygon_Ceiling_Set_Transfer_Mode(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon_Ceiling::Index(L, 1));
+	world_changed(polygon);
 	polygon->ceiling_transfer_mode = Lua_TransferMode::ToIndex(L, 2);
 	return 0;
 }
@@ -1693,6 +1715,7 @@ static int Lua_Polygon_Get_Visible_On_Automap(lua_State *L)
 static int Lua_Polygon_Set_Media(lua_State *L)
 {
 	polygon_data *polygon = get_polygon_data(Lua_Polygon::Index(L, 1));
+	world_changed(polygon);
 	short media_index = NONE;
 	if (lua_isnumber(L, 2))
 	{
@@ -1716,6 +1739,7 @@ static int Lua_Polygon_Set_Media(lua_State *L)
 		
 static int Lua_Polygon_Set_Permutation(lua_State *L)
 {
+	world_changed(get_polygon_data(Lua_Polygon::Index(L, 1)));
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, ("type: incorrect argument type"));
 	
@@ -1727,6 +1751,7 @@ static int Lua_Polygon_Set_Permutation(lua_State *L)
 static int Lua_Polygon_Set_Type(lua_State *L)
 {
 	polygon_data* polygon = get_polygon_data(Lua_Polygon::Index(L, 1));
+	world_changed(polygon);
 	polygon->type = Lua_PolygonType::ToIndex(L, 2);
 	return 0;
 }
@@ -1815,6 +1840,7 @@ static int Lua_Side_ControlPanel_Set_Flag(lua_State *L)
 		return luaL_error(L, "control_panel: incorrect argument type");
 	
 	side_data *side = get_side_data(Lua_Side_ControlPanel::Index(L, 1));
+	world_changed(side);
 	if (lua_toboolean(L, 2))
 		side->flags |= flag;
 	else
@@ -1859,6 +1885,7 @@ static int Lua_Side_ControlPanel_Set_Permutation(lua_State *L)
 		return luaL_error(L, "permutation: incorrect argument type");
 
 	side_data *side = get_side_data(Lua_Side_ControlPanel::Index(L, 1));
+	world_changed(side);
 	side->control_panel_permutation = static_cast<int16>(lua_tonumber(L, 2));
 	return 0;
 }
@@ -1868,6 +1895,7 @@ extern void set_control_panel_texture(side_data *);
 static int Lua_Side_ControlPanel_Set_Type(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Side_ControlPanel::Index(L, 1));
+	world_changed(side);
 	side->control_panel_type = Lua_ControlPanelType::ToIndex(L, 2);
 	set_control_panel_texture(side);
 	return 0;
@@ -1965,8 +1993,10 @@ static void update_line_redundancy(short line_index)
 		transparent_texture= true;
 	}
 	
+	world_changed(line);
 	SET_LINE_LANDSCAPE_STATUS(line, landscaped);
 	SET_LINE_HAS_TRANSPARENT_SIDE(line, transparent_texture);
+	update_line_adjacency(line_index);
 }
 
 static int Lua_Primary_Side_Set_Collection(lua_State *L)
@@ -1975,6 +2005,7 @@ static int Lua_Primary_Side_Set_Collection(lua_State *L)
 	short collection_index = Lua_Collection::ToIndex(L, 2);
 
 	side_data *side = get_side_data(side_index);
+	world_changed(side);
 	side->primary_texture.texture = BUILD_DESCRIPTOR(collection_index, GET_DESCRIPTOR_SHAPE(side->primary_texture.texture));
 	update_line_redundancy(side->line_index);
 	return 0;
@@ -1989,6 +2020,7 @@ static int Lua_Primary_Side_Set_Empty(lua_State *L)
 	if (lua_toboolean(L, 2))
 	{
 		side_data *side = get_side_data(side_index);
+		world_changed(side);
 		side->primary_texture.texture = UNONE;
 		update_line_redundancy(side->line_index);
 	}
@@ -1997,6 +2029,7 @@ static int Lua_Primary_Side_Set_Empty(lua_State *L)
 
 static int Lua_Primary_Side_Set_Light(lua_State *L)
 {
+	world_changed(get_side_data(Lua_Primary_Side::Index(L, 1)));
 	short light_index;
 	if (lua_isnumber(L, 2))
 	{
@@ -2015,6 +2048,7 @@ static int Lua_Primary_Side_Set_Light(lua_State *L)
 static int Lua_Primary_Side_Set_Texture_Index(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Primary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_index: incorrect argument type");
 
@@ -2030,6 +2064,7 @@ static int Lua_Primary_Side_Set_Texture_Index(lua_State *L)
 static int Lua_Primary_Side_Set_Texture_X(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Primary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_x: incorrect argument type");
 
@@ -2040,16 +2075,19 @@ static int Lua_Primary_Side_Set_Texture_X(lua_State *L)
 static int Lua_Primary_Side_Set_Texture_Y(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Primary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_y: incorrect argument type");
 
 	side->primary_texture.y0 = static_cast<world_distance>(lua_tonumber(L, 2) * WORLD_ONE);
+	interpolated_world_polygon_changed(side->polygon_index);
 	return 0;
 }
 
 static int Lua_Primary_Side_Set_Transfer_Mode(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Primary_Side::Index(L, 1));
+	world_changed(side);
 	side->primary_transfer_mode = Lua_TransferMode::ToIndex(L, 2);
 	return 0;
 }
@@ -2126,6 +2164,7 @@ static int Lua_Secondary_Side_Set_Collection(lua_State *L)
 	short collection_index = Lua_Collection::ToIndex(L, 2);
 
 	side_data *side = get_side_data(side_index);
+	world_changed(side);
 	side->secondary_texture.texture = BUILD_DESCRIPTOR(collection_index, GET_DESCRIPTOR_SHAPE(side->secondary_texture.texture));
 	update_line_redundancy(side->line_index);
 	return 0;
@@ -2140,6 +2179,7 @@ static int Lua_Secondary_Side_Set_Empty(lua_State *L)
 	if (lua_toboolean(L, 2))
 	{
 		side_data *side = get_side_data(side_index);
+		world_changed(side);
 		side->secondary_texture.texture = UNONE;
 		update_line_redundancy(side->line_index);
 	}
@@ -2148,6 +2188,7 @@ static int Lua_Secondary_Side_Set_Empty(lua_State *L)
 
 static int Lua_Secondary_Side_Set_Light(lua_State *L)
 {
+	world_changed(get_side_data(Lua_Secondary_Side::Index(L, 1)));
 	short light_index;
 	if (lua_isnumber(L, 2))
 	{
@@ -2166,6 +2207,7 @@ static int Lua_Secondary_Side_Set_Light(lua_State *L)
 static int Lua_Secondary_Side_Set_Texture_Index(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Secondary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_index: incorrect argument type");
 
@@ -2181,6 +2223,7 @@ static int Lua_Secondary_Side_Set_Texture_Index(lua_State *L)
 static int Lua_Secondary_Side_Set_Texture_X(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Secondary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_x: incorrect argument type");
 
@@ -2191,6 +2234,7 @@ static int Lua_Secondary_Side_Set_Texture_X(lua_State *L)
 static int Lua_Secondary_Side_Set_Texture_Y(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Secondary_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_y: incorrect argument type");
 
@@ -2201,6 +2245,7 @@ static int Lua_Secondary_Side_Set_Texture_Y(lua_State *L)
 static int Lua_Secondary_Side_Set_Transfer_Mode(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Secondary_Side::Index(L, 1));
+	world_changed(side);
 	side->secondary_transfer_mode = Lua_TransferMode::ToIndex(L, 2);
 	return 0;
 }
@@ -2277,6 +2322,7 @@ static int Lua_Transparent_Side_Set_Collection(lua_State *L)
 	short collection_index = Lua_Collection::ToIndex(L, 2);
 
 	side_data *side = get_side_data(side_index);
+	world_changed(side);
 	side->transparent_texture.texture = BUILD_DESCRIPTOR(collection_index, GET_DESCRIPTOR_SHAPE(side->transparent_texture.texture));
 	update_line_redundancy(side->line_index);
 	return 0;
@@ -2291,6 +2337,7 @@ static int Lua_Transparent_Side_Set_Empty(lua_State *L)
 	if (lua_toboolean(L, 2))
 	{
 		side_data *side = get_side_data(side_index);
+		world_changed(side);
 		side->transparent_texture.texture = UNONE;
 		update_line_redundancy(side->line_index);
 	}
@@ -2299,6 +2346,7 @@ static int Lua_Transparent_Side_Set_Empty(lua_State *L)
 
 static int Lua_Transparent_Side_Set_Light(lua_State *L)
 {
+	world_changed(get_side_data(Lua_Transparent_Side::Index(L, 1)));
 	short light_index;
 	if (lua_isnumber(L, 2))
 	{
@@ -2318,6 +2366,7 @@ static int Lua_Transparent_Side_Set_Light(lua_State *L)
 static int Lua_Transparent_Side_Set_Texture_Index(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Transparent_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_index: incorrect argument type");
 
@@ -2333,6 +2382,7 @@ static int Lua_Transparent_Side_Set_Texture_Index(lua_State *L)
 static int Lua_Transparent_Side_Set_Texture_X(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Transparent_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_x: incorrect argument type");
 
@@ -2343,6 +2393,7 @@ static int Lua_Transparent_Side_Set_Texture_X(lua_State *L)
 static int Lua_Transparent_Side_Set_Texture_Y(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Transparent_Side::Index(L, 1));
+	world_changed(side);
 	if (!lua_isnumber(L, 2))
 		return luaL_error(L, "texture_y: incorrect argument type");
 
@@ -2353,6 +2404,7 @@ static int Lua_Transparent_Side_Set_Texture_Y(lua_State *L)
 static int Lua_Transparent_Side_Set_Transfer_Mode(lua_State *L)
 {
 	side_data *side = get_side_data(Lua_Transparent_Side::Index(L, 1));
+	world_changed(side);
 	side->transparent_transfer_mode = Lua_TransferMode::ToIndex(L, 2);
 	return 0;
 }
@@ -2491,6 +2543,7 @@ static int Lua_Side_Set_Ambient_Delta(lua_State* L)
 		return luaL_error(L, "ambient_delta: incorrect argument type");
 
 	auto side = get_side_data(Lua_Side::Index(L, 1));
+	world_changed(side);
 	side->ambient_delta = static_cast<int32_t>(lua_tonumber(L, 2) * FIXED_ONE);
 	return 1;
 }
@@ -2501,6 +2554,7 @@ static int Lua_Side_Set_Control_Panel(lua_State *L)
 		return luaL_error(L, "control_panel: incorrect argument type");
 	
 	side_data *side = get_side_data(Lua_Side::Index(L, 1));
+	world_changed(side);
 
 	if (lua_toboolean(L, 2) != (side->flags & _side_is_control_panel))
 	{
@@ -2566,6 +2620,7 @@ int Lua_Sides_New(lua_State *L)
 		return luaL_error(L, "new: side already exists");
 	
 	Lua_Side::Push(L, new_side(polygon_index, line_index));
+	interpolated_world_polygon_changed(polygon_index);
 	return 1;
 }
 
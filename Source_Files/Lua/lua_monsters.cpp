@@ -29,6 +29,8 @@ LUA_MONSTERS.CPP
 #include <functional>
 
 #include "flood_map.h"
+#include "collision_grid.h"
+#include "interpolated_world.h"
 #include "monsters.h"
 #include "player.h"
 
@@ -830,6 +832,8 @@ int Lua_Monster_Position(lua_State *L)
 		remove_object_from_polygon_object_list(monster->object_index);
 		add_object_to_polygon_object_list(monster->object_index, polygon_index);
 	}
+	move_object_in_collision_grid(monster->object_index);
+	interpolated_world_object_changed(monster->object_index);
 	return 0;
 }
 		
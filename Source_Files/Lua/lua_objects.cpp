@@ -28,6 +28,8 @@ LUA_OBJECTS.CPP
 #include "items.h"
 #include "monsters.h"
 #include "scenery.h"
+#include "collision_grid.h"
+#include "interpolated_world.h"
 #include "player.h"
 #define DONT_REPEAT_DEFINITIONS
 #include "item_definitions.h"
@@ -185,6 +187,8 @@ int lua_object_position(lua_State *L)
 		remove_object_from_polygon_object_list(object_index);
 		add_object_to_polygon_object_list(object_index, polygon_index);
 	}
+	move_object_in_collision_grid(object_index);
+	interpolated_world_object_changed(object_index);
 
 	return 0;
 }
@@ -282,6 +286,8 @@ int Lua_Effect_Position(lua_State* L)
 		remove_object_from_polygon_object_list(effect->object_index);
 		add_object_to_polygon_object_list(effect->object_index, polygon_index);
 	}
+	move_object_in_collision_grid(effect->object_index);
+	interpolated_world_object_changed(effect->object_index);
 
 	return 0;
 	
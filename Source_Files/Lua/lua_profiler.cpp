@@ -0,0 +1,462 @@
+/*
+LUA_PROFILER.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Measures where Lua time goes
+*/
+
+#include "lua_profiler.h"
+
+#include "Console.h"
+#include "FileHandler.h"
+#include "Logging.h"
+#include "map.h"
+#include "screen.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <vector>
+
+enum {
+	DEFAULT_SAMPLE_INSTRUCTIONS= 1000,
+	MAXIMUM_SAMPLED_STACK_DEPTH= 32,
+	REPORTED_TRIGGERS= 5,
+	REPORTED_STACKS= 3,
+	REPORTED_STACK_FRAMES= 3
+};
+
+struct trigger_profile
+{
+	uint64_t calls= 0;
+	uint64_t microseconds= 0;
+	uint64_t maximum_microseconds= 0;
+};
+
+struct state_profile
+{
+	std::map<std::string, trigger_profile> triggers;
+	std::map<std::string, uint64_t> stacks; // frames outermost first, separated by ';'
+	uint64_t samples= 0;
+};
+
+// states with the same name (every solo script, say, or one level's script after
+// another) share a profile
+static std::map<std::string, state_profile> profiles;
+static std::map<lua_State *, std::string> state_names;
+
+static bool profiling= false;
+static int sample_instructions= DEFAULT_SAMPLE_INSTRUCTIONS;
+static double budget_milliseconds= 0;
+
+static uint64_t tick_microseconds= 0; // so far this tick
+static bool tick_had_lua= false;
+static int ticks_since_warning= TICKS_PER_SECOND;
+
+struct tick_profile
+{
+	uint64_t ticks= 0;
+	uint64_t microseconds= 0;
+	uint64_t maximum_microseconds= 0;
+	uint64_t ticks_over_budget= 0;
+};
+static tick_profile tick_totals;
+
+static uint64_t now_microseconds()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double milliseconds(uint64_t microseconds)
+{
+	return microseconds / 1000.0;
+}
+
+static std::string describe_frame(lua_Debug& frame)
+{
+	std::ostringstream s;
+	s << (frame.name ? frame.name : (strcmp(frame.what, "main") == 0 ? "main chunk" : "?"));
+	if (strcmp(frame.what, "C") == 0)
+		s << " [C]";
+	else
+		s << " (" << frame.short_src << ":" << frame.linedefined << ")";
+	return s.str();
+}
+
+static void sample_hook(lua_State *L, lua_Debug *)
+{
+	// profiling stopped while this state (or a coroutine that inherited the hook) was
+	// still hooked; L_Profile_Begin() only unhooks the states it's called on
+	if (!profiling)
+	{
+		lua_sethook(L, 0, 0, 0);
+		return;
+	}
+
+	// coroutines inherit the hook, so find the state they belong to
+	lua_rawgeti(L, LUA_REGISTRYINDEX, LUA_RIDX_MAINTHREAD);
+	lua_State *main_thread= lua_tothread(L, -1);
+	lua_pop(L, 1);
+
+	auto it= state_names.find(main_thread);
+	if (it == state_names.end())
+		return;
+
+	std::vector<std::string> frames;
+	lua_Debug frame;
+	for (int level= 0; level < MAXIMUM_SAMPLED_STACK_DEPTH && lua_getstack(L, level, &frame); ++level)
+	{
+		lua_getinfo(L, "Sn", &frame);
+		frames.push_back(describe_frame(frame));
+	}
+
+	std::string stack;
+	for (auto frame_it= frames.rbegin(); frame_it != frames.rend(); ++frame_it)
+	{
+		if (!stack.empty())
+			stack += ';';
+		stack += *frame_it;
+	}
+
+	state_profile& profile= profiles[it->second];
+	++profile.stacks[stack];
+	++profile.samples;
+}
+
+void L_Profile_Name_State(lua_State *L, const std::string& name)
+{
+	state_names[L]= name;
+}
+
+void L_Profile_Forget_State(lua_State *L)
+{
+	state_names.erase(L);
+}
+
+uint64_t L_Profile_Begin(lua_State *L)
+{
+	lua_Hook hook= lua_gethook(L);
+	if (profiling && (hook != sample_hook || lua_gethookcount(L) != sample_instructions))
+		lua_sethook(L, sample_hook, LUA_MASKCOUNT, sample_instructions);
+	else if (!profiling && hook == sample_hook)
+		lua_sethook(L, 0, 0, 0);
+
+	if (!profiling && budget_milliseconds <= 0)
+		return 0;
+
+	return now_microseconds() + 1;
+}
+
+void L_Profile_End(lua_State *L, const char *what, uint64_t begin, bool outermost)
+{
+	uint64_t microseconds= now_microseconds() + 1 - begin;
+
+	if (outermost)
+	{
+		tick_microseconds+= microseconds;
+		tick_had_lua= true;
+	}
+
+	if (!profiling)
+		return;
+
+	auto it= state_names.find(L);
+	trigger_profile& trigger= profiles[it == state_names.end() ? std::string("Lua") : it->second].triggers[what];
+	++trigger.calls;
+	trigger.microseconds+= microseconds;
+	trigger.maximum_microseconds= std::max(trigger.maximum_microseconds, microseconds);
+}
+
+void L_Profile_Tick()
+{
+	if (ticks_since_warning < TICKS_PER_SECOND)
+		++ticks_since_warning;
+
+	if (!tick_had_lua)
+		return;
+
+	if (budget_milliseconds > 0 && milliseconds(tick_microseconds) > budget_milliseconds)
+	{
+		logWarning("Lua took %.2f ms in one tick, over its %.2f ms budget", milliseconds(tick_microseconds), budget_milliseconds);
+
+		// don't drown the screen in them
+		if (ticks_since_warning >= TICKS_PER_SECOND)
+		{
+			screen_printf("Lua took %.2f ms in one tick, over its %.2f ms budget", milliseconds(tick_microseconds), budget_milliseconds);
+			ticks_since_warning= 0;
+		}
+
+		if (profiling)
+			++tick_totals.ticks_over_budget;
+	}
+
+	if (profiling)
+	{
+		++tick_totals.ticks;
+		tick_totals.microseconds+= tick_microseconds;
+		tick_totals.maximum_microseconds= std::max(tick_totals.maximum_microseconds, tick_microseconds);
+	}
+
+	tick_microseconds= 0;
+	tick_had_lua= false;
+}
+
+static void reset_profile()
+{
+	profiles.clear();
+	tick_totals= tick_profile();
+}
+
+static std::vector<std::pair<std::string, uint64_t>> sorted_stacks(const state_profile& profile)
+{
+	std::vector<std::pair<std::string, uint64_t>> stacks(profile.stacks.begin(), profile.stacks.end());
+	std::stable_sort(stacks.begin(), stacks.end(), [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+		return a.second > b.second;
+	});
+	return stacks;
+}
+
+// the last few frames of a stack, innermost first
+static std::string innermost_frames(const std::string& stack)
+{
+	std::vector<std::string> frames;
+	std::string::size_type start= 0;
+	for (std::string::size_type end; (end= stack.find(';', start)) != std::string::npos; start= end + 1)
+		frames.push_back(stack.substr(start, end - start));
+	frames.push_back(stack.substr(start));
+
+	std::string innermost;
+	for (int i= 0; i < REPORTED_STACK_FRAMES && i < static_cast<int>(frames.size()); ++i)
+	{
+		if (i)
+			innermost+= " <- ";
+		innermost+= frames[frames.size() - 1 - i];
+	}
+	return innermost;
+}
+
+static void report_profile()
+{
+	if (tick_totals.ticks)
+	{
+		screen_printf("%llu ticks with Lua: %.2f ms each on average, %.2f ms at most",
+					  static_cast<unsigned long long>(tick_totals.ticks),
+					  milliseconds(tick_totals.microseconds) / tick_totals.ticks,
+					  milliseconds(tick_totals.maximum_microseconds));
+	}
+
+	struct trigger_entry
+	{
+		const std::string *state;
+		const std::string *trigger;
+		const trigger_profile *profile;
+	};
+	std::vector<trigger_entry> triggers;
+	for (auto& state : profiles)
+	{
+		for (auto& trigger : state.second.triggers)
+			triggers.push_back({&state.first, &trigger.first, &trigger.second});
+	}
+
+	if (triggers.empty())
+	{
+		screen_printf("No Lua profile yet");
+		return;
+	}
+
+	std::stable_sort(triggers.begin(), triggers.end(), [](const trigger_entry& a, const trigger_entry& b) {
+		return a.profile->microseconds > b.profile->microseconds;
+	});
+
+	for (size_t i= 0; i < triggers.size() && i < REPORTED_TRIGGERS; ++i)
+	{
+		const trigger_profile& profile= *triggers[i].profile;
+		screen_printf("%s %s: %llu calls, %.2f ms, %.3f ms at most",
+					  triggers[i].state->c_str(), triggers[i].trigger->c_str(),
+					  static_cast<unsigned long long>(profile.calls),
+					  milliseconds(profile.microseconds),
+					  milliseconds(profile.maximum_microseconds));
+	}
+
+	for (auto& state : profiles)
+	{
+		if (!state.second.samples)
+			continue;
+
+		auto stacks= sorted_stacks(state.second);
+		for (size_t i= 0; i < stacks.size() && i < REPORTED_STACKS; ++i)
+		{
+			screen_printf("%s %.0f%%: %s", state.first.c_str(),
+						  100.0 * stacks[i].second / state.second.samples, innermost_frames(stacks[i].first).c_str());
+		}
+	}
+}
+
+static std::string json_string(const std::string& s)
+{
+	std::ostringstream out;
+	out << '"';
+	for (unsigned char c : s)
+	{
+		if (c == '"' || c == '\\')
+			out << '\\' << c;
+		else if (c < 0x20)
+			out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec << std::setfill(' ');
+		else
+			out << c;
+	}
+	out << '"';
+	return out.str();
+}
+
+static bool dump_profile(FileSpecifier& file)
+{
+	std::ostringstream json;
+	json << std::setprecision(6)
+		 << "{\n  \"sample_instructions\": " << sample_instructions << ",\n"
+		 << "  \"budget_ms\": " << budget_milliseconds << ",\n"
+		 << "  \"ticks\": " << tick_totals.ticks << ",\n"
+		 << "  \"ticks_over_budget\": " << tick_totals.ticks_over_budget << ",\n"
+		 << "  \"total_tick_ms\": " << milliseconds(tick_totals.microseconds) << ",\n"
+		 << "  \"max_tick_ms\": " << milliseconds(tick_totals.maximum_microseconds) << ",\n"
+		 << "  \"states\": [";
+
+	bool first_state= true;
+	for (auto& state : profiles)
+	{
+		json << (first_state ? "\n" : ",\n")
+			 << "    {\n      \"name\": " << json_string(state.first) << ",\n"
+			 << "      \"triggers\": [";
+		first_state= false;
+
+		bool first= true;
+		for (auto& trigger : state.second.triggers)
+		{
+			json << (first ? "\n" : ",\n")
+				 << "        { \"name\": " << json_string(trigger.first)
+				 << ", \"calls\": " << trigger.second.calls
+				 << ", \"total_ms\": " << milliseconds(trigger.second.microseconds)
+				 << ", \"max_ms\": " << milliseconds(trigger.second.maximum_microseconds) << " }";
+			first= false;
+		}
+
+		json << "\n      ],\n      \"samples\": " << state.second.samples << ",\n"
+			 << "      \"stacks\": [";
+
+		first= true;
+		for (auto& stack : sorted_stacks(state.second))
+		{
+			json << (first ? "\n" : ",\n")
+				 << "        { \"stack\": " << json_string(stack.first) << ", \"samples\": " << stack.second << " }";
+			first= false;
+		}
+
+		json << "\n      ]\n    }";
+	}
+	json << "\n  ]\n}\n";
+
+	OpenedFile f;
+	if (!file.OpenForWritingText(f))
+		return false;
+
+	std::string s= json.str();
+	return f.Write(static_cast<int32>(s.size()), const_cast<char *>(s.data()));
+}
+
+struct start_profiling
+{
+	void operator() (const std::string& arg) const {
+		int instructions= arg.empty() ? DEFAULT_SAMPLE_INSTRUCTIONS : atoi(arg.c_str());
+		if (instructions <= 0)
+		{
+			screen_printf("usage: lua_profile start [<instructions between samples>]");
+			return;
+		}
+
+		sample_instructions= instructions;
+		profiling= true;
+		screen_printf("Profiling Lua, sampling every %d instructions", sample_instructions);
+	}
+};
+
+struct stop_profiling
+{
+	void operator() (const std::string&) const {
+		profiling= false;
+		screen_printf("Stopped profiling Lua");
+	}
+};
+
+struct reset_profiling
+{
+	void operator() (const std::string&) const {
+		reset_profile();
+		screen_printf("Cleared the Lua profile");
+	}
+};
+
+struct report_profiling
+{
+	void operator() (const std::string&) const {
+		report_profile();
+	}
+};
+
+struct dump_profiling
+{
+	void operator() (const std::string& arg) const {
+		FileSpecifier file;
+		file.SetToLocalDataDir();
+		file+= arg.empty() ? std::string("lua_profile.json") : arg;
+		if (dump_profile(file))
+			screen_printf("Saved %s", utf8_to_mac_roman(file.GetPath()).c_str());
+		else
+			screen_printf("An error occurred while saving the Lua profile");
+	}
+};
+
+struct set_budget
+{
+	void operator() (const std::string& arg) const {
+		if (arg.empty())
+		{
+			screen_printf("Lua budget is %.2f ms per tick", budget_milliseconds);
+			return;
+		}
+
+		budget_milliseconds= std::max(0.0, atof(arg.c_str()));
+		if (budget_milliseconds > 0)
+			screen_printf("Warning when Lua takes over %.2f ms in a tick", budget_milliseconds);
+		else
+			screen_printf("Lua budget off");
+	}
+};
+
+void L_Register_Profiler_Commands()
+{
+	CommandParser profileParser;
+	profileParser.register_command("start", start_profiling());
+	profileParser.register_command("stop", stop_profiling());
+	profileParser.register_command("reset", reset_profiling());
+	profileParser.register_command("report", report_profiling());
+	profileParser.register_command("dump", dump_profiling());
+	profileParser.register_command("budget", set_budget());
+	Console::instance()->register_command("lua_profile", profileParser);
+}
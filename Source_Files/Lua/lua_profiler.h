@@ -0,0 +1,59 @@
+#ifndef __LUA_PROFILER_H
+#define __LUA_PROFILER_H
+
+/*
+LUA_PROFILER.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Measures where Lua time goes: wall time and calls for each trigger of each script, the
+	Lua time of each tick, and call stacks sampled every so many Lua instructions.  Driven
+	from the console:
+
+	.lua_profile start [<instructions>]	start profiling, sampling every <instructions>
+	.lua_profile stop
+	.lua_profile reset
+	.lua_profile report			print the busiest triggers and stacks
+	.lua_profile dump [<file>]		write everything as JSON to the local data directory
+	.lua_profile budget <ms>		warn whenever a tick's Lua takes longer; 0 turns it off
+*/
+
+#include "cseries.h"
+
+#include <string>
+
+extern "C"
+{
+#include "lua.h"
+}
+
+void L_Register_Profiler_Commands();
+
+// for scripts run on L to be profiled as name, until L is closed
+void L_Profile_Name_State(lua_State *L, const std::string& name);
+void L_Profile_Forget_State(lua_State *L);
+
+// nonzero when profiling or keeping to a budget; pass it to L_Profile_End() after running
+// what in L.  outermost is false for calls made while other Lua code was already running,
+// so they aren't counted twice towards the tick
+uint64_t L_Profile_Begin(lua_State *L);
+void L_Profile_End(lua_State *L, const char *what, uint64_t begin, bool outermost);
+
+// at the start of each tick, closes off the last one
+void L_Profile_Tick();
+
+#endif
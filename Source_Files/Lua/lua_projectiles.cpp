@@ -29,6 +29,8 @@ LUA_MONSTERS.CPP
 
 #include "dynamic_limits.h"
 #include "map.h"
+#include "collision_grid.h"
+#include "interpolated_world.h"
 #include "monsters.h"
 #include "player.h"
 #include "projectiles.h"
@@ -277,6 +279,8 @@ int Lua_Projectile_Position(lua_State *L)
 		remove_object_from_polygon_object_list(projectile->object_index);
 		add_object_to_polygon_object_list(projectile->object_index, polygon_index);
 	}
+	move_object_in_collision_grid(projectile->object_index);
+	interpolated_world_object_changed(projectile->object_index);
 	return 0;
 }
 
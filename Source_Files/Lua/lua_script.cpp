@@ -118,6 +118,7 @@ extern "C"
 #include "lua_monsters.h"
 #include "lua_objects.h"
 #include "lua_player.h"
+#include "lua_profiler.h"
 #include "lua_projectiles.h"
 #include "lua_saved_objects.h"
 #include "lua_serialize.h"
@@ -185,15 +186,76 @@ void* L_Persistent_Table_Key()
 std::map<int, std::string> PassedLuaState;
 std::map<int, std::string> SavedLuaState;
 
+enum // Lua triggers
+{
+	_lua_trigger_init,
+	_lua_trigger_idle,
+	_lua_trigger_cleanup,
+	_lua_trigger_postidle,
+	_lua_trigger_start_refuel,
+	_lua_trigger_end_refuel,
+	_lua_trigger_tag_switch,
+	_lua_trigger_light_switch,
+	_lua_trigger_platform_switch,
+	_lua_trigger_projectile_switch,
+	_lua_trigger_terminal_enter,
+	_lua_trigger_terminal_exit,
+	_lua_trigger_pattern_buffer,
+	_lua_trigger_got_item,
+	_lua_trigger_light_activated,
+	_lua_trigger_platform_activated,
+	_lua_trigger_player_revived,
+	_lua_trigger_player_killed,
+	_lua_trigger_monster_killed,
+	_lua_trigger_monster_damaged,
+	_lua_trigger_player_damaged,
+	_lua_trigger_projectile_detonated,
+	_lua_trigger_projectile_created,
+	_lua_trigger_item_created,
+	_lua_trigger_calculate_level_completion_state,
+	_lua_trigger_monster_kamikazed,
+	NUMBER_OF_LUA_TRIGGERS
+};
+
+static const char *trigger_names[NUMBER_OF_LUA_TRIGGERS] = {
+	"init",
+	"idle",
+	"cleanup",
+	"postidle",
+	"start_refuel",
+	"end_refuel",
+	"tag_switch",
+	"light_switch",
+	"platform_switch",
+	"projectile_switch",
+	"terminal_enter",
+	"terminal_exit",
+	"pattern_buffer",
+	"got_item",
+	"light_activated",
+	"platform_activated",
+	"player_revived",
+	"player_killed",
+	"monster_killed",
+	"monster_damaged",
+	"player_damaged",
+	"projectile_detonated",
+	"projectile_created",
+	"item_created",
+	"calculate_level_completion_state",
+	"monster_kamikazed",
+};
+
 class LuaState : public LuaMutabilityInterface
 {
 	friend bool CollectLuaStats(std::map<std::string, std::string>&, std::map<std::string, std::string>&);
 public:
-	LuaState() : running_(false), num_scripts_(0) {
+	LuaState() : running_(false), num_scripts_(0), lua_calls_(0), triggers_checked_(0), triggers_defined_(0), current_trigger_(0) {
 		state_.reset(luaL_newstate(), lua_close);
 	}
 
 	virtual ~LuaState() {
+		L_Profile_Forget_State(State());
 	}
 
 public:
@@ -204,6 +266,7 @@ public:
 	bool Run();
 	void Stop() { running_ = false; }
 	bool Matches(lua_State *state) { return state == State(); }
+	void SetProfileName(const std::string& name) { L_Profile_Name_State(State(), name); }
 	void MarkCollections(std::set<short>* collections);
 	bool ExecuteCommand(const std::string& line);
 	std::string SavePassed();
@@ -256,8 +319,9 @@ public:
 	bool world_mutable() const override { return true; }
 
 protected:
-	bool GetTrigger(const char *trigger);
+	bool GetTrigger(int trigger);
 	void CallTrigger(int numArgs = 0);
+	int CallLua(int numArgs, int numResults, const char *what);
 
 	virtual void RegisterFunctions();
 	virtual void LoadCompatibility();
@@ -307,6 +371,14 @@ public:
 private:
 	bool running_;
 	int num_scripts_;
+
+	// only Lua code can change Triggers, so whatever GetTrigger() finds stays true until
+	// some runs again; until then, triggers the script doesn't define cost one test
+	int lua_calls_; // Lua code running on this state, counting nested calls
+	uint32 triggers_checked_; // bit for each trigger looked up since Lua code last ran
+	uint32 triggers_defined_; // ...and for each of those that was a function
+
+	int current_trigger_; // the last one GetTrigger() found, for the profiler
 };
 
 typedef LuaState EmbeddedLuaState;
@@ -372,11 +444,15 @@ public:
 	}
 };
 
-bool LuaState::GetTrigger(const char* trigger)
+bool LuaState::GetTrigger(int trigger)
 {
 	if (!running_)
 		return false;
 
+	uint32 bit = 1u << trigger;
+	if (triggers_checked_ & bit && !(triggers_defined_ & bit))
+		return false;
+
 	lua_getglobal(State(), "Triggers");
 	if (!lua_istable(State(), -1))
 	{
@@ -384,27 +460,62 @@ bool LuaState::GetTrigger(const char* trigger)
 		return false;
 	}
 
-	lua_pushstring(State(), trigger);
-	lua_gettable(State(), -2);
-	if (!lua_isfunction(State(), -1))
+	// don't remember the answer while Lua code is running, since it could change Triggers
+	// before we're asked again; nor if a metatable could make it depend on anything at all
+	bool cacheable = lua_calls_ == 0;
+	if (cacheable && lua_getmetatable(State(), -1))
+	{
+		lua_pop(State(), 1);
+		cacheable = false;
+	}
+
+	lua_getfield(State(), -1, trigger_names[trigger]);
+	bool defined = lua_isfunction(State(), -1);
+	if (cacheable)
+	{
+		triggers_checked_ |= bit;
+		if (defined)
+			triggers_defined_ |= bit;
+	}
+
+	if (!defined)
 	{
 		lua_pop(State(), 2);
 		return false;
 	}
 
 	lua_remove(State(), -2);
+	current_trigger_ = trigger;
 	return true;
 }
 
+int LuaState::CallLua(int numArgs, int numResults, const char *what)
+{
+	static_assert(NUMBER_OF_LUA_TRIGGERS <= 32, "too many triggers for the trigger cache");
+
+	// forget what we know about Triggers both before the script could change it and after
+	// it's had the chance
+	triggers_checked_ = triggers_defined_ = 0;
+	uint64_t profile_begin = L_Profile_Begin(State());
+	++lua_calls_;
+	int result = lua_pcall(State(), numArgs, numResults, 0);
+	--lua_calls_;
+	if (profile_begin)
+		L_Profile_End(State(), what, profile_begin, lua_calls_ == 0);
+	triggers_checked_ = triggers_defined_ = 0;
+
+	return result;
+}
+
 void LuaState::CallTrigger(int numArgs)
 {
-	if (lua_pcall(State(), numArgs, 0, 0) == LUA_ERRRUN)
+	if (CallLua(numArgs, 0, trigger_names[current_trigger_]) == LUA_ERRRUN)
 		L_Error(lua_tostring(State(), -1));
 }
 
 void LuaState::Init(bool fRestoringSaved)
 {
-	if (GetTrigger("init"))
+	if (GetTrigger(_lua_trigger_init))
 	{
 		lua_pushboolean(State(), fRestoringSaved);
 		CallTrigger(1);
@@ -413,25 +524,25 @@ void LuaState::Init(bool fRestoringSaved)
 
 void LuaState::Idle()
 {
-	if (GetTrigger("idle"))
+	if (GetTrigger(_lua_trigger_idle))
 		CallTrigger();
 }
 
 void LuaState::Cleanup()
 {
-	if (GetTrigger("cleanup"))
+	if (GetTrigger(_lua_trigger_cleanup))
 		CallTrigger();
 }
 
 void LuaState::PostIdle()
 {
-	if (GetTrigger("postidle"))
+	if (GetTrigger(_lua_trigger_postidle))
 		CallTrigger();
 }
 
 void LuaState::StartRefuel(short type, short player_index, short panel_side_index)
 {
-	if (GetTrigger("start_refuel"))
+	if (GetTrigger(_lua_trigger_start_refuel))
 	{
 		Lua_ControlPanelClass::Push(State(), type);
 		Lua_Player::Push(State(), player_index);
@@ -442,7 +553,7 @@ void LuaState::StartRefuel(short type, short player_index, short panel_side_inde
 
 void LuaState::EndRefuel(short type, short player_index, short panel_side_index)
 {
-	if (GetTrigger("end_refuel"))
+	if (GetTrigger(_lua_trigger_end_refuel))
 	{
 		Lua_ControlPanelClass::Push(State(), type);
 		Lua_Player::Push(State(), player_index);
@@ -453,7 +564,7 @@ void LuaState::EndRefuel(short type, short player_index, short panel_side_index)
 
 void LuaState::TagSwitch(short tag, short player_index, short side_index)
 {
-	if (GetTrigger("tag_switch"))
+	if (GetTrigger(_lua_trigger_tag_switch))
 	{
 		Lua_Tag::Push(State(), tag);
 		Lua_Player::Push(State(), player_index);
@@ -464,7 +575,7 @@ void LuaState::TagSwitch(short tag, short player_index, short side_index)
 
 void LuaState::LightSwitch(short light, short player_index, short side_index)
 {
-	if (GetTrigger("light_switch"))
+	if (GetTrigger(_lua_trigger_light_switch))
 	{
 		Lua_Light::Push(State(), light);
 		Lua_Player::Push(State(), player_index);
@@ -475,7 +586,7 @@ void LuaState::LightSwitch(short light, short player_index, short side_index)
 
 void LuaState::PlatformSwitch(short platform, short player_index, short side_index)
 {
-	if (GetTrigger("platform_switch"))
+	if (GetTrigger(_lua_trigger_platform_switch))
 	{
 		Lua_Polygon::Push(State(), platform);
 		Lua_Player::Push(State(), player_index);
@@ -486,7 +597,7 @@ void LuaState::PlatformSwitch(short platform, short player_index, short side_ind
 
 void LuaState::ProjectileSwitch(short side_index, short projectile_index)
 {
-	if (GetTrigger("projectile_switch"))
+	if (GetTrigger(_lua_trigger_projectile_switch))
 	{
 		Lua_Projectile::Push(State(), projectile_index);
 		Lua_Side::Push(State(), side_index);
@@ -496,7 +607,7 @@ void LuaState::ProjectileSwitch(short side_index, short projectile_index)
 
 void LuaState::TerminalEnter(short terminal_id, short player_index)
 {
-	if (GetTrigger("terminal_enter"))
+	if (GetTrigger(_lua_trigger_terminal_enter))
 	{
 		Lua_Terminal::Push(State(), terminal_id);
 		Lua_Player::Push(State(), player_index);
@@ -506,7 +617,7 @@ void LuaState::TerminalEnter(short terminal_id, short player_index)
 
 void LuaState::TerminalExit(short terminal_id, short player_index)
 {
-	if (GetTrigger("terminal_exit"))
+	if (GetTrigger(_lua_trigger_terminal_exit))
 	{
 		Lua_Terminal::Push(State(), terminal_id);
 		Lua_Player::Push(State(), player_index);
@@ -516,7 +627,7 @@ void LuaState::TerminalExit(short terminal_id, short player_index)
 
 void LuaState::PatternBuffer(short side_index, short player_index)
 {
-	if (GetTrigger("pattern_buffer"))
+	if (GetTrigger(_lua_trigger_pattern_buffer))
 	{
 		Lua_Side::Push(State(), side_index);
 		Lua_Player::Push(State(), player_index);
@@ -526,7 +637,7 @@ void LuaState::PatternBuffer(short side_index, short player_index)
 
 void LuaState::GotItem(short type, short player_index)
 {
-	if (GetTrigger("got_item"))
+	if (GetTrigger(_lua_trigger_got_item))
 	{
 		Lua_ItemType::Push(State(), type);
 		Lua_Player::Push(State(), player_index);
@@ -536,7 +647,7 @@ void LuaState::GotItem(short type, short player_index)
 
 void LuaState::LightActivated(short index)
 {
-	if (GetTrigger("light_activated"))
+	if (GetTrigger(_lua_trigger_light_activated))
 	{
 		Lua_Light::Push(State(), index);
 		CallTrigger(1);
@@ -545,7 +656,7 @@ void LuaState::LightActivated(short index)
 
 void LuaState::PlatformActivated(short index)
 {
-	if (GetTrigger("platform_activated"))
+	if (GetTrigger(_lua_trigger_platform_activated))
 	{
 		Lua_Polygon::Push(State(), index);
 		CallTrigger(1);
@@ -554,7 +665,7 @@ void LuaState::PlatformActivated(short index)
 
 void LuaState::PlayerRevived (short player_index)
 {
-	if (GetTrigger("player_revived"))
+	if (GetTrigger(_lua_trigger_player_revived))
 	{
 		Lua_Player::Push(State(), player_index);
 		CallTrigger(1);
@@ -563,7 +674,7 @@ void LuaState::PlayerRevived (short player_index)
 
 void LuaState::PlayerKilled (short player_index, short aggressor_player_index, short action, short projectile_index)
 {
-	if (GetTrigger("player_killed"))
+	if (GetTrigger(_lua_trigger_player_killed))
 	{
 		Lua_Player::Push(State(), player_index);
 
@@ -584,7 +695,7 @@ void LuaState::PlayerKilled (short player_index, short aggressor_player_index, s
 
 void LuaState::MonsterKilled (short monster_index, short aggressor_player_index, short projectile_index)
 {
-	if (GetTrigger("monster_killed"))
+	if (GetTrigger(_lua_trigger_monster_killed))
 	{
 		Lua_Monster::Push(State(), monster_index);
 		if (aggressor_player_index != -1)
@@ -603,7 +714,7 @@ void LuaState::MonsterKilled (short monster_index, short aggressor_player_index,
 
 void LuaState::MonsterDamaged(short monster_index, short aggressor_monster_index, int16 damage_type, short damage_amount, short projectile_index)
 {
-	if (GetTrigger("monster_damaged"))
+	if (GetTrigger(_lua_trigger_monster_damaged))
 	{
 		Lua_Monster::Push(State(), monster_index);
 		if (aggressor_monster_index != -1) 
@@ -626,7 +737,7 @@ void LuaState::MonsterDamaged(short monster_index, short aggressor_monster_index
 
 void LuaState::PlayerDamaged (short player_index, short aggressor_player_index, short aggressor_monster_index, int16 damage_type, short damage_amount, short projectile_index)
 {
-	if (GetTrigger("player_damaged"))
+	if (GetTrigger(_lua_trigger_player_damaged))
 	{
 		Lua_Player::Push(State(), player_index);
 
@@ -654,7 +765,7 @@ void LuaState::PlayerDamaged (short player_index, short aggressor_player_index,
 
 void LuaState::ProjectileDetonated(short type, short owner_index, short polygon, world_point3d location, uint16_t flags, int16_t obstruction_index, int16_t line_index) 
 {
-	if (GetTrigger("projectile_detonated"))
+	if (GetTrigger(_lua_trigger_projectile_detonated))
 	{
 		Lua_ProjectileType::Push(State(), type);
 		if (owner_index != -1)
@@ -703,7 +814,7 @@ void LuaState::ProjectileDetonated(short type, short owner_index, short polygon,
 
 void LuaState::ProjectileCreated (short projectile_index)
 {
-	if (GetTrigger("projectile_created"))
+	if (GetTrigger(_lua_trigger_projectile_created))
 	{
 		Lua_Projectile::Push(State(), projectile_index);
 		CallTrigger(1);
@@ -712,7 +823,7 @@ void LuaState::ProjectileCreated (short projectile_index)
 
 void LuaState::ItemCreated (short item_index)
 {
-	if (GetTrigger("item_created"))
+	if (GetTrigger(_lua_trigger_item_created))
 	{
 		Lua_Item::Push(State(), item_index);
 		CallTrigger(1);
@@ -721,9 +832,9 @@ void LuaState::ItemCreated (short item_index)
 
 bool LuaState::CalculateCompletionState(short& completion_state)
 {
-	if (GetTrigger("calculate_level_completion_state"))
+	if (GetTrigger(_lua_trigger_calculate_level_completion_state))
 	{
-		if (lua_pcall(State(), 0, 1, 0) == LUA_ERRRUN)
+		if (CallLua(0, 1, trigger_names[_lua_trigger_calculate_level_completion_state]) == LUA_ERRRUN)
 		{
 			L_Error(lua_tostring(State(), -1));
 		}
@@ -736,7 +847,7 @@ bool LuaState::CalculateCompletionState(short& completion_state)
 
 		lua_insert(State(), -2);
 
-		if (lua_pcall(State(), 1, 1, 0) == LUA_ERRRUN)
+		if (CallLua(1, 1, trigger_names[_lua_trigger_calculate_level_completion_state]) == LUA_ERRRUN)
 		{
 			L_Error(lua_tostring(State(), -1));
 		}
@@ -752,7 +863,7 @@ bool LuaState::CalculateCompletionState(short& completion_state)
 
 void LuaState::MonsterKamikazed(short monster_index)
 {
-	if (GetTrigger("monster_kamikazed"))
+	if (GetTrigger(_lua_trigger_monster_kamikazed))
 	{
 		Lua_Monster::Push(State(), monster_index);
 
@@ -924,7 +1035,7 @@ static const char *compatibility_triggers = ""
 void LuaState::LoadCompatibility()
 {
 	luaL_loadbuffer(State(), compatibility_triggers, strlen(compatibility_triggers), "compatibility_triggers");
-	lua_pcall(State(), 0, 0, 0);
+	CallLua(0, 0, "(compatibility triggers)");
 
 	struct lang_def
 	{
@@ -983,7 +1094,7 @@ bool LuaState::Run()
 	// Call 'em
 	for (int i = 0; i < num_scripts_; ++i)
 	{
-		int ret = lua_pcall(State(), 0, LUA_MULTRET, 0);
+		int ret = CallLua(0, LUA_MULTRET, "(loading)");
 		if (ret != 0)
 		{
 			L_Error(lua_tostring(State(), -1));
@@ -1025,7 +1136,7 @@ bool LuaState::ExecuteCommand(const std::string& line)
 	else 
 	{
 		running_ = true;
-		if (lua_pcall(State(), 0, (print_result) ? 1 : 0, 0) != 0)
+		if (CallLua(0, (print_result) ? 1 : 0, "(console)") != 0)
 		{
 			L_Error(lua_tostring(State(), -1));
 			success = false;
@@ -1034,7 +1145,7 @@ bool LuaState::ExecuteCommand(const std::string& line)
 		{
 			lua_getglobal(State(), "tostring");
 			lua_insert(State(), 1);
-			lua_pcall(State(), 1, 1, 0);
+			CallLua(1, 1, "(console)");
 			if (lua_tostring(State(), -1))
 			{
 				screen_printf("%s", lua_tostring(State(), -1));
@@ -1323,6 +1434,7 @@ void UpdateLuaCameras();
 
 void L_Call_Idle()
 {
+	L_Profile_Tick();
 	UpdateLuaCameras();
 	L_Dispatch(std::bind(&LuaState::Idle, std::placeholders::_1));
 }
@@ -1923,20 +2035,6 @@ static state_map::iterator _LoadLuaScript(const char* buffer,
 {
 	assert(script_type >= _embedded_lua_script && script_type <= _achievements_lua_script);
 
-	auto it = states.end();
-	if (script_type == _embedded_lua_script)
-	{
-		it = states.find(script_type);
-	}
-
-	if (it == states.end())
-	{
-		auto state = LuaStateFactory(script_type, write_access);
-		state->Initialize();
-
-		it = states.emplace(std::make_pair(script_type, std::move(state)));
-	}
-
 	const char *desc = "level_script";
 	switch (script_type) {
 		case _embedded_lua_script:
@@ -1956,6 +2054,21 @@ static state_map::iterator _LoadLuaScript(const char* buffer,
 			break;
 	}
 
+	auto it = states.end();
+	if (script_type == _embedded_lua_script)
+	{
+		it = states.find(script_type);
+	}
+
+	if (it == states.end())
+	{
+		auto state = LuaStateFactory(script_type, write_access);
+		state->SetProfileName(desc);
+		state->Initialize();
+
+		it = states.emplace(std::make_pair(script_type, std::move(state)));
+	}
+
 	it->second->Load(buffer, len, desc);
 	return it;
 }
@@ -111,6 +111,14 @@ protected:
 	static instance_t *NewInstance(lua_State *L, index_t index);
 
 	static int _get(lua_State *L);
+
+	// pushes f as a closure that keeps the get methods, set methods and metatable in its
+	// upvalues, so property access doesn't have to find them in the registry every time;
+	// _get and _set fall back to the registry when called from a plain C function
+	static void _push_dispatch_closure(lua_State *L, lua_CFunction f);
+	static void _push_methods(lua_State *L, int upvalue, void (*push_key)(lua_State *));
+	static void _check_instance(lua_State *L);
+	static int _call_method(lua_State *L, int nargs);
 	
 	// registry keys
 	static void _push_get_methods_key(lua_State *L) {
@@ -140,6 +148,26 @@ std::function<bool (index_t)> L_Class<name, index_t>::Valid = always_valid();
 template<char *name, typename index_t>
 void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const luaL_Reg set[], const luaL_Reg metatable[])
 {
+	// register get methods
+	_push_get_methods_key(L);
+	lua_newtable(L);
+
+	// always want index
+	lua_pushcfunction(L, _index);
+	lua_setfield(L, -2, "index");
+
+	if (get)
+		luaL_setfuncs(L, get, 0);
+	lua_settable(L, LUA_REGISTRYINDEX);
+
+	// register set methods
+	_push_set_methods_key(L);
+	lua_newtable(L);
+
+	if (set)
+		luaL_setfuncs(L, set, 0);
+	lua_settable(L, LUA_REGISTRYINDEX);
+
 	// create the metatable itself
 	luaL_newmetatable(L, name);
 
@@ -149,11 +177,11 @@ void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const
 	lua_settable(L, LUA_REGISTRYINDEX);
 
 	// register metatable get
-	lua_pushcfunction(L, _get);
+	_push_dispatch_closure(L, _get);
 	lua_setfield(L, -2, "__index");
 
 	// register metatable set
-	lua_pushcfunction(L, _set);
+	_push_dispatch_closure(L, _set);
 	lua_setfield(L, -2, "__newindex");
 
 	// register metatable tostring
@@ -169,26 +197,6 @@ void L_Class<name, index_t>::Register(lua_State *L, const luaL_Reg get[], const
 	// clear the stack
 	lua_pop(L, 1);
 	
-	// register get methods
-	_push_get_methods_key(L);
-	lua_newtable(L);
-
-	// always want index
-	lua_pushcfunction(L, _index);
-	lua_setfield(L, -2, "index");
-
-	if (get)
-		luaL_setfuncs(L, get, 0);
-	lua_settable(L, LUA_REGISTRYINDEX);
-
-	// register set methods
-	_push_set_methods_key(L);
-	lua_newtable(L);
-
-	if (set)
-		luaL_setfuncs(L, set, 0);
-	lua_settable(L, LUA_REGISTRYINDEX);
-		
 	// register a table for instances
 	_push_instances_key(L);
 	lua_newtable(L);
@@ -366,13 +374,88 @@ int L_Class<name, index_t>::_is(lua_State *L)
 	return 1;
 }
 
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_push_dispatch_closure(lua_State *L, lua_CFunction f)
+{
+	_push_get_methods_key(L);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+	_push_set_methods_key(L);
+	lua_rawget(L, LUA_REGISTRYINDEX);
+	luaL_getmetatable(L, name);
+	lua_pushcclosure(L, f, 3);
+}
+
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_push_methods(lua_State *L, int upvalue, void (*push_key)(lua_State *))
+{
+	if (lua_istable(L, lua_upvalueindex(upvalue)))
+	{
+		lua_pushvalue(L, lua_upvalueindex(upvalue));
+	}
+	else
+	{
+		push_key(L);
+		lua_rawget(L, LUA_REGISTRYINDEX);
+	}
+}
+
+template<char *name, typename index_t>
+void L_Class<name, index_t>::_check_instance(lua_State *L)
+{
+	// comparing against the cached metatable saves luaL_checkudata() a registry lookup by
+	// name; anything that doesn't match goes through it anyway, for the usual error
+	if (lua_getmetatable(L, 1))
+	{
+		bool matches = lua_rawequal(L, -1, lua_upvalueindex(3));
+		lua_pop(L, 1);
+		if (matches)
+			return;
+	}
+
+	luaL_checktype(L, 1, LUA_TUSERDATA);
+	luaL_checkudata(L, 1, name);
+}
+
+template<char *name, typename index_t>
+int L_Class<name, index_t>::_call_method(lua_State *L, int nargs)
+{
+	// the method is on top of the stack, its arguments just below it
+	lua_CFunction f = lua_tocfunction(L, -1);
+	if (f && lua_getupvalue(L, -1, 1))
+	{
+		// a closure might depend on being called properly
+		lua_pop(L, 1);
+		f = 0;
+	}
+
+	if (f)
+	{
+		// call it directly, with the stack looking just as it would had Lua called it; any
+		// error it raises is already reported as being on the script's line, since the
+		// script is what called us
+		lua_pop(L, 1);
+		lua_checkstack(L, LUA_MINSTACK);
+		return f(L);
+	}
+
+	lua_insert(L, -(nargs + 1));
+	if (lua_pcall(L, nargs, 1, 0) == LUA_ERRRUN)
+	{
+		// report the error as being on this line
+		luaL_where(L, 1);
+		lua_pushvalue(L, -2);
+		lua_concat(L, 2);
+		lua_error(L);
+	}
+	return 1;
+}
+
 template<char *name, typename index_t>
 int L_Class<name, index_t>::_get(lua_State *L)
 {
 	if (lua_isstring(L, 2))
 	{
-		luaL_checktype(L, 1, LUA_TUSERDATA);
-		luaL_checkudata(L, 1, name);
+		_check_instance(L);
 		if (!Valid(Index(L, 1)) && strcmp(lua_tostring(L, 2), "valid") != 0 && strcmp(lua_tostring(L, 2), "index") != 0)
 			luaL_error(L, "invalid object");
 
@@ -397,27 +480,17 @@ int L_Class<name, index_t>::_get(lua_State *L)
 		}
 		else
 		{
-			// pop the get table
-			_push_get_methods_key(L);
-			lua_gettable(L, LUA_REGISTRYINDEX);
-
-			// get the function from that table
+			// get the function from the get table
+			_push_methods(L, 1, _push_get_methods_key);
 			lua_pushvalue(L, 2);
-			lua_gettable(L, -2);
-			lua_remove(L, -2);
+			lua_rawget(L, -2);
 		
 			if (lua_isfunction(L, -1))
 			{
 				// execute the function with table as our argument
-				lua_pushvalue(L, 1);
-				if (lua_pcall(L, 1, 1, 0) == LUA_ERRRUN)
-				{
-					// report the error as being on this line
-					luaL_where(L, 1);
-					lua_pushvalue(L, -2);
-					lua_concat(L, 2);
-					lua_error(L);
-				}
+				lua_replace(L, 2);
+				lua_settop(L, 2);
+				return _call_method(L, 1);
 			}
 			else
 			{
@@ -453,8 +526,7 @@ int L_Class<name, index_t>::_new(lua_State *L)
 template<char *name, typename index_t>
 int L_Class<name, index_t>::_set(lua_State *L)
 {
-	luaL_checktype(L, 1, LUA_TUSERDATA);
-	luaL_checkudata(L, 1, name);
+	_check_instance(L);
 
 	if (lua_isstring(L, 2) && lua_tostring(L, 2)[0] == '_')
 	{
@@ -488,13 +560,10 @@ int L_Class<name, index_t>::_set(lua_State *L)
 	}
 	else
 	{
-		// pop the set table
-		_push_set_methods_key(L);
-		lua_gettable(L, LUA_REGISTRYINDEX);
-		
-		// get the function from that table
+		// get the function from the set table
+		_push_methods(L, 2, _push_set_methods_key);
 		lua_pushvalue(L, 2);
-		lua_gettable(L, -2);
+		lua_rawget(L, -2);
 		
 		if (lua_isnil(L, -1))
 		{
@@ -502,18 +571,10 @@ int L_Class<name, index_t>::_set(lua_State *L)
 		}
 		
 		// execute the function with table, value as our arguments
-		lua_pushvalue(L, 1);
-		lua_pushvalue(L, 3);
-		if (lua_pcall(L, 2, 0, 0) == LUA_ERRRUN)
-		{
-			// report the error as being on this line
-			luaL_where(L, 1);
-			lua_pushvalue(L, -2);
-			lua_concat(L, 2);
-			lua_error(L);
-		}
-		
-		lua_pop(L, 1);
+		lua_replace(L, 2);
+		lua_settop(L, 3);
+		lua_insert(L, 2);
+		_call_method(L, 2);
 	}
 
 	return 0;
@@ -820,7 +881,7 @@ void L_Container<name, T>::Register(lua_State *L, const luaL_Reg get[], const lu
 	L_Class<name>::Register(L, get, set, metatable);
 	luaL_getmetatable(L, name);
 	
-	lua_pushcfunction(L, _get_container);
+	L_Class<name>::_push_dispatch_closure(L, _get_container);
 	lua_setfield(L, -2, "__index");
 	
 	lua_pushcfunction(L, _call);
@@ -911,7 +972,7 @@ void L_EnumContainer<name, T>::Register(lua_State *L, const luaL_Reg methods[],
 	
 	luaL_getmetatable(L, name);
 
-	lua_pushcfunction(L, _get_enumcontainer);
+	L_Class<name>::_push_dispatch_closure(L, _get_enumcontainer);
 	lua_setfield(L, -2, "__index");
 
 	lua_pop(L, 1);
@@ -176,9 +176,11 @@ enum recording_version {
 	RECORDING_VERSION_ALEPH_ONE_1_4 = 11,
 	RECORDING_VERSION_ALEPH_ONE_1_7 = 12,
 	RECORDING_VERSION_ALEPH_ONE_1_11 = 13,
+	RECORDING_VERSION_ALEPH_ONE_WORLD_HASHES = 14,
 };
-const short default_recording_version = RECORDING_VERSION_ALEPH_ONE_1_11;
-const short max_handled_recording= RECORDING_VERSION_ALEPH_ONE_1_11;
+static_assert(RECORDING_VERSION_ALEPH_ONE_WORLD_HASHES == first_recording_version_with_world_hashes, "films carry world hashes from this version on");
+const short default_recording_version = RECORDING_VERSION_ALEPH_ONE_WORLD_HASHES;
+const short max_handled_recording= RECORDING_VERSION_ALEPH_ONE_WORLD_HASHES;
 
 #include "screen_definitions.h"
 #include "interface_menus.h"
@@ -198,6 +200,8 @@ const short max_handled_recording= RECORDING_VERSION_ALEPH_ONE_1_11;
 #include "game_wad.h"
 
 #include "motion_sensor.h" // for reset_motion_sensor()
+#include "world_snapshot.h"
+#include "interpolated_world.h"
 
 #include "lua_hud_script.h"
 
@@ -1178,6 +1182,53 @@ bool idle_game_state(uint64_t time)
 	}
 }
 
+extern bool game_is_being_replayed();
+
+static bool fast_forwarding_replay = false;
+
+/* Runs the film being replayed, without rendering, interpolating or playing sounds, as
+	fast as the simulation goes, until get_replay_tick() reaches stop_tick (NONE runs to the
+	end of the film).  Returns true if it stopped at stop_tick; false if the film ended first
+	(leaving the game in _switch_demo, for the main loop to finish) or there was no replay
+	to run.  A movie being exported needs every frame rendered, so that isn't fast-forwarded. */
+bool fast_forward_replay(
+	int32 stop_tick)
+{
+	if (get_game_state()!=_game_in_progress || !game_is_being_replayed() || Movie::instance()->IsRecording())
+	{
+		return false;
+	}
+
+	SoundManager::Pause pauseSoundManager;
+	exit_interpolated_world();
+	fast_forwarding_replay= true;
+
+	while (get_game_state()==_game_in_progress && (stop_tick==NONE || get_replay_tick()<stop_tick))
+	{
+		if (!feed_replay_tick())
+		{
+			set_game_state(_switch_demo);
+			break;
+		}
+
+		update_world();
+	}
+
+	fast_forwarding_replay= false;
+
+	/* what the interpolated world last captured is long gone */
+	init_interpolated_world();
+	sync_heartbeat_count();
+
+	return get_game_state()==_game_in_progress && stop_tick!=NONE && get_replay_tick()>=stop_tick;
+}
+
+bool replay_is_fast_forwarding(
+	void)
+{
+	return fast_forwarding_replay;
+}
+
 void set_game_focus_lost()
 {
 	switch (game_state.state)
@@ -2565,6 +2616,7 @@ static bool begin_game(
 						load_film_profile(FILM_PROFILE_ALEPH_ONE_1_7);
 						break;
 					case RECORDING_VERSION_ALEPH_ONE_1_11:
+					case RECORDING_VERSION_ALEPH_ONE_WORLD_HASHES:
 						load_film_profile(FILM_PROFILE_DEFAULT);
 						break;
 					default:
@@ -2841,6 +2893,7 @@ static void finish_game(
 	if (game_state.user==_network_player)
 	{
 		NetUnSync(); // gracefully exit from the game
+		set_world_hash_interval(0);
 
 		/* Don't update the screen, etc.. */
 		game_state.state= _displaying_network_game_dialogs;
@@ -2902,6 +2955,7 @@ static void clean_up_after_failed_game(bool inNetgame, bool inRecording, bool in
 #if !defined(DISABLE_NETWORKING)
                         exit_networking();
 #endif // !defined(DISABLE_NETWORKING)
+                        set_world_hash_interval(0);
                 } else {
 /* NOTE: The network code is now responsible for displaying its own errors!!!! */
                         /* Give them the error... */
@@ -3248,7 +3302,7 @@ static void try_and_display_chapter_screen(
 	bool interface_table_is_valid,
 	bool text_block)
 {
-	if (Movie::instance()->IsRecording() || !shell_options.replay_directory.empty())
+	if (Movie::instance()->IsRecording() || !shell_options.replay_directory.empty() || fast_forwarding_replay)
 		return;
 	
 	short pict_resource_number = get_screen_data(_display_chapter_heading)->screen_base + level;
@@ -3554,7 +3608,7 @@ static void video_frame_decoder_callback(plm_t* mpeg, plm_frame_t* frame, void*
 
 void show_movie(short index)
 {
-	if (Movie::instance()->IsRecording() || !shell_options.replay_directory.empty())
+	if (Movie::instance()->IsRecording() || !shell_options.replay_directory.empty() || fast_forwarding_replay)
 		return;
 	
 	float PlaybackSize = 0;
@@ -267,6 +267,8 @@ void process_main_menu_highlight_select(bool cheatkeys_down);
 void draw_menu_button_for_command(short index);
 void update_interface_display(void);
 bool idle_game_state(uint64_t time);
+bool fast_forward_replay(int32 stop_tick);
+bool replay_is_fast_forwarding(void);
 void display_main_menu(void);
 void do_menu_item_command(short menu_id, short menu_item, bool cheat);
 bool interface_fade_finished(void);
@@ -381,6 +383,8 @@ bool has_recording_file(void);
 void increment_replay_speed(void);
 void decrement_replay_speed(void);
 void set_replay_speed(short);
+int32 get_replay_tick(void);
+bool feed_replay_tick(void);
 void reset_recording_and_playback_queues(void);
 uint32 parse_keymap(void);
 
@@ -1127,6 +1127,10 @@ static void software_rendering_options_dialog(void* arg)
 	table->dual_add(sw_driver_w->label("Acceleration"), d);
 	table->dual_add(sw_driver_w, d);
 
+	w_toggle *sw_multithreaded_w = new w_toggle(graphics_preferences->software_multithreaded_rendering);
+	table->dual_add(sw_multithreaded_w->label("Multithreaded Rendering"), d);
+	table->dual_add(sw_multithreaded_w, d);
+
 	placer->add(table, true);
 
 	placer->add(new w_spacer(), true);
@@ -1172,6 +1176,12 @@ static void software_rendering_options_dialog(void* arg)
 			changed = true;
 		}
 
+		if (sw_multithreaded_w->get_selection() != graphics_preferences->software_multithreaded_rendering)
+		{
+			graphics_preferences->software_multithreaded_rendering = sw_multithreaded_w->get_selection();
+			changed = true;
+		}
+
 		if (ephemera_quality_w->get_selection() != graphics_preferences->ephemera_quality)
 		{
 			graphics_preferences->ephemera_quality = ephemera_quality_w->get_selection();
@@ -3640,6 +3650,7 @@ InfoTree graphics_preferences_tree()
 	root.put_attr("ogl_flags", graphics_preferences->OGL_Configure.Flags);
 	root.put_attr("software_alpha_blending", graphics_preferences->software_alpha_blending);
 	root.put_attr("software_sdl_driver", graphics_preferences->software_sdl_driver);
+	root.put_attr("software_multithreaded_rendering", graphics_preferences->software_multithreaded_rendering);
 	root.put_attr("fps_target", graphics_preferences->fps_target);
 	root.put_attr("anisotropy_level", graphics_preferences->OGL_Configure.AnisotropyLevel);
 	root.put_attr("multisamples", graphics_preferences->OGL_Configure.Multisamples);
@@ -4152,6 +4163,7 @@ static void default_graphics_preferences(graphics_preferences_data *preferences)
 
 	preferences->software_alpha_blending = _sw_alpha_off;
 	preferences->software_sdl_driver = _sw_driver_default;
+	preferences->software_multithreaded_rendering = false;
 	preferences->fps_target = 30;
 
 	preferences->movie_export_video_quality = 50;
@@ -4627,6 +4639,7 @@ void parse_graphics_preferences(InfoTree root, std::string version)
 	root.read_attr("ogl_flags", graphics_preferences->OGL_Configure.Flags);
 	root.read_attr("software_alpha_blending", graphics_preferences->software_alpha_blending);
 	root.read_attr("software_sdl_driver", graphics_preferences->software_sdl_driver);
+	root.read_attr("software_multithreaded_rendering", graphics_preferences->software_multithreaded_rendering);
 	root.read_attr("fps_target", graphics_preferences->fps_target);
 	root.read_attr("anisotropy_level", graphics_preferences->OGL_Configure.AnisotropyLevel);
 	root.read_attr("multisamples", graphics_preferences->OGL_Configure.Multisamples);
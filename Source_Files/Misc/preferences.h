@@ -93,6 +93,7 @@ struct graphics_preferences_data
 
 	int16 software_alpha_blending;
 	int16 software_sdl_driver;
+	bool software_multithreaded_rendering; // same pixels as single-threaded, drawn in bands
 	int16 fps_target; // should be a multiple of 30; 0 = unlimited
 
 	int16 movie_export_video_quality;
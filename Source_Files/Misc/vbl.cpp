@@ -100,6 +100,7 @@ Feb 20, 2002 (Woody Zenfell):
 #include "joystick.h"
 #include "Movie.h"
 #include "InfoTree.h"
+#include "world_snapshot.h"
 
 /* ---------- constants */
 
@@ -158,7 +159,11 @@ static uint8 *unpack_recording_header(uint8 *Stream, recording_header *Objects,
 static uint8 *pack_recording_header(uint8 *Stream, recording_header *Objects, size_t Count);
 static uint8* unpack_recording_extension_header(uint8* Stream, recording_extension_header* Objects, size_t Count);
 static uint8* pack_recording_extension_header(uint8* Stream, recording_extension_header* Objects, size_t Count);
-static bool handle_replay_extension();
+static bool handle_replay_extensions(int32 file_length);
+static int32 write_recording_extension(recording_extension_type extension_type, const std::vector<byte>& data);
+static std::vector<byte> pack_world_hashes(int32 interval, const std::vector<std::pair<int32, uint64_t>>& world_hashes);
+static bool unpack_world_hashes(const std::vector<byte>& data);
+static void check_replay_world_hashes(void);
 
 // #define DEBUG_REPLAY
 
@@ -264,6 +269,28 @@ int get_replay_speed()
 	return replay.replay_speed;
 }
 
+/* how far into the film the game is: ticks pulled from it, less those still waiting to be run */
+int32 get_replay_tick(
+	void)
+{
+	return replay.ticks_pulled - GetRealActionQueues()->countActionFlags(0);
+}
+
+/* for fast_forward_replay(), which has no input controller: hands the game the film's next
+	tick, if it has run the last one, and lets update_world() run exactly one tick.  returns
+	false once the film is over */
+bool feed_replay_tick(
+	void)
+{
+	if (GetRealActionQueues()->countActionFlags(0)==0)
+	{
+		if (!pull_flags_from_recording(1) && replay.have_read_last_chunk) return false;
+	}
+
+	heartbeat_count= dynamic_world->tick_count + 1;
+	return true;
+}
+
 bool game_is_being_replayed()
 {
 	return replay.game_is_being_replayed;
@@ -488,6 +515,7 @@ static short pull_flags_from_recording(
 		}
 	}
 	
+	replay.ticks_pulled+= true_count;
 	return true_count;
 }
 
@@ -576,7 +604,7 @@ bool setup_for_replay_from_file(
 		int file_length;
 		FilmFile.GetLength(file_length);
 
-		successful = file_length > replay.header.length ? handle_replay_extension() : use_map_file(replay.header.map_checksum);
+		successful = handle_replay_extensions(file_length);
 	
 		/* Set to the mapfile this replay came from.. */
 		if (successful)
@@ -585,6 +613,18 @@ bool setup_for_replay_from_file(
 			replay.location_in_cache= NULL;
 			replay.bytes_in_cache= 0;
 			replay.replay_speed= 1;
+			replay.ticks_pulled= 0;
+
+			/* hash the replay as it was hashed when recorded, unless someone (e.g., the
+				replay verifier) has already asked for hashes of their own */
+			replay.world_hashes_checked= 0;
+			replay.replay_set_world_hash_interval= false;
+			if (replay.world_hash_interval > 0 && get_world_hash_interval() == 0)
+			{
+				set_world_hash_interval(replay.world_hash_interval);
+				reset_world_hashes();
+				replay.replay_set_world_hash_interval= true;
+			}
 			
 #ifdef DEBUG_REPLAY
 			open_stream_file();
@@ -618,6 +658,8 @@ void start_recording(
 	if(get_recording_filedesc(FilmFileSpec))
 		FilmFileSpec.Delete();
 
+	reset_world_hashes();
+
 	if (FilmFileSpec.Create(_typecode_film))
 	{
 		/* I debate the validity of fsCurPerm here, but Alain had it, and it has been working */
@@ -660,38 +702,24 @@ void stop_recording(
 		bool successfulWrite = FilmFile.Write(SIZEOF_recording_header,Header);
 		assert(successfulWrite);
 
-		bool has_extension_header = false;
-		replay.extension_header.length = 0;
-		replay.extension_header.extension_type = recording_extension_type::none;
-
-		int extension_data_length = 0;
-		byte* extension_data = nullptr;
+		/* Extensions follow the flags one after the other, a saved game first, since
+			is_saved_game_replay() only looks at the first one */
+		int32 extensions_length = 0;
+		FilmFile.SetPosition(replay.header.length);
 
 		if (replay.saved_wad_data.size())
 		{
-			extension_data_length = replay.saved_wad_data.size();
-			extension_data = replay.saved_wad_data.data();
-			replay.extension_header.extension_type = recording_extension_type::saved_game_wad;
-			replay.extension_header.length = SIZEOF_recording_extension_header + replay.saved_wad_data.size();
-			has_extension_header = true;
+			extensions_length += write_recording_extension(recording_extension_type::saved_game_wad, replay.saved_wad_data);
 		}
 
-		if (has_extension_header)
+		if (replay.header.version >= first_recording_version_with_world_hashes && get_world_hashes().size() && get_world_hash_interval() > 0)
 		{
-			FilmFile.SetPosition(replay.header.length);
-			byte extension_header[SIZEOF_recording_extension_header];
-			pack_recording_extension_header(extension_header, &replay.extension_header, 1);
-
-			successfulWrite = FilmFile.Write(SIZEOF_recording_extension_header, extension_header);
-			assert(successfulWrite);
-
-			FilmFile.SetPosition(replay.header.length + SIZEOF_recording_extension_header);
-			successfulWrite = FilmFile.Write(extension_data_length, extension_data);
-			assert(successfulWrite);
+			extensions_length += write_recording_extension(recording_extension_type::world_hashes,
+				pack_world_hashes(get_world_hash_interval(), get_world_hashes()));
 		}
 		
 		FilmFile.GetLength(total_length);
-		assert(total_length==replay.header.length + replay.extension_header.length);
+		assert(total_length==replay.header.length + extensions_length);
 		
 		FilmFile.Close();
 	}
@@ -700,33 +728,166 @@ void stop_recording(
 	replay.valid= false;
 }
 
-bool handle_replay_extension()
+bool handle_replay_extensions(
+	int32 file_length)
 {
-	bool successful = false;
-	FilmFile.SetPosition(replay.header.length);
-	byte extension_header[SIZEOF_recording_extension_header];
-	FilmFile.Read(SIZEOF_recording_extension_header, extension_header);
-	unpack_recording_extension_header(extension_header, &replay.extension_header, 1);
+	bool successful = true;
+	bool loaded_saved_game = false;
+	int32 position = replay.header.length;
+
+	replay.world_hash_interval = 0;
+	replay.world_hashes.clear();
 
-	switch (replay.extension_header.extension_type)
+	while (successful && position + SIZEOF_recording_extension_header <= file_length)
 	{
-		case recording_extension_type::saved_game_wad:
+		recording_extension_header extension_header;
+		byte packed_extension_header[SIZEOF_recording_extension_header];
+
+		FilmFile.SetPosition(position);
+		FilmFile.Read(SIZEOF_recording_extension_header, packed_extension_header);
+		unpack_recording_extension_header(packed_extension_header, &extension_header, 1);
+		if (extension_header.length < SIZEOF_recording_extension_header || position + extension_header.length > file_length) break;
+
+		/* is_saved_game_replay() looks at the first one */
+		if (position == replay.header.length) replay.extension_header = extension_header;
+
+		int32 data_length = extension_header.length - SIZEOF_recording_extension_header;
+		switch (extension_header.extension_type)
 		{
-			auto saved_wad = (byte*)malloc(replay.extension_header.length);
-			FilmFile.Read(replay.extension_header.length, saved_wad);
-			successful = load_saved_game_from_flat_data(saved_wad);
-			break;
+			case recording_extension_type::saved_game_wad:
+			{
+				auto saved_wad = (byte*)malloc(data_length);
+				FilmFile.Read(data_length, saved_wad);
+				successful = load_saved_game_from_flat_data(saved_wad);
+				loaded_saved_game = true;
+				break;
+			}
+
+			case recording_extension_type::world_hashes:
+			{
+				std::vector<byte> data(data_length);
+				FilmFile.Read(data_length, data.data());
+				if (!unpack_world_hashes(data))
+				{
+					logWarning("ignoring malformed world hashes in film");
+				}
+				break;
+			}
+
+			default:
+				/* from a newer version; nothing we need to play the film */
+				break;
 		}
 
-		default:
-			assert(false);
-			break;
+		position += extension_header.length;
+	}
+
+	if (successful && !loaded_saved_game)
+	{
+		successful = use_map_file(replay.header.map_checksum);
 	}
 
 	FilmFile.SetPosition(SIZEOF_recording_header);
 	return successful;
 }
 
+/* returns the number of bytes written */
+static int32 write_recording_extension(
+	recording_extension_type extension_type,
+	const std::vector<byte>& data)
+{
+	recording_extension_header extension_header;
+	byte packed_extension_header[SIZEOF_recording_extension_header];
+
+	extension_header.extension_type = extension_type;
+	extension_header.length = SIZEOF_recording_extension_header + data.size();
+	pack_recording_extension_header(packed_extension_header, &extension_header, 1);
+
+	bool successfulWrite = FilmFile.Write(SIZEOF_recording_extension_header, packed_extension_header);
+	assert(successfulWrite);
+	successfulWrite = FilmFile.Write(data.size(), const_cast<byte*>(data.data()));
+	assert(successfulWrite);
+
+	return extension_header.length;
+}
+
+/* interval, count, then count of tick and hash (high word first) */
+static std::vector<byte> pack_world_hashes(
+	int32 interval,
+	const std::vector<std::pair<int32, uint64_t>>& world_hashes)
+{
+	std::vector<byte> data(2 * sizeof(int32) + world_hashes.size() * (sizeof(int32) + sizeof(uint64_t)));
+	uint8* S = data.data();
+
+	ValueToStream(S, interval);
+	ValueToStream(S, static_cast<int32>(world_hashes.size()));
+	for (const auto& world_hash : world_hashes)
+	{
+		ValueToStream(S, world_hash.first);
+		ValueToStream(S, static_cast<uint32>(world_hash.second >> 32));
+		ValueToStream(S, static_cast<uint32>(world_hash.second));
+	}
+
+	assert(static_cast<size_t>(S - data.data()) == data.size());
+	return data;
+}
+
+static bool unpack_world_hashes(
+	const std::vector<byte>& data)
+{
+	uint8* S = const_cast<uint8*>(data.data());
+	int32 interval, count;
+
+	if (data.size() < 2 * sizeof(int32)) return false;
+	StreamToValue(S, interval);
+	StreamToValue(S, count);
+	if (interval <= 0 || count < 0 || data.size() < 2 * sizeof(int32) + count * (sizeof(int32) + sizeof(uint64_t))) return false;
+
+	replay.world_hashes.resize(count);
+	for (auto& world_hash : replay.world_hashes)
+	{
+		uint32 high, low;
+		StreamToValue(S, world_hash.first);
+		StreamToValue(S, high);
+		StreamToValue(S, low);
+		world_hash.second = (static_cast<uint64_t>(high) << 32) | low;
+	}
+	replay.world_hash_interval = interval;
+
+	return true;
+}
+
+/* in recording order; tick counts start over on each level */
+static void check_replay_world_hashes(
+	void)
+{
+	const std::vector<std::pair<int32, uint64_t>>& world_hashes = get_world_hashes();
+
+	if (get_world_hash_interval() != replay.world_hash_interval) return;
+
+	for (; replay.world_hashes_checked < world_hashes.size() && replay.world_hashes_checked < replay.world_hashes.size(); ++replay.world_hashes_checked)
+	{
+		if (world_hashes[replay.world_hashes_checked] != replay.world_hashes[replay.world_hashes_checked])
+		{
+			logWarning("replay is out of sync with the recorded game as of tick %d", replay.world_hashes[replay.world_hashes_checked].first);
+
+			/* everything after will differ too */
+			replay.world_hashes_checked = replay.world_hashes.size();
+			break;
+		}
+	}
+}
+
+int32 get_replay_world_hash_interval()
+{
+	return replay.world_hash_interval;
+}
+
+const std::vector<std::pair<int32, uint64_t>>& get_replay_world_hashes()
+{
+	return replay.world_hashes;
+}
+
 void rewind_recording(
 	void)
 {
@@ -797,6 +958,8 @@ void check_recording_replaying(
 			// we'll fill 'em up.
 			read_recording_queue_chunks();
 		}
+
+		check_replay_world_hashes();
 	}
 }
 
@@ -819,6 +982,11 @@ void stop_replay(
 		assert(replay.valid);
 
 		replay.game_is_being_replayed= false;
+		if (replay.replay_set_world_hash_interval)
+		{
+			set_world_hash_interval(0);
+			replay.replay_set_world_hash_interval= false;
+		}
 		if (replay.resource_data)
 		{
 			delete []replay.resource_data;
@@ -33,6 +33,9 @@ Jul 5, 2000 (Loren Petrich):
 // LP: CodeWarrior complains unless I give the full definition of these classes
 #include "FileHandler.h"
 
+#include <utility>
+#include <vector>
+
 /* ------------ prototypes/VBL.C */
 bool setup_for_replay_from_file(FileSpecifier& File, uint32 map_checksum, bool prompt_to_export = false);
 bool setup_replay_from_random_resource();
@@ -47,6 +50,14 @@ void set_recording_header_data(short number_of_players, short level_number, uint
 void get_recording_header_data(short *number_of_players, short *level_number, uint32 *map_checksum,
 	short *version, struct player_start_data *starts, struct game_data *game_information);
 
+/* films recorded with this version or later may carry world hashes after the flags; older
+	versions assert on any extension but a saved game, so they must refuse these films as too new */
+const short first_recording_version_with_world_hashes = 14;
+
+/* world hashes recorded into the film last set up for replay (see world_snapshot.h) */
+int32 get_replay_world_hash_interval();
+const std::vector<std::pair<int32, uint64_t>>& get_replay_world_hashes();
+
 bool input_controller(void);
 void increment_heartbeat_count(int value = 1);
 
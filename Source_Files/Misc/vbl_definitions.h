@@ -54,7 +54,8 @@ const int SIZEOF_recording_header = 352;
 enum class recording_extension_type
 {
 	none = 0,
-	saved_game_wad = 1
+	saved_game_wad = 1,
+	world_hashes = 2
 };
 
 struct recording_extension_header
@@ -72,6 +73,7 @@ struct replay_private_data {
 	bool game_is_being_recorded;
 	bool have_read_last_chunk;
 	ActionQueue *recording_queues;
+	int32 ticks_pulled; /* ticks of flags handed to the game so far, across levels */
 	
 	// fileref recording_file_refnum;
 	char *fsread_buffer;
@@ -83,6 +85,12 @@ struct replay_private_data {
 	int32 resource_data_size;
 	struct recording_extension_header extension_header;
 	std::vector<byte> saved_wad_data;
+
+	/* world hashes recorded with the film, and how many of them the replay has matched */
+	int32 world_hash_interval;
+	std::vector<std::pair<int32, uint64_t>> world_hashes;
+	size_t world_hashes_checked;
+	bool replay_set_world_hash_interval;
 };
 
 /* ----- globals */
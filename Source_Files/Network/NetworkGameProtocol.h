@@ -45,6 +45,11 @@ public:
 	virtual void    UpdateUnconfirmedActionFlags() = 0;
 
 	virtual bool CheckWorldUpdate() = 0;
+
+	// how often to hash the game world when we gather, and a hash to pass on for
+	// out-of-sync detection
+	virtual int32 GetWorldHashInterval() = 0;
+	virtual void ReportWorldHash(int32 inTick, uint64_t inHash) = 0;
 };
 
 #endif // NETWORKGAMEPROTOCOL_H
@@ -16,8 +16,21 @@
     http://www.gnu.org/licenses/gpl.html
 */
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include "NetworkInterface.h"
 
+#if defined(HAVE_SENDMMSG) || defined(HAVE_RECVMMSG)
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+// how many datagrams to hand the system at once
+static constexpr size_t kMaxMessagesPerCall = 64;
+
 IPaddress::IPaddress(const asio::ip::tcp::endpoint& endpoint)
 {
     _address = endpoint.address();
@@ -78,6 +91,60 @@ int64_t UDPsocket::send(const UDPpacket& packet)
     return error_code ? -1 : result;
 }
 
+int64_t UDPsocket::send_batch(const UDPpacket* packets, size_t count)
+{
+#ifdef HAVE_SENDMMSG
+    int64_t sent = 0;
+    size_t next = 0;
+    while (next < count)
+    {
+        mmsghdr messages[kMaxMessagesPerCall];
+        iovec buffers[kMaxMessagesPerCall];
+        asio::ip::udp::endpoint destinations[kMaxMessagesPerCall];
+
+        auto batch_size = std::min(count - next, kMaxMessagesPerCall);
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            const auto& packet = packets[next + i];
+            destinations[i] = asio::ip::udp::endpoint(packet.address._address, packet.address.port());
+            buffers[i].iov_base = const_cast<uint8_t*>(packet.buffer.data());
+            buffers[i].iov_len = packet.data_size;
+
+            std::memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_name = destinations[i].data();
+            messages[i].msg_hdr.msg_namelen = destinations[i].size();
+            messages[i].msg_hdr.msg_iov = &buffers[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = sendmmsg(_socket.native_handle(), messages, batch_size, 0);
+        if (result > 0)
+        {
+            sent += result;
+            next += result;
+        }
+        else if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            // the first one failed or would block; send it on its own, as send() would
+            if (send(packets[next]) > 0) sent++;
+            next++;
+        }
+    }
+    return sent;
+#else
+    int64_t sent = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (send(packets[i]) > 0) sent++;
+    }
+    return sent;
+#endif
+}
+
 int64_t UDPsocket::broadcast_send(const UDPpacket& packet)
 {
     asio::error_code error_code;
@@ -97,6 +164,55 @@ int64_t UDPsocket::receive(UDPpacket& packet)
     return result;
 }
 
+int64_t UDPsocket::receive_batch(UDPpacket* packets, size_t count)
+{
+    size_t received = 0;
+#ifdef HAVE_RECVMMSG
+    while (received < count)
+    {
+        mmsghdr messages[kMaxMessagesPerCall];
+        iovec buffers[kMaxMessagesPerCall];
+        asio::ip::udp::endpoint sources[kMaxMessagesPerCall];
+
+        auto batch_size = std::min(count - received, kMaxMessagesPerCall);
+        for (size_t i = 0; i < batch_size; i++)
+        {
+            auto& packet = packets[received + i];
+            buffers[i].iov_base = packet.buffer.data();
+            buffers[i].iov_len = packet.buffer.size();
+
+            std::memset(&messages[i], 0, sizeof(messages[i]));
+            messages[i].msg_hdr.msg_name = sources[i].data();
+            messages[i].msg_hdr.msg_namelen = sources[i].capacity();
+            messages[i].msg_hdr.msg_iov = &buffers[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int result = recvmmsg(_socket.native_handle(), messages, batch_size, MSG_DONTWAIT, nullptr);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) break;
+
+        for (int i = 0; i < result; i++)
+        {
+            auto& packet = packets[received + i];
+            sources[i].resize(messages[i].msg_hdr.msg_namelen);
+            packet.address = sources[i];
+            packet.data_size = messages[i].msg_len;
+        }
+
+        received += result;
+        if (static_cast<size_t>(result) < batch_size) break;
+    }
+#else
+    while (received < count && check_receive() > 0)
+    {
+        if (receive(packets[received]) < 0) break;
+        received++;
+    }
+#endif
+    return received;
+}
+
 void UDPsocket::register_receive_async(UDPpacket& packet)
 {
     _receive_async_return_value = 0;
@@ -76,6 +76,12 @@ public:
     int64_t broadcast_send(const UDPpacket& packet);
     int64_t send(const UDPpacket& packet);
     int64_t receive(UDPpacket& packet);
+
+    // Several datagrams per system call where the system has sendmmsg/recvmmsg, one at a
+    // time otherwise.  send_batch returns how many were sent; receive_batch does not wait,
+    // and returns how many had already arrived (up to count).
+    int64_t send_batch(const UDPpacket* packets, size_t count);
+    int64_t receive_batch(UDPpacket* packets, size_t count);
     void register_receive_async(UDPpacket& packet);
     int64_t receive_async(int timeout_ms);
     bool broadcast(bool enable);
@@ -203,6 +203,18 @@ StarGameProtocol::CheckWorldUpdate()
 	return spoke_check_world_update();
 }
 
+int32
+StarGameProtocol::GetWorldHashInterval()
+{
+	return spoke_get_world_hash_interval();
+}
+
+void
+StarGameProtocol::ReportWorldHash(int32 inTick, uint64_t inHash)
+{
+	spoke_report_world_hash(inTick, inHash);
+}
+
 /* ZZZ addition:
 ---------------------------
 	make_player_really_net_dead
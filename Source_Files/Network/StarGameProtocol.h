@@ -48,6 +48,9 @@ public:
 	void    UpdateUnconfirmedActionFlags();
 
 	bool CheckWorldUpdate() override;
+
+	int32 GetWorldHashInterval() override;
+	void ReportWorldHash(int32 inTick, uint64_t inHash) override;
 };
 
 extern void DefaultStarPreferences();
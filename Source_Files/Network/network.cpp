@@ -988,6 +988,77 @@ static void handlePhysicsMessage(BigChunkOfDataMessage *physicsMessage, Communic
 	}
 }
 
+// what the gatherer said it would send, and which of it we had cached
+static std::vector<std::pair<uint16, NetGameDataHash>> handlerGameDataHashes;
+static uint16 handlerGameDataCached = 0;
+
+static void handleGameDataHashesMessage(GameDataHashesMessage *hashesMessage, CommunicationsChannel *channel) {
+	if (netState == netStartingUp || netState == netDown) {
+		handlerGameDataHashes = hashesMessage->mHashes;
+		handlerGameDataCached = 0;
+
+		for (auto it = handlerGameDataHashes.begin(); it != handlerGameDataHashes.end(); ++it) {
+			std::vector<byte> data;
+			if (!NetReadCachedGameData(it->second, data)) continue;
+
+			switch (it->first) {
+			case GameDataHashesMessage::kPhysics:
+				handlerPhysicsBuffer.swap(data);
+				break;
+			case GameDataHashesMessage::kMap:
+				delete[] handlerMapBuffer;
+				handlerMapLength = data.size();
+				handlerMapBuffer = new byte[handlerMapLength];
+				memcpy(handlerMapBuffer, data.data(), handlerMapLength);
+				break;
+			case GameDataHashesMessage::kLua:
+				handlerLuaBuffer.swap(data);
+				break;
+			default:
+				continue;
+			}
+
+			handlerGameDataCached |= it->first;
+		}
+
+		GameDataCachedMessage cachedMessage(handlerGameDataCached);
+		channel->enqueueOutgoingMessage(cachedMessage);
+	} else {
+		logAnomaly("unexpected game data hashes message received (netState is %i)", netState);
+	}
+}
+
+// keeps whatever the gatherer streamed us, if it's what it said it would be
+static void cache_received_game_data() {
+	for (auto it = handlerGameDataHashes.begin(); it != handlerGameDataHashes.end(); ++it) {
+		if (handlerGameDataCached & it->first) continue;
+
+		const byte *data = NULL;
+		size_t length = 0;
+		switch (it->first) {
+		case GameDataHashesMessage::kPhysics:
+			data = handlerPhysicsBuffer.data();
+			length = handlerPhysicsBuffer.size();
+			break;
+		case GameDataHashesMessage::kMap:
+			data = handlerMapBuffer;
+			length = handlerMapLength;
+			break;
+		case GameDataHashesMessage::kLua:
+			data = handlerLuaBuffer.data();
+			length = handlerLuaBuffer.size();
+			break;
+		}
+
+		if (length && NetHashGameData(data, length) == it->second) {
+			NetCacheGameData(it->second, data, length);
+		}
+	}
+
+	handlerGameDataHashes.clear();
+	handlerGameDataCached = 0;
+}
+
 static void handleServerWarningMessage(ServerWarningMessage *serverWarningMessage, CommunicationsChannel *) {
   char *s = strdup(serverWarningMessage->string()->c_str());
   alert_user(s);
@@ -1102,6 +1173,7 @@ static TypedMessageHandlerFunction<BigChunkOfDataMessage> luaMessageHandler(&han
 static TypedMessageHandlerFunction<BigChunkOfDataMessage> mapMessageHandler(&handleMapMessage);
 static TypedMessageHandlerFunction<NetworkChatMessage> networkChatMessageHandler(&handleNetworkChatMessage);
 static TypedMessageHandlerFunction<BigChunkOfDataMessage> physicsMessageHandler(&handlePhysicsMessage);
+static TypedMessageHandlerFunction<GameDataHashesMessage> gameDataHashesMessageHandler(&handleGameDataHashesMessage);
 static TypedMessageHandlerFunction<CapabilitiesMessage> capabilitiesMessageHandler(&handleCapabilitiesMessage);
 static TypedMessageHandlerFunction<TopologyMessage> topologyMessageHandler(&handleTopologyMessage);
 static TypedMessageHandlerFunction<ServerWarningMessage> serverWarningMessageHandler(&handleServerWarningMessage);
@@ -1237,6 +1309,8 @@ bool NetEnter(bool use_remote_hub)
 		inflater->learnPrototype(RemoteHubReadyMessage());
 		inflater->learnPrototype(RemoteHubHostResponseMessage());
 		inflater->learnPrototype(RemoteHubHostConnectMessage());
+		inflater->learnPrototype(GameDataHashesMessage());
+		inflater->learnPrototype(GameDataCachedMessage());
 	}
   
 	if (!joinDispatcher) {
@@ -1252,6 +1326,7 @@ bool NetEnter(bool use_remote_hub)
 		joinDispatcher->setHandlerForType(&networkChatMessageHandler, NetworkChatMessage::kType);
 		joinDispatcher->setHandlerForType(&physicsMessageHandler, PhysicsMessage::kType);
 		joinDispatcher->setHandlerForType(&physicsMessageHandler, ZippedPhysicsMessage::kType);
+		joinDispatcher->setHandlerForType(&gameDataHashesMessageHandler, GameDataHashesMessage::kType);
 		joinDispatcher->setHandlerForType(&capabilitiesMessageHandler, CapabilitiesMessage::kType);
 		joinDispatcher->setHandlerForType(&serverWarningMessageHandler, ServerWarningMessage::kType);
 		joinDispatcher->setHandlerForType(&clientInfoMessageHandler, ClientInfoMessage::kType);
@@ -1273,6 +1348,7 @@ bool NetEnter(bool use_remote_hub)
 	my_capabilities[Capabilities::kZippedData] = Capabilities::kZippedDataVersion;
 	my_capabilities[Capabilities::kNetworkStats] = Capabilities::kNetworkStatsVersion;
 	my_capabilities[Capabilities::kRugby] = Capabilities::kRugbyVersion;
+	my_capabilities[Capabilities::kGameDataCache] = Capabilities::kGameDataCacheVersion;
 
 	// net commands!
 	sIgnoredPlayers.clear();
@@ -1353,6 +1429,8 @@ void NetExit(
 	deferred_script.clear();
 	handlerLuaBuffer.clear();
 	handlerPhysicsBuffer.clear();
+	handlerGameDataHashes.clear();
+	handlerGameDataCached = 0;
   
 	if (server) {
 		delete server;
@@ -2072,6 +2150,9 @@ OSErr NetDistributeGameDataToAllPlayers(byte *wad_buffer,
 	std::vector<CommunicationsChannel *> zipCapableChannels;
 	std::vector<CommunicationsChannel *> zipIncapableChannels;
 
+	// and who keeps game data they've been sent, so may not need all of it
+	std::vector<CommunicationsChannel *> cacheCapableChannels;
+
 	if (remote_hub)
 	{
 		channels.push_back(remote_hub);
@@ -2093,6 +2174,10 @@ OSErr NetDistributeGameDataToAllPlayers(byte *wad_buffer,
 				if (client->capabilities[Capabilities::kZippedData] >= my_capabilities[Capabilities::kZippedData])
 				{
 					zipCapableChannels.push_back(client->channel.get());
+					if (client->capabilities[Capabilities::kGameDataCache] >= my_capabilities[Capabilities::kGameDataCache])
+					{
+						cacheCapableChannels.push_back(client->channel.get());
+					}
 				}
 				else
 				{
@@ -2110,14 +2195,76 @@ OSErr NetDistributeGameDataToAllPlayers(byte *wad_buffer,
 		reset_progress_bar();
 	}
 #endif
+
+	// send the hashes first, and only stream each piece to those who don't have it;
+	// anyone who doesn't answer gets everything
+	std::map<CommunicationsChannel *, uint16> cachedGameData;
+	if (cacheCapableChannels.size())
+	{
+		GameDataHashesMessage hashesMessage;
+		if (physics_buffer)
+			hashesMessage.mHashes.push_back(std::make_pair(static_cast<uint16>(GameDataHashesMessage::kPhysics), NetHashGameData(physics_buffer, physics_length)));
+		hashesMessage.mHashes.push_back(std::make_pair(static_cast<uint16>(GameDataHashesMessage::kMap), NetHashGameData(wad_buffer, wad_length)));
+		if (deferred_script.size())
+			hashesMessage.mHashes.push_back(std::make_pair(static_cast<uint16>(GameDataHashesMessage::kLua), NetHashGameData(deferred_script.data(), deferred_script.size())));
+
+		uint64_t deadline = machine_tick_count() + 30000;
+		std::for_each(cacheCapableChannels.begin(), cacheCapableChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, hashesMessage));
+		CommunicationsChannel::multipleFlushOutgoingMessages(cacheCapableChannels, false, 30000, 30000);
+
+		// listen to everyone at once, so one joiner who never answers holds the others up
+		// no longer than it takes to give up on them
+		std::vector<CommunicationsChannel *> unanswered = cacheCapableChannels;
+		while (unanswered.size() && machine_tick_count() < deadline)
+		{
+			for (auto it = unanswered.begin(); it != unanswered.end(); )
+			{
+				CommunicationsChannel *channel = *it;
+				std::unique_ptr<Message> message(channel->receiveMessage(0, 0));
+				if (auto cachedMessage = dynamic_cast<GameDataCachedMessage *>(message.get()))
+				{
+					cachedGameData[channel] = cachedMessage->value();
+					it = unanswered.erase(it);
+					continue;
+				}
+
+				if (message && channel->messageHandler())
+					channel->messageHandler()->handle(message.get(), channel);
+
+				if (channel->isConnected())
+					++it;
+				else
+					it = unanswered.erase(it);
+			}
+
+			if (unanswered.size())
+				sleep_for_machine_ticks(1);
+		}
+
+		if (unanswered.size())
+		{
+			logWarning("no answer to game data hashes from %d players; sending them everything", static_cast<int>(unanswered.size()));
+		}
+	}
+
+	auto channelsMissing = [&](uint16 kind) {
+		std::vector<CommunicationsChannel *> missing;
+		for (auto channel : zipCapableChannels)
+		{
+			if (!(cachedGameData[channel] & kind))
+				missing.push_back(channel);
+		}
+		return missing;
+	};
 	
 	if (physics_buffer)
 	{
-		if (zipCapableChannels.size())
+		std::vector<CommunicationsChannel *> physicsChannels = channelsMissing(GameDataHashesMessage::kPhysics);
+		if (physicsChannels.size())
 		{
 			ZippedPhysicsMessage zippedPhysicsMessage(physics_buffer, physics_length);
 			std::unique_ptr<UninflatedMessage> uninflatedMessage(zippedPhysicsMessage.deflate());
-			std::for_each(zipCapableChannels.begin(), zipCapableChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
+			std::for_each(physicsChannels.begin(), physicsChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
 		}
 
 		if (zipIncapableChannels.size())
@@ -2129,14 +2276,15 @@ OSErr NetDistributeGameDataToAllPlayers(byte *wad_buffer,
 	
 	{
 		// send zipped map to anyone who can accept it
-		if (zipCapableChannels.size())
+		std::vector<CommunicationsChannel *> mapChannels = channelsMissing(GameDataHashesMessage::kMap);
+		if (mapChannels.size())
 		{
 			ZippedMapMessage zippedMapMessage(wad_buffer, wad_length);
 			// zipped messages are compressed when deflated
 			// since we may have to send this to multiple joiners,
 			// deflate it now so that compression only happens once
 			std::unique_ptr<UninflatedMessage> uninflatedMessage(zippedMapMessage.deflate());
-			std::for_each(zipCapableChannels.begin(), zipCapableChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
+			std::for_each(mapChannels.begin(), mapChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
 		}
 
 		if (zipIncapableChannels.size())
@@ -2148,11 +2296,12 @@ OSErr NetDistributeGameDataToAllPlayers(byte *wad_buffer,
 
 	if (deferred_script.size())
 	{
-		if (zipCapableChannels.size())
+		std::vector<CommunicationsChannel *> luaChannels = channelsMissing(GameDataHashesMessage::kLua);
+		if (luaChannels.size())
 		{
 			ZippedLuaMessage zippedLuaMessage(deferred_script.data(), deferred_script.size());
 			std::unique_ptr<UninflatedMessage> uninflatedMessage(zippedLuaMessage.deflate());
-			std::for_each(zipCapableChannels.begin(), zipCapableChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
+			std::for_each(luaChannels.begin(), luaChannels.end(), std::bind(&CommunicationsChannel::enqueueOutgoingMessage, std::placeholders::_1, *uninflatedMessage));
 		}
 
 		if (zipIncapableChannels.size())
@@ -2226,6 +2375,8 @@ byte *NetReceiveGameData(bool do_physics)
   std::unique_ptr<EndGameDataMessage> endGameDataMessage(connection_to_server->receiveSpecificMessage<EndGameDataMessage>((Uint32) 60000, (Uint32) 30000));
   if (endGameDataMessage.get()) {
     // game data was received OK
+    cache_received_game_data();
+
 	if (do_physics) {
 	  auto physics_buffer = handlerPhysicsBuffer.size() > 0 ? std::malloc(handlerPhysicsBuffer.size()) : nullptr;
 	  if (physics_buffer) std::memcpy(physics_buffer, handlerPhysicsBuffer.data(), handlerPhysicsBuffer.size());
@@ -2247,6 +2398,9 @@ byte *NetReceiveGameData(bool do_physics)
   } else {
     draw_progress_bar(10, 10);
     close_progress_dialog();
+
+    handlerGameDataHashes.clear();
+    handlerGameDataCached = 0;
     
     if (handlerMapLength > 0) {
       delete[] handlerMapBuffer;
@@ -2272,6 +2426,24 @@ NetCheckWorldUpdate()
 	return sCurrentGameProtocol.CheckWorldUpdate();
 }
 
+int32
+NetGetPreferredWorldHashInterval()
+{
+	return sCurrentGameProtocol.GetWorldHashInterval();
+}
+
+int32
+NetGetWorldHashInterval()
+{
+	return topology->game_data.world_hash_interval;
+}
+
+void
+NetReportWorldHash(int32 inTick, uint64_t inHash)
+{
+	sCurrentGameProtocol.ReportWorldHash(inTick, inHash);
+}
+
 extern const NetworkStats& hub_stats(int player_index);
 
 void NetProcessMessagesInGame() {
@@ -83,7 +83,7 @@ typedef struct game_info
 	
 	// network parameters
 	int16  initial_updates_per_packet; //obsolete
-	int16  initial_update_latency; //obsolete
+	int16  world_hash_interval; // ticks between world hashes, 0 for none (was initial_update_latency, always 0)
 } game_info;
 
 #define MAX_NET_PLAYER_NAME_LENGTH  32
@@ -201,6 +201,19 @@ std::string NetSessionIdentifier(void);
 bool NetDDPOpenSocket(uint16_t ioPortNumber, PacketHandlerProcPtr packetHandler);
 bool NetDDPCloseSocket();
 bool NetDDPSendFrame(UDPpacket& frame, const IPaddress& address);
+// to send several frames at once: queue them, then flush (with the mytm mutex held throughout).
+// NetDDPFlushFrames returns how many were sent
+void NetDDPQueueFrame(const UDPpacket& frame, const IPaddress& address);
+int NetDDPFlushFrames();
+
+// how the receiving thread got packets to the handler since the socket was opened
+struct NetDDPReceiveStats {
+	uint32 packets;
+	uint32 deferred;		// queued while the mytm mutex was taken, instead of waiting for it
+	uint32 overflows;		// waited for the mutex because the queue was full
+	uint32 max_queue_depth;
+};
+NetDDPReceiveStats NetDDPGetReceiveStats();
 
 struct SSLP_ServiceInstance;
 
@@ -305,4 +318,12 @@ int32 NetGetLatency();
 const NetworkStats& NetGetStats(int player_index);
 bool NetCheckWorldUpdate();
 
+// ticks between world hashes (0 for none) this machine asks for when it gathers, and the
+// interval the gatherer set for the game in progress; every player hashes the same ticks
+int32 NetGetPreferredWorldHashInterval();
+int32 NetGetWorldHashInterval();
+
+// a hash to send for out-of-sync detection
+void NetReportWorldHash(int32 tick, uint64_t hash);
+
 #endif
@@ -39,12 +39,13 @@ class Capabilities : public capabilities_t
 
   static const int kGameworldVersion = 6;
   static const int kGameworldM1Version = 4;
-  static const int kStarVersion = 6;
+  static const int kStarVersion = 8; // compact action flags
   static const int kLuaVersion = 2;
   static const int kGatherableVersion = 1;
   static const int kZippedDataVersion = 1; // map, lua, physics
   static const int kNetworkStatsVersion = 1; // latency, jitter, errors
   static const int kRugbyVersion = 1; // sane score limit
+  static const int kGameDataCacheVersion = 2; // SHA-256 hashes before map, lua, physics
 
   static const string kGameworld;    // the PRNG, physics, etc.
   static const string kGameworldM1;  // like gameworld, but for Marathon 1 compatibility
@@ -55,6 +56,7 @@ class Capabilities : public capabilities_t
   static const string kZippedData;   // can receive zipped data
   static const string kNetworkStats; // can receive network stats
   static const string kRugby;        // rugby version
+  static const string kGameDataCache; // keeps game data it was sent, by hash
   
   uint32& operator[](const string& k) { 
     assert(k.length() < kMaxKeySize);
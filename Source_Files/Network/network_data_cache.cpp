@@ -0,0 +1,253 @@
+/*
+ *  network_data_cache.cpp
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ */
+
+#include "network_data_cache.h"
+
+#include "FileHandler.h"
+#include "Logging.h"
+
+#include <algorithm>
+
+static const size_t kMaximumCachedGameData = 64;	// files; maps, physics and scripts together
+
+static const char *kCacheDirectoryName = "Network Data";
+
+// SHA-256, as in FIPS 180-4
+class SHA256
+{
+public:
+	SHA256() : length_(0), pending_(0) {
+		static const uint32 initial[8] = {
+			0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+		};
+		memcpy(state_, initial, sizeof(state_));
+	}
+
+	void add(const byte *data, size_t length)
+	{
+		length_ += length;
+
+		if (pending_)
+		{
+			size_t count = std::min(length, sizeof(block_) - pending_);
+			memcpy(block_ + pending_, data, count);
+			pending_ += count;
+			data += count;
+			length -= count;
+
+			if (pending_ < sizeof(block_)) return;
+
+			add_block(block_);
+			pending_ = 0;
+		}
+
+		for (; length >= sizeof(block_); data += sizeof(block_), length -= sizeof(block_))
+		{
+			add_block(data);
+		}
+
+		memcpy(block_, data, length);
+		pending_ = length;
+	}
+
+	void finish(uint8 *digest)
+	{
+		uint64_t bits = length_ * 8;
+
+		byte padding[sizeof(block_) + 8] = { 0x80 };
+		size_t padding_length = (pending_ < 56 ? 56 : 120) - pending_;
+		for (int i = 0; i < 8; ++i)
+		{
+			padding[padding_length + i] = static_cast<byte>(bits >> (56 - i * 8));
+		}
+		add(padding, padding_length + 8);
+
+		for (int i = 0; i < 8; ++i)
+		{
+			digest[i * 4] = static_cast<uint8>(state_[i] >> 24);
+			digest[i * 4 + 1] = static_cast<uint8>(state_[i] >> 16);
+			digest[i * 4 + 2] = static_cast<uint8>(state_[i] >> 8);
+			digest[i * 4 + 3] = static_cast<uint8>(state_[i]);
+		}
+	}
+
+private:
+	uint32 state_[8];
+	byte block_[64];
+	uint64_t length_;
+	size_t pending_;
+
+	static uint32 rotate(uint32 value, int bits) { return (value >> bits) | (value << (32 - bits)); }
+
+	void add_block(const byte *data)
+	{
+		static const uint32 k[64] = {
+			0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+			0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+			0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+			0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+			0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+			0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+			0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+			0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+		};
+
+		uint32 w[64];
+		for (int i = 0; i < 16; ++i)
+		{
+			w[i] = (uint32(data[i * 4]) << 24) | (uint32(data[i * 4 + 1]) << 16) | (uint32(data[i * 4 + 2]) << 8) | data[i * 4 + 3];
+		}
+		for (int i = 16; i < 64; ++i)
+		{
+			uint32 s0 = rotate(w[i - 15], 7) ^ rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+			uint32 s1 = rotate(w[i - 2], 17) ^ rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		uint32 a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+		uint32 e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+		for (int i = 0; i < 64; ++i)
+		{
+			uint32 t1 = h + (rotate(e, 6) ^ rotate(e, 11) ^ rotate(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+			uint32 t2 = (rotate(a, 2) ^ rotate(a, 13) ^ rotate(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+			h = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+		state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+	}
+};
+
+NetGameDataHash NetHashGameData(const byte *data, size_t length)
+{
+	NetGameDataHash hash;
+	hash.length = static_cast<uint32>(length);
+
+	SHA256 sha;
+	sha.add(data, length);
+	sha.finish(hash.digest);
+
+	return hash;
+}
+
+static DirectorySpecifier get_cache_directory()
+{
+	DirectorySpecifier directory;
+	directory.SetToCacheDir();
+	directory += kCacheDirectoryName;
+	directory.MakeDirectory();
+
+	return directory;
+}
+
+static FileSpecifier get_cache_file(const NetGameDataHash& hash, const char *extension)
+{
+	char name[NetGameDataHash::kDigestSize * 2 + 8];
+	for (int i = 0; i < NetGameDataHash::kDigestSize; ++i)
+	{
+		snprintf(name + i * 2, 3, "%02x", hash.digest[i]);
+	}
+	snprintf(name + NetGameDataHash::kDigestSize * 2, 8, ".%s", extension);
+
+	FileSpecifier file = get_cache_directory();
+	file += name;
+
+	return file;
+}
+
+bool NetReadCachedGameData(const NetGameDataHash& hash, std::vector<byte>& data)
+{
+	if (hash.length == 0) return false;
+
+	FileSpecifier file = get_cache_file(hash, "dat");
+	OpenedFile opened_file;
+	if (!file.Exists() || !file.Open(opened_file)) return false;
+
+	int32 length = 0;
+	if (!opened_file.GetLength(length) || static_cast<uint32>(length) != hash.length) return false;
+
+	data.resize(hash.length);
+	if (!opened_file.Read(length, data.data()))
+	{
+		data.clear();
+		return false;
+	}
+	opened_file.Close();
+
+	if (NetHashGameData(data.data(), data.size()) != hash)
+	{
+		logWarning("cached network data %s is damaged; removing it", file.GetName().c_str());
+		data.clear();
+		file.Delete();
+		return false;
+	}
+
+	return true;
+}
+
+// oldest first, until there's room for one more
+static void trim_cache()
+{
+	std::vector<dir_entry> entries;
+	if (!get_cache_directory().ReadDirectory(entries)) return;
+
+	entries.erase(std::remove_if(entries.begin(), entries.end(), [](const dir_entry& entry) { return entry.is_directory; }), entries.end());
+	if (entries.size() < kMaximumCachedGameData) return;
+
+	std::sort(entries.begin(), entries.end(), [](const dir_entry& a, const dir_entry& b) { return a.date < b.date; });
+	for (size_t i = 0; i <= entries.size() - kMaximumCachedGameData; ++i)
+	{
+		FileSpecifier file = get_cache_directory();
+		file += entries[i].name;
+		file.Delete();
+	}
+}
+
+/* written under another name and renamed, so a half-written file is never read */
+void NetCacheGameData(const NetGameDataHash& hash, const byte *data, size_t length)
+{
+	if (length == 0 || length != hash.length) return;
+
+	FileSpecifier file = get_cache_file(hash, "dat");
+	if (file.Exists()) return;
+
+	trim_cache();
+
+	FileSpecifier temporary_file = get_cache_file(hash, "tmp");
+	OpenedFile opened_file;
+	if (!temporary_file.Open(opened_file, true)) return;
+
+	bool written = opened_file.Write(static_cast<int32>(length), const_cast<byte *>(data));
+	opened_file.Close();
+
+	if (!written || !temporary_file.Rename(file))
+	{
+		logWarning("couldn't cache network data in %s", file.GetName().c_str());
+		temporary_file.Delete();
+	}
+}
@@ -0,0 +1,56 @@
+#ifndef NETWORK_DATA_CACHE_H
+#define NETWORK_DATA_CACHE_H
+
+/*
+ *  network_data_cache.h
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ *  Joiners keep the maps, physics models and Lua scripts the gatherer sent them in the
+ *  cache directory, filed by their contents, so that next time the gatherer can send the
+ *  hashes alone and only stream what a joiner doesn't already have.
+ */
+
+#include "cseries.h"
+
+#include <vector>
+
+// names a piece of game data by its contents; two hashes that match are taken to be the
+// same data, so the digest has to be one nobody can find collisions for, or a gatherer
+// could plant its own script under the name of somebody else's
+struct NetGameDataHash
+{
+	enum { kDigestSize = 32 };
+
+	uint32 length;
+	uint8 digest[kDigestSize];	// SHA-256
+
+	bool operator==(const NetGameDataHash& other) const {
+		return length == other.length && memcmp(digest, other.digest, kDigestSize) == 0;
+	}
+	bool operator!=(const NetGameDataHash& other) const { return !(*this == other); }
+};
+
+NetGameDataHash NetHashGameData(const byte *data, size_t length);
+
+// false unless the cache holds data with this hash (checked again as it's read)
+bool NetReadCachedGameData(const NetGameDataHash& hash, std::vector<byte>& data);
+
+// keeps data, which must have this hash; the oldest entries go when the cache gets full
+void NetCacheGameData(const NetGameDataHash& hash, const byte *data, size_t length);
+
+#endif
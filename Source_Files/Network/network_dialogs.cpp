@@ -1356,7 +1356,7 @@ bool SetupNetgameDialog::SetupNetworkGameByRunning (
 		game_information->difficulty_level = active_network_preferences->difficulty_level;
 
 		game_information->initial_updates_per_packet = 1;
-		game_information->initial_update_latency = 0;
+		game_information->world_hash_interval = std::min<int32>(NetGetPreferredWorldHashInterval(), INT16_MAX);
 
 		game_information->initial_random_seed = resuming_game ? dynamic_world->random_seed : (uint16) machine_tick_count();
 
@@ -279,6 +279,33 @@ bool NetworkStatsMessage::reallyInflateFrom(AIStream& inputStream) {
 	return true;
 }
 
+void GameDataHashesMessage::reallyDeflateTo(AOStream& outputStream) const {
+	for (auto it = mHashes.begin(); it != mHashes.end(); ++it)
+	{
+		uint8 digest[NetGameDataHash::kDigestSize];
+		memcpy(digest, it->second.digest, sizeof(digest));
+
+		outputStream << it->first;
+		outputStream << it->second.length;
+		outputStream.write(digest, sizeof(digest));
+	}
+}
+
+bool GameDataHashesMessage::reallyInflateFrom(AIStream& inputStream) {
+	const uint32 entry_size = sizeof(uint16) + sizeof(uint32) + NetGameDataHash::kDigestSize;
+	while (inputStream.maxg() - inputStream.tellg() >= entry_size)
+	{
+		uint16 kind;
+		NetGameDataHash hash;
+		inputStream >> kind;
+		inputStream >> hash.length;
+		inputStream.read(hash.digest, NetGameDataHash::kDigestSize);
+
+		mHashes.push_back(std::make_pair(kind, hash));
+	}
+	return true;
+}
+
 void ServerWarningMessage::reallyDeflateTo(AOStream& outputStream) const {
   outputStream << (uint16) mReason;
   write_string(outputStream, mString.c_str());
@@ -320,7 +347,7 @@ void TopologyMessage::reallyDeflateTo(AOStream& outputStream) const {
   write_string(outputStream, mTopology.game_data.level_name);
   outputStream << mTopology.game_data.parent_checksum;
   outputStream << mTopology.game_data.initial_updates_per_packet;
-  outputStream << mTopology.game_data.initial_update_latency;
+  outputStream << mTopology.game_data.world_hash_interval;
 
   for (int i = 0; i < MAXIMUM_NUMBER_OF_NETWORK_PLAYERS; i++) {
     deflateNetPlayer(outputStream, mTopology.players[i]);
@@ -348,7 +375,7 @@ bool TopologyMessage::reallyInflateFrom(AIStream& inputStream) {
   read_string(inputStream, mTopology.game_data.level_name, MAX_LEVEL_NAME_LENGTH - 1);
   inputStream >> mTopology.game_data.parent_checksum;
   inputStream >> mTopology.game_data.initial_updates_per_packet;
-  inputStream >> mTopology.game_data.initial_update_latency;
+  inputStream >> mTopology.game_data.world_hash_interval;
 
   for (int i = 0; i < MAXIMUM_NUMBER_OF_NETWORK_PLAYERS; i++) {
     inflateNetPlayer(inputStream, mTopology.players[i]);
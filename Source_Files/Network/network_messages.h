@@ -28,6 +28,7 @@
 #include "Message.h"
 
 #include "network_capabilities.h"
+#include "network_data_cache.h"
 #include "network_private.h"
 
 enum {
@@ -55,6 +56,8 @@ enum {
   kREMOTE_HUB_READY_MESSAGE,
   kREMOTE_HUB_RESPONSE_MESSAGE,
   kREMOTE_HUB_REQUEST_MESSAGE,
+  kGAME_DATA_HASHES_MESSAGE,
+  kGAME_DATA_CACHED_MESSAGE,
 };
 
 template <MessageTypeID tMessageType, typename tValueType>
@@ -404,6 +407,34 @@ protected:
 	bool reallyInflateFrom(AIStream& inputStream);
 };
 
+// sent before the game data to joiners who can cache it, naming what's coming
+class GameDataHashesMessage : public SmallMessageHelper
+{
+public:
+	enum { kType = kGAME_DATA_HASHES_MESSAGE };
+	enum {
+		kPhysics = 0x1,
+		kMap = 0x2,
+		kLua = 0x4
+	};
+
+	GameDataHashesMessage() : SmallMessageHelper() { }
+
+	GameDataHashesMessage* clone() const {
+		return new GameDataHashesMessage(*this);
+	}
+
+	MessageTypeID type() const { return kType; }
+
+	std::vector<std::pair<uint16, NetGameDataHash>> mHashes;
+protected:
+	void reallyDeflateTo(AOStream& outputStream) const;
+	bool reallyInflateFrom(AIStream& inputStream);
+};
+
+// the joiner's answer: which of the GameDataHashesMessage kinds it already has
+typedef TemplatizedSimpleMessage<kGAME_DATA_CACHED_MESSAGE, uint16> GameDataCachedMessage;
+
 class ServerWarningMessage : public SmallMessageHelper
 {
 public:
@@ -43,11 +43,14 @@ enum {
         kEndOfMessagesMessageType = 0x454d,	// 'EM'
         kTimingAdjustmentMessageType = 0x5441,	// 'TA'
         kPlayerNetDeadMessageType = 0x4e44,	// 'ND'
+	kWorldHashMessageType = 0x5748,		// 'WH'
 
 	kSpokeToHubIdentification = 0x4944,   // 'ID'
 	kSpokeToHubGameDataPacketV1Magic = 0x5331, // 'S1'
 	kHubToSpokeGameDataPacketV1Magic = 0x4831, // 'H1'
 	kHubToSpokeGameDataPacketWithSpokeFlagsV1Magic = 0x4631, // 'F1'
+	kHubToSpokeGameDataPacketV2Magic = 0x4832, // 'H2': like 'H1', with compact ticks and flags
+	kHubToSpokeGameDataPacketWithSpokeFlagsV2Magic = 0x4632, // 'F2'
 	kPingRequestPacket = 0x5051, // 'PQ'
 	kPingResponsePacket = 0x5052, // 'PR'
 
@@ -80,6 +83,8 @@ extern int32 spoke_latency(); // in ms, kNetLatencyInvalid if not yet valid
 extern TickBasedActionQueue* spoke_get_unconfirmed_flags_queue();
 extern int32 spoke_get_smallest_unconfirmed_tick();
 extern bool spoke_check_world_update();
+extern int32 spoke_get_world_hash_interval();
+extern void spoke_report_world_hash(int32 inTick, uint64_t inHash);
 extern void DefaultSpokePreferences();
 extern InfoTree SpokePreferencesTree();
 extern void SpokeParsePreferencesTree(InfoTree prefs, std::string version);
@@ -0,0 +1,154 @@
+/*
+ *  network_star_flags.h
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+ *  Compact encoding of the action_flags in hub-to-spoke game data packets ('H2' and 'F2').
+ *
+ *  Tick numbers are zigzag varints.  Flags go in the same order as in 'H1' packets (tick-major,
+ *  the same players), but each is XORed with that player's previous flags in the same packet
+ *  (the first with 0, so packets still stand alone), and written as a varint token:
+ *
+ *	(delta << 1)			a nonzero delta
+ *	((run - 1) << 1) | 1		run unchanged flags in a row, across players and ticks
+ *
+ *  Players hardly ever change their flags from one tick to the next, so a packet's flags
+ *  usually shrink to one full set of flags and a few bytes of runs.
+ */
+
+#ifndef NETWORK_STAR_FLAGS_H
+#define NETWORK_STAR_FLAGS_H
+
+#include "cstypes.h"
+#include "AStream.h"
+
+#include <vector>
+
+typedef uint32 action_flags_t;	// as in network_star.h
+
+enum {
+	kCompactActionFlagsMaxLength = 5	// bytes, at most, in a tick number or token
+};
+
+static inline void
+write_varint(AOStream& ps, uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		ps << static_cast<uint8>(value | 0x80);
+		value >>= 7;
+	}
+	ps << static_cast<uint8>(value);
+}
+
+static inline uint64_t
+read_varint(AIStream& ps)
+{
+	uint64_t value = 0;
+	for (int shift = 0; shift < 64; shift += 7)
+	{
+		uint8 byte;
+		ps >> byte;
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return value;
+	}
+
+	throw AStream::failure("varint too long");
+}
+
+static inline void
+write_compact_tick(AOStream& ps, int32 tick)
+{
+	write_varint(ps, (static_cast<uint32>(tick) << 1) ^ static_cast<uint32>(tick >> 31));
+}
+
+static inline int32
+read_compact_tick(AIStream& ps)
+{
+	uint32 value = static_cast<uint32>(read_varint(ps));
+	return static_cast<int32>((value >> 1) ^ (0 - (value & 1)));
+}
+
+class CompactActionFlagsWriter
+{
+public:
+	CompactActionFlagsWriter(AOStream& ps, size_t inNumPlayers) : mStream(ps), mPreviousFlags(inNumPlayers, 0), mUnchanged(0) {}
+
+	void write(size_t inPlayerIndex, action_flags_t inFlags)
+	{
+		action_flags_t theDelta = inFlags ^ mPreviousFlags[inPlayerIndex];
+		mPreviousFlags[inPlayerIndex] = inFlags;
+		if (theDelta == 0)
+		{
+			mUnchanged++;
+		}
+		else
+		{
+			flush();
+			write_varint(mStream, static_cast<uint64_t>(theDelta) << 1);
+		}
+	}
+
+	// must be called after the last write()
+	void flush()
+	{
+		if (mUnchanged)
+		{
+			write_varint(mStream, (static_cast<uint64_t>(mUnchanged - 1) << 1) | 1);
+			mUnchanged = 0;
+		}
+	}
+
+private:
+	AOStream& mStream;
+	std::vector<action_flags_t> mPreviousFlags;
+	uint32 mUnchanged;
+};
+
+class CompactActionFlagsReader
+{
+public:
+	CompactActionFlagsReader(AIStream& ps, size_t inNumPlayers) : mStream(ps), mPreviousFlags(inNumPlayers, 0), mUnchanged(0) {}
+
+	action_flags_t read(size_t inPlayerIndex)
+	{
+		if (mUnchanged == 0)
+		{
+			uint64_t theToken = read_varint(mStream);
+			if (theToken & 1)
+				mUnchanged = static_cast<uint32>(theToken >> 1) + 1;
+			else
+				mPreviousFlags[inPlayerIndex] ^= static_cast<action_flags_t>(theToken >> 1);
+		}
+
+		if (mUnchanged)
+			mUnchanged--;
+
+		return mPreviousFlags[inPlayerIndex];
+	}
+
+	// whether a run continues past what the stream has left
+	bool pending() const { return mUnchanged > 0; }
+
+private:
+	AIStream& mStream;
+	std::vector<action_flags_t> mPreviousFlags;
+	uint32 mUnchanged;
+};
+
+#endif
@@ -45,6 +45,7 @@
 #if !defined(DISABLE_NETWORKING)
 
 #include "network_star.h"
+#include "network_star_flags.h"
 
 #include "TickBasedCircularQueue.h"
 #include "network_private.h"
@@ -150,7 +151,8 @@ enum {
 	kDefaultMinimumSendPeriod = 3,
 	kLatencyBufferSize = TICKS_PER_SECOND * 5, // store 5 seconds of ping counts
 	kDisplayLatencyWindow = TICKS_PER_SECOND * 1, // display last second's ping
-	kJitterUpdateInterval = TICKS_PER_SECOND * 1 / 2
+	kJitterUpdateInterval = TICKS_PER_SECOND * 1 / 2,
+	kWorldHashHistoryTicks = TICKS_PER_SECOND * 60 // how far behind the newest report to keep world hashes
 };
 
 
@@ -166,6 +168,7 @@ struct HubPreferences {
 	int32	mRecoverySendPeriod;
 	int32   mMinimumSendPeriod;
 	bool    mBandwidthReduction;
+	bool    mCompactActionFlags;	// send 'H2'/'F2' packets instead of 'H1'/'F1'
 };
 
 static HubPreferences sHubPreferences;
@@ -297,6 +300,17 @@ static AddressToPlayerIndexType	sAddressToPlayerIndex;
 typedef std::vector<NetworkPlayer_hub>	NetworkPlayerCollection;
 static NetworkPlayerCollection	sNetworkPlayers;
 
+// sWorldHashes holds, for each tick someone has reported a world hash for, the first hash
+// reported and who reported it.  Spokes all hash the same ticks (if they use the same interval),
+// so a later report for the same tick with a different hash means the game is out of sync.
+// We only complain about the first mismatch; after that everything is likely to differ.
+struct WorldHashReport {
+	uint64_t	mHash;
+	int	mPlayerIndex;
+};
+static std::map<int32, WorldHashReport> sWorldHashes;
+static bool sWorldHashMismatchReported;
+
 // Local player index is used to decide how to send a packet; ref is used for timing.
 static int			sLocalPlayerIndex;
 static int			sReferencePlayerIndex;
@@ -322,6 +336,7 @@ static void hub_update_player_pregame_state(int inPlayerIndex, int16 state);
 static void hub_received_ping_request(AIStream& ps, const IPaddress& address);
 static void hub_received_ping_response(AIStream& ps, const IPaddress& address);
 static void process_messages(AIStream& ps, int inSenderIndex);
+static void hub_received_world_hash(int inSenderIndex, int32 inTick, uint64_t inHash);
 static void make_player_netdead(int inPlayerIndex);
 static bool hub_tick();
 static void send_packets();
@@ -509,6 +524,8 @@ hub_initialize(int32 inStartingTick, int inNumPlayers, const IPaddress* const* i
         sLastNetworkTickSent = 0;
 	sLastRealUpdate = 0;
 	sLaggingPlayersBitmask = 0;
+	sWorldHashes.clear();
+	sWorldHashMismatchReported = false;
 
         sHubActive = true;
 
@@ -1139,12 +1156,40 @@ process_messages(AIStream& ps, int inSenderIndex)
                                 done = true;
                                 break;
 
+			case kWorldHashMessageType:
+			{
+				int32 theTick;
+				uint32 theHashHigh, theHashLow;
+				ps >> theTick >> theHashHigh >> theHashLow;
+				hub_received_world_hash(inSenderIndex, theTick, (((uint64_t)theHashHigh) << 32) | theHashLow);
+			}
+				break;
+
                         default:
                                 break;
                 }
         }
 }
 
+static void
+hub_received_world_hash(int inSenderIndex, int32 inTick, uint64_t inHash)
+{
+	std::map<int32, WorldHashReport>::iterator i = sWorldHashes.find(inTick);
+	if(i == sWorldHashes.end())
+	{
+		WorldHashReport theReport = { inHash, inSenderIndex };
+		sWorldHashes[inTick] = theReport;
+
+		// Reports arrive roughly in tick order; forget the ones too old to matter
+		sWorldHashes.erase(sWorldHashes.begin(), sWorldHashes.lower_bound(sWorldHashes.rbegin()->first - kWorldHashHistoryTicks));
+	}
+	else if(i->second.mHash != inHash && !sWorldHashMismatchReported)
+	{
+		logWarningNMT("game is out of sync: world hash for tick %d is %08x%08x for player %d but %08x%08x for player %d", inTick, (uint32)(i->second.mHash >> 32), (uint32)i->second.mHash, i->second.mPlayerIndex, (uint32)(inHash >> 32), (uint32)inHash, inSenderIndex);
+		sWorldHashMismatchReported = true;
+	}
+}
+
 static void
 make_player_netdead(int inPlayerIndex)
 {
@@ -1361,9 +1406,14 @@ send_packets()
 			AOStreamBE hdr(sOutgoingFrame.buffer.data(), kStarPacketHeaderSize);
                         AOStreamBE ps(sOutgoingFrame.buffer.data(), ddpMaxData, kStarPacketHeaderSize);
 
+			const bool compact = sHubPreferences.mCompactActionFlags;
+
                         try {
                                 // acknowledgement
-                                ps << getFlagsQueue(i).getWriteTick();
+                                if(compact)
+                                        write_compact_tick(ps, getFlagsQueue(i).getWriteTick());
+                                else
+                                        ps << getFlagsQueue(i).getWriteTick();
         
                                 // Messages
                                 // Timing adjustment?
@@ -1419,8 +1469,8 @@ send_packets()
 						int maxTicks = 4 * effectiveLatency;
 
 						int bytesAvailableForFlags = ps.maxp() - ps.tellp() - 4; // have to encode the tick
-						// don't run out of room in the packet, though
-						if (maxTicks * sNetworkPlayers.size() * 4 > bytesAvailableForFlags) 
+						// don't run out of room in the packet, though (compact flags check as they go)
+						if (!compact && maxTicks * sNetworkPlayers.size() * 4 > bytesAvailableForFlags) 
 						{
 							int maximumBytesPerTick = sNetworkPlayers.size() * 4;
 							maxTicks = bytesAvailableForFlags / maximumBytesPerTick;
@@ -1473,23 +1523,39 @@ send_packets()
         
                                 // Now, encode the flags in tick-major order (this is much easier to decode
                                 // at the other end)
+				CompactActionFlagsWriter compactFlags(ps, sNetworkPlayers.size());
                                 for(int32 tick = startTick; tick < endTick; tick++)
                                 {
+					// the spoke takes however many whole ticks fit; a tick's worst case is a
+					// run and a delta for every player, then the start tick and the last run
+					if(compact && ps.maxp() - ps.tellp() < kCompactActionFlagsMaxLength * (2 * sNetworkPlayers.size() + 2))
+						break;
+
                                         for(size_t j = 0; j < sNetworkPlayers.size(); j++)
                                         {
                                                 if(tick < theSmallestTickWeWontSend[j])
                                                 {
                                                         if(!haveSentStartTick)
                                                         {
-                                                                ps << tick;
+                                                                if(compact)
+                                                                        write_compact_tick(ps, tick);
+                                                                else
+                                                                        ps << tick;
                                                                 haveSentStartTick = true;
                                                         }
-                                                        ps << getFlagsQueue(j).peek(tick);
+                                                        if(compact)
+                                                                compactFlags.write(j, getFlagsQueue(j).peek(tick));
+                                                        else
+                                                                ps << getFlagsQueue(j).peek(tick);
                                                 }
                                         }
                                 }
+				compactFlags.flush();
 				
-				hdr << (uint16) (reflectFlags ? kHubToSpokeGameDataPacketWithSpokeFlagsV1Magic : kHubToSpokeGameDataPacketV1Magic);
+				if(compact)
+					hdr << (uint16) (reflectFlags ? kHubToSpokeGameDataPacketWithSpokeFlagsV2Magic : kHubToSpokeGameDataPacketV2Magic);
+				else
+					hdr << (uint16) (reflectFlags ? kHubToSpokeGameDataPacketWithSpokeFlagsV1Magic : kHubToSpokeGameDataPacketV1Magic);
 
 				// blank out the CRC field before calculating
 				sOutgoingFrame.buffer[2] = 0;
@@ -1503,7 +1569,7 @@ send_packets()
                                 if(i == sLocalPlayerIndex)
                                         send_frame_to_local_spoke(sOutgoingFrame);
                                 else
-                                        NetDDPSendFrame(sOutgoingFrame, thePlayer.mAddress);
+                                        NetDDPQueueFrame(sOutgoingFrame, thePlayer.mAddress);
                         } // try
                         catch (...)
                         {
@@ -1514,6 +1580,9 @@ send_packets()
 
         } // iterate over players
 
+	// everyone's packets for this tick go out together
+	NetDDPFlushFrames();
+
         sLastNetworkTickSent = sNetworkTicker;
 	sSmallestUnsentTick = sSmallestIncompleteTick;
 	
@@ -1610,6 +1679,7 @@ void HubParsePreferencesTree(InfoTree prefs, std::string version)
 	}
 
 	prefs.read_attr("use_bandwidth_reduction", sHubPreferences.mBandwidthReduction);
+	prefs.read_attr("use_compact_action_flags", sHubPreferences.mCompactActionFlags);
 
 		
 	// The checks above are not sufficient to catch all bad cases; if user specified a window size
@@ -1634,6 +1704,7 @@ InfoTree HubPreferencesTree()
 	for (size_t i = 0; i < kNumAttributes; ++i)
 		root.put_attr(sAttributeStrings[i], *(sAttributeDestinations[i]));
 	root.put_attr("use_bandwidth_reduction", sHubPreferences.mBandwidthReduction);
+	root.put_attr("use_compact_action_flags", sHubPreferences.mCompactActionFlags);
 	
 	return root;
 }
@@ -1646,6 +1717,7 @@ DefaultHubPreferences()
 	for(size_t i = 0; i < kNumAttributes; i++)
 		*(sAttributeDestinations[i]) = sDefaultHubPreferences[i];
 	sHubPreferences.mBandwidthReduction = true;
+	sHubPreferences.mCompactActionFlags = true;
 /*
 	sHubPreferences.mPregameWindowSize = kDefaultPregameWindowSize;
 	sHubPreferences.mInGameWindowSize = kDefaultInGameWindowSize;
@@ -36,6 +36,7 @@
 #if !defined(DISABLE_NETWORKING)
 
 #include "network_star.h"
+#include "network_star_flags.h"
 #include "AStream.h"
 #include "mytm.h"
 #include "network_private.h" // kPROTOCOL_TYPE
@@ -56,7 +57,8 @@ enum {
         kDefaultOutgoingFlagsQueueSize = TICKS_PER_SECOND / 2,
         kDefaultRecoverySendPeriod = TICKS_PER_SECOND / 2,
 	kDefaultTimingWindowSize = 3 * TICKS_PER_SECOND,
-	kDefaultTimingNthElement = kDefaultTimingWindowSize / 2
+	kDefaultTimingNthElement = kDefaultTimingWindowSize / 2,
+	kDefaultWorldHashInterval = TICKS_PER_SECOND
 };
 
 struct SpokePreferences
@@ -67,6 +69,7 @@ struct SpokePreferences
 	int32	mRecoverySendPeriod;
 	int32	mTimingWindowSize;
 	int32	mTimingNthElement;
+	int32	mWorldHashInterval;
 	bool	mAdjustTiming;
 };
 
@@ -119,6 +122,12 @@ static int32 sTimingMeasurement;
 static bool sHeardFromHub = false;
 static bool sWorldUpdate = false;
 
+// The most recent hash of the game world, which we include in every packet until there's a
+// newer one; the hub compares them across players to notice games that have gone out of sync.
+static bool sHaveWorldHash;
+static int32 sWorldHashTick;
+static uint64_t sWorldHash;
+
 static vector<int32> sDisplayLatencyBuffer; // stores the last 30 latency calculations, in ticks
 static uint32 sDisplayLatencyCount = 0;
 static int32 sDisplayLatencyTicks = 0; // sum of the latency ticks from the last 30 seconds, using above two
@@ -126,7 +135,7 @@ static int32 sDisplayLatencyTicks = 0; // sum of the latency ticks from the last
 static int32 sSmallestUnconfirmedTick;
 
 static void spoke_became_disconnected();
-static void spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags);
+static void spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags, bool compact_flags = false);
 static void spoke_received_ping_request(AIStream& ps, const IPaddress& address);
 static void spoke_received_ping_response(AIStream& ps, const IPaddress& address);
 static void process_messages(AIStream& ps, IncomingGameDataPacketProcessingContext& context);
@@ -213,6 +222,7 @@ spoke_initialize(const IPaddress& inHubAddress, int32 inFirstTick, size_t inNumb
 
         sNetworkTicker = 0;
 		sWorldUpdate = false;
+	sHaveWorldHash = false;
         sLastNetworkTickHeard = 0;
         sLastNetworkTickSent = 0;
         sConnected = true;
@@ -341,6 +351,14 @@ spoke_received_network_packet(UDPpacket& inPacket)
 		case kHubToSpokeGameDataPacketWithSpokeFlagsV1Magic:
 			spoke_received_game_data_packet_v1(ps, true);
 			break;
+
+		case kHubToSpokeGameDataPacketV2Magic:
+			spoke_received_game_data_packet_v1(ps, false, true);
+			break;
+
+		case kHubToSpokeGameDataPacketWithSpokeFlagsV2Magic:
+			spoke_received_game_data_packet_v1(ps, true, true);
+			break;
 		
 		case kPingRequestPacket:
 			spoke_received_ping_request(ps, inPacket.address);
@@ -364,8 +382,9 @@ spoke_received_network_packet(UDPpacket& inPacket)
 
 
 
+// compact_flags: an 'H2' or 'F2' packet, whose ticks and flags are as in network_star_flags.h
 static void
-spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags)
+spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags, bool compact_flags)
 {
 	sHeardFromHub = true;
 
@@ -373,7 +392,10 @@ spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags)
         
         // Piggybacked ACK
         int32 theSmallestUnacknowledgedTick;
-        ps >> theSmallestUnacknowledgedTick;
+        if(compact_flags)
+                theSmallestUnacknowledgedTick = read_compact_tick(ps);
+        else
+                ps >> theSmallestUnacknowledgedTick;
 
 	// we can get an early ACK only if the server made up flags for us...
 	if (theSmallestUnacknowledgedTick > sOutgoingFlags.getWriteTick())
@@ -468,7 +490,10 @@ spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags)
 	} // no data left in packet
 
         int32 theSmallestUnreadTick;
-        ps >> theSmallestUnreadTick;
+        if(compact_flags)
+                theSmallestUnreadTick = read_compact_tick(ps);
+        else
+                ps >> theSmallestUnreadTick;
 
         // Can't accept packets that skip ticks
         if(theSmallestUnreadTick > sSmallestUnreceivedTick)
@@ -511,7 +536,8 @@ spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags)
         // The body of this loop is a bit more convoluted than you might
         // expect, because the same loop is used to skip already-seen action_flags
         // and to enqueue new ones.
-	while(ps.tellg() < ps.maxg())
+	CompactActionFlagsReader compactFlags(ps, sNetworkPlayers.size());
+	while(ps.tellg() < ps.maxg() || compactFlags.pending())
         {
                 // If we've no room to enqueue stuff, no point in finishing reading the packet.
                 if(theSmallestQueueSpace <= 0)
@@ -570,7 +596,10 @@ spoke_received_game_data_packet_v1(AIStream& ps, bool reflected_flags)
                                 // We should have a flag for this player for this tick!
 				try 
 				{
-					ps >> theFlags;
+					if(compact_flags)
+						theFlags = compactFlags.read(i);
+					else
+						ps >> theFlags;
 				}
 				catch (const AStream::failure& f)
 				{
@@ -857,6 +886,23 @@ bool spoke_check_world_update()
 	return false;
 }
 
+int32 spoke_get_world_hash_interval()
+{
+	return sSpokePreferences.mWorldHashInterval;
+}
+
+void spoke_report_world_hash(int32 inTick, uint64_t inHash)
+{
+	if(take_mytm_mutex())
+	{
+		sWorldHashTick = inTick;
+		sWorldHash = inHash;
+		sHaveWorldHash = true;
+
+		release_mytm_mutex();
+	}
+}
+
 static void
 send_packet()
 {
@@ -870,6 +916,15 @@ send_packet()
                 // Acknowledgement
                 ps << sSmallestUnreceivedTick;
 
+		// Most recent world hash
+		if(sHaveWorldHash)
+		{
+			ps << (uint16)kWorldHashMessageType
+			   << sWorldHashTick
+			   << (uint32)(sWorldHash >> 32)
+			   << (uint32)sWorldHash;
+		}
+
                 // No more messages
                 ps << (uint16)kEndOfMessagesMessageType;
         
@@ -960,6 +1015,7 @@ enum {
 	kRecoverySendPeriodAttribute,
 	kTimingWindowSizeAttribute,
 	kTimingNthElementAttribute,
+	kWorldHashIntervalAttribute,
 	kNumInt32Attributes,
 	kAdjustTimingAttribute = kNumInt32Attributes,
 	kNumAttributes
@@ -972,7 +1028,8 @@ static const char* sAttributeStrings[kNumInt32Attributes] =
 //	"outgoing_flags_queue_size",
 	"recovery_send_period",
 	"timing_window_size",
-	"timing_nth_element"
+	"timing_nth_element",
+	"world_hash_interval"
 };
 
 static int32* sAttributeDestinations[kNumInt32Attributes] =
@@ -982,7 +1039,8 @@ static int32* sAttributeDestinations[kNumInt32Attributes] =
 //	&sSpokePreferences.mOutgoingFlagsQueueSize,
 	&sSpokePreferences.mRecoverySendPeriod,
 	&sSpokePreferences.mTimingWindowSize,
-	&sSpokePreferences.mTimingNthElement
+	&sSpokePreferences.mTimingNthElement,
+	&sSpokePreferences.mWorldHashInterval
 };
 
 
@@ -1002,6 +1060,7 @@ void SpokeParsePreferencesTree(InfoTree prefs, std::string version)
 					min = 1;
 					break;
 				case kTimingNthElementAttribute:
+				case kWorldHashIntervalAttribute:
 					min = 0;
 					break;
 			}
@@ -1048,6 +1107,7 @@ DefaultSpokePreferences()
 	sSpokePreferences.mRecoverySendPeriod = kDefaultRecoverySendPeriod;
 	sSpokePreferences.mTimingWindowSize = kDefaultTimingWindowSize;
 	sSpokePreferences.mTimingNthElement = kDefaultTimingNthElement;
+	sSpokePreferences.mWorldHashInterval = kDefaultWorldHashInterval;
 	sSpokePreferences.mAdjustTiming = true;
 }
 
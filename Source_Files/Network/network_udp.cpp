@@ -35,6 +35,9 @@
 #include "cseries.h"
 #include "network_private.h"
 #include "mytm.h" // mytm_mutex stuff
+#include "Logging.h"
+
+#include <vector>
 
 // Keep track of our one sending/receiving socket
 static std::unique_ptr<UDPsocket> sSocket;
@@ -44,32 +47,131 @@ static std::atomic_bool sKeepListening = false;
 // Keep track of the receiving thread
 static SDL_Thread* sReceivingThread = NULL;
 
-// ZZZ: the socket listening thread loops in this function.  It calls the registered
-// packet handler when it gets something.
+// Packets the receiving thread got while the mytm mutex was taken.  The receiving thread is
+// the only one to add to the ring; whoever holds the mutex takes them out, so there is only
+// ever one of either at a time and neither has to wait for the other.
+enum {
+	kReceiveQueueSize = 256	// a few ticks' worth of packets for a full hub
+};
+
+static std::vector<UDPpacket> sReceiveQueue;
+static std::atomic<uint32> sReceiveQueueHead(0);	// next packet to handle
+static std::atomic<uint32> sReceiveQueueTail(0);	// next free slot
+
+// only the receiving thread counts
+static struct {
+	std::atomic<uint32> packets;
+	std::atomic<uint32> deferred;
+	std::atomic<uint32> overflows;
+	std::atomic<uint32> max_queue_depth;
+} sReceiveStats;
+
+static bool
+receive_queue_pending() {
+	return sReceiveQueueHead.load(std::memory_order_acquire) != sReceiveQueueTail.load(std::memory_order_acquire);
+}
+
+// mytm deferred work: call with the mytm mutex held
+static void
+handle_queued_packets() {
+	uint32 head = sReceiveQueueHead.load(std::memory_order_relaxed);
+	while (head != sReceiveQueueTail.load(std::memory_order_acquire))
+	{
+		sPacketHandler(sReceiveQueue[head]);
+		head = (head + 1) % kReceiveQueueSize;
+		sReceiveQueueHead.store(head, std::memory_order_release);
+	}
+}
+
+static bool
+enqueue_packet(const UDPpacket& packet) {
+	uint32 tail = sReceiveQueueTail.load(std::memory_order_relaxed);
+	uint32 next = (tail + 1) % kReceiveQueueSize;
+	uint32 head = sReceiveQueueHead.load(std::memory_order_acquire);
+	if (next == head)
+		return false;
+
+	UDPpacket& slot = sReceiveQueue[tail];
+	slot.address = packet.address;
+	slot.data_size = packet.data_size;
+	memcpy(slot.buffer.data(), packet.buffer.data(), packet.data_size);
+	sReceiveQueueTail.store(next, std::memory_order_release);
+
+	uint32 depth = (next + kReceiveQueueSize - head) % kReceiveQueueSize;
+	if (depth > sReceiveStats.max_queue_depth)
+		sReceiveStats.max_queue_depth = depth;
+	return true;
+}
+
+// returns false if the packet had to be handled then and there
+static bool
+queue_packet(UDPpacket& packet) {
+	sReceiveStats.packets++;
+
+	if (!enqueue_packet(packet))
+	{
+		// nobody has drained the ring for a while; wait our turn, as we always used to
+		sReceiveStats.overflows++;
+		if (take_mytm_mutex())
+		{
+			handle_queued_packets();
+			sPacketHandler(packet);
+			release_mytm_mutex();
+		}
+		return false;
+	}
+
+	return true;
+}
+
+static void
+deliver_queued_packets(uint32 count) {
+	// Publish the packets before looking at the mutex; releasing it looks at the ring after
+	// letting go, so one of us is sure to see the other.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (try_take_mytm_mutex())
+		release_mytm_mutex();	// handles the ring
+	else
+		sReceiveStats.deferred += count;
+}
+
+enum {
+	kReceiveBatchSize = 32
+};
+
+// ZZZ: the socket listening thread loops in this function.  It hands what it gets to the
+// registered packet handler, right away when it can and otherwise by way of the ring.
 static int
 receive_thread_function(void*) {
 
 	UDPpacket packet;
 	sSocket->register_receive_async(packet);
 
-	bool got_packet = false;
-	int receive_result = 0;
+	// whatever else arrived along with it, fetched all at once
+	std::vector<UDPpacket> batch(kReceiveBatchSize);
 
 	while (sKeepListening) {
 
-		if (!got_packet)
+		int receive_result = sSocket->receive_async(1000);
+		if (receive_result > 0)
 		{
-			receive_result = sSocket->receive_async(1000);
-			got_packet = receive_result > 0;
-		}
+			uint32 queued = queue_packet(packet) ? 1 : 0;
 
-		if (got_packet && take_mytm_mutex()) {
-			sPacketHandler(packet);
-			release_mytm_mutex();
-			got_packet = false;
+			int64_t received;
+			do {
+				received = sSocket->receive_batch(batch.data(), batch.size());
+				for (int64_t i = 0; i < received; i++)
+				{
+					if (queue_packet(batch[i]))
+						queued++;
+				}
+			} while (received == kReceiveBatchSize && sKeepListening);
+
+			if (queued)
+				deliver_queued_packets(queued);
 		}
 
-		if (!got_packet && receive_result != 0)
+		if (receive_result != 0)
 		{
 			sSocket->register_receive_async(packet);
 		}
@@ -78,6 +180,16 @@ receive_thread_function(void*) {
 	return 0;
 }
 
+NetDDPReceiveStats NetDDPGetReceiveStats()
+{
+	NetDDPReceiveStats stats;
+	stats.packets = sReceiveStats.packets;
+	stats.deferred = sReceiveStats.deferred;
+	stats.overflows = sReceiveStats.overflows;
+	stats.max_queue_depth = sReceiveStats.max_queue_depth;
+	return stats;
+}
+
 /*
  *  Open socket
  */
@@ -90,6 +202,15 @@ bool NetDDPOpenSocket(uint16_t ioPortNumber, PacketHandlerProcPtr packetHandler)
 	if (!sSocket) return false;
 
 	// Set up receiver
+	sReceiveQueue.resize(kReceiveQueueSize);
+	sReceiveQueueHead = 0;
+	sReceiveQueueTail = 0;
+	sReceiveStats.packets = 0;
+	sReceiveStats.deferred = 0;
+	sReceiveStats.overflows = 0;
+	sReceiveStats.max_queue_depth = 0;
+	set_mytm_deferred_work(receive_queue_pending, handle_queued_packets);
+
 	sKeepListening = true;
 	sPacketHandler = packetHandler;
 	sReceivingThread = SDL_CreateThread(receive_thread_function, "NetDDPOpenSocket_ReceivingThread", NULL);
@@ -113,6 +234,11 @@ bool NetDDPCloseSocket()
 		sKeepListening = false;
 		SDL_WaitThread(sReceivingThread, NULL);
 		sReceivingThread = NULL;
+
+		set_mytm_deferred_work(NULL, NULL);
+		NetDDPReceiveStats stats = NetDDPGetReceiveStats();
+		logNote("received %u packets: %u while the mutex was taken (at most %u waiting), %u with the ring full",
+			stats.packets, stats.deferred, stats.max_queue_depth, stats.overflows);
 	}
 
 	sSocket.reset();
@@ -123,6 +249,38 @@ bool NetDDPCloseSocket()
  *  Send frame to remote machine
  */
 
+// Frames queued to go out together; only touched with the mytm mutex held
+static std::vector<UDPpacket> sOutgoingFrames;
+static size_t sOutgoingFrameCount = 0;
+
+enum {
+	kOutgoingBatchSize = 64
+};
+
+void NetDDPQueueFrame(const UDPpacket& frame, const IPaddress& address)
+{
+	assert(frame.data_size <= ddpMaxData);
+	if (sOutgoingFrames.size() < kOutgoingBatchSize)
+		sOutgoingFrames.resize(kOutgoingBatchSize);
+	else if (sOutgoingFrameCount == sOutgoingFrames.size())
+		NetDDPFlushFrames();
+
+	UDPpacket& queued = sOutgoingFrames[sOutgoingFrameCount++];
+	queued.address = address;
+	queued.data_size = frame.data_size;
+	memcpy(queued.buffer.data(), frame.buffer.data(), frame.data_size);
+}
+
+int NetDDPFlushFrames()
+{
+	if (sOutgoingFrameCount == 0)
+		return 0;
+
+	int sent = sSocket ? sSocket->send_batch(sOutgoingFrames.data(), sOutgoingFrameCount) : 0;
+	sOutgoingFrameCount = 0;
+	return sent;
+}
+
 bool NetDDPSendFrame(UDPpacket& frame, const IPaddress& address)
 {
 	assert(frame.data_size <= ddpMaxData);
@@ -54,6 +54,12 @@ public:
 
 	bool LoadFromFile(FileSpecifier& File, int ImgMode, int flags, int actual_width = 0, int actual_height = 0, int maxSize = 0);
 
+	// LoadFromFile() for a color image and, if OpacityFile is given, the opacity image that
+	// goes with it; what they decode to is kept in the cache directory as a DDS file, keyed by
+	// the files' contents and the flags, so loading them again just reads that back.  DDS
+	// files need no decoding and are loaded directly.
+	bool LoadFromFileCached(FileSpecifier& File, FileSpecifier *OpacityFile, int flags, int actual_width = 0, int actual_height = 0, int maxSize = 0);
+
 	// Size of level 0 image
 	int GetWidth() const {return Width;}
 	int GetHeight() const {return Height;}
@@ -120,6 +126,8 @@ private:
 	bool LoadDDSFromFile(FileSpecifier& File, int flags, int actual_width = 0, int actual_height = 0, int maxSize = 0);
 	bool LoadMipMapFromFile(OpenedFile &File, int flags, int level, DDSURFACEDESC2 &ddsd, int skip);
 	bool SkipMipMapFromFile(OpenedFile &File, int flags, int level, DDSURFACEDESC2 &ddsd);
+	bool LoadFromImageCache(FileSpecifier& File, int flags, int maxSize);
+	bool SaveToImageCache(FileSpecifier& File);
 
 	ImageFormat Format;
 };
@@ -204,7 +212,8 @@ enum {
 	ImageLoader_CanUseDXTC = 0x2,
 	ImageLoader_LoadMipMaps = 0x4,
 	ImageLoader_LoadDXTC1AsDXTC3 = 0x8,
-	ImageLoader_ImageIsAlreadyPremultiplied = 0x10
+	ImageLoader_ImageIsAlreadyPremultiplied = 0x10,
+	ImageLoader_LeaveOversized = 0x20 // don't Minify() to maxSize (it needs the GL context)
 };
 // Returns whether or not the loading was successful
 //bool LoadImageFromFile(ImageDescriptor& Img, FileSpecifier& File, int ImgMode, int flags, int maxSize = 0);
@@ -51,8 +51,14 @@
 #endif
 #endif
 
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <functional>
+#include <mutex>
 #include <stdlib.h>
+#include <thread>
+#include <vector>
 
 using std::min;
 using std::max;
@@ -538,7 +544,7 @@ bool ImageDescriptor::LoadDDSFromFile(FileSpecifier& File, int flags, int actual
 
 		if (!LoadMipMapFromFile(dds_file, flags, 0, ddsd, 0)) return false;
 
-		while (this->Width > maxSize || this->Height > maxSize)
+		while (!(flags & ImageLoader_LeaveOversized) && (this->Width > maxSize || this->Height > maxSize))
 		{
 			if (!Minify()) return false;
 		}
@@ -551,6 +557,354 @@ bool ImageDescriptor::LoadDDSFromFile(FileSpecifier& File, int flags, int actual
 	return true;
 }
 
+// Decoded images are kept in the cache directory as uncompressed DDS files, named by a hash
+// of what they were decoded from.  The image size before any padding to powers of two goes
+// in the first reserved words of the header, since the texture coordinates are scaled by it.
+// Bump the version whenever LoadFromFile() would decode a file differently.
+//
+// Hashing a file means reading all of it, so each source file also gets a small stamp,
+// named by a hash of its path, size and modification time, that holds the content hash it
+// had; the contents are only read again once one of those changes.
+static const uint32 ImageCacheTag = FOUR_CHARS_TO_INT('A', '1', 'I', 'C');
+static const uint32 ImageCacheVersion = 1;
+
+// the flags that make a difference to what an image file decodes to
+static const int ImageCacheKeyFlags = ImageLoader_ResizeToPowersOfTwo | ImageLoader_ImageIsAlreadyPremultiplied;
+
+// the oldest files go once either is passed, until the cache is back under three quarters
+static const int64_t MaximumImageCacheBytes = 2048LL * 1024 * 1024;
+static const size_t MaximumImageCacheFiles = 8192;	// images and stamps together
+
+static bool ReadFileContents(FileSpecifier& File, std::vector<uint8>& Contents)
+{
+	OpenedFile file;
+	int32 length;
+	if (!File.Open(file) || !file.GetLength(length) || length < 0) return false;
+
+	Contents.resize(length);
+	return length == 0 || file.Read(length, &Contents.front());
+}
+
+// FNV-1a
+static uint64_t HashImageCacheKey(uint64_t hash, const void *data, size_t size)
+{
+	const uint8 *bytes = static_cast<const uint8 *>(data);
+	for (size_t i = 0; i < size; i++)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+static DirectorySpecifier GetImageCacheDirectory()
+{
+	DirectorySpecifier directory;
+	directory.SetToCacheDir();
+	directory += "Textures";
+	directory.MakeDirectory();
+	return directory;
+}
+
+static FileSpecifier GetImageCacheFile(uint64_t key, const char *extension)
+{
+	char name[64];
+	snprintf(name, sizeof(name), "%016llx.%s", static_cast<unsigned long long>(key), extension);
+
+	FileSpecifier file = GetImageCacheDirectory();
+	file += name;
+	return file;
+}
+
+static uint64_t HashImageFileStamp(uint64_t hash, FileSpecifier& File, bool& stamped)
+{
+	OpenedFile file;
+	int32 length;
+	TimeType date = File.GetDate();
+	if (!date || !File.Open(file) || !file.GetLength(length))
+	{
+		stamped = false;
+		return hash;
+	}
+
+	int64_t modified = date;
+	std::string path = File.GetPath();
+	hash = HashImageCacheKey(hash, path.data(), path.size() + 1);
+	hash = HashImageCacheKey(hash, &length, sizeof(length));
+	return HashImageCacheKey(hash, &modified, sizeof(modified));
+}
+
+static bool ReadImageStamp(uint64_t stampKey, uint64_t& key)
+{
+	FileSpecifier stampFile = GetImageCacheFile(stampKey, "stamp");
+	OpenedFile file;
+	int32 length;
+	uint8 stamp[12];
+	if (!stampFile.Exists() || !stampFile.Open(file) || !file.GetLength(length) || length != sizeof(stamp) || !file.Read(sizeof(stamp), stamp)) return false;
+
+	uint32 tag, low, high;
+	AIStreamLE inputStream(stamp, sizeof(stamp));
+	try {
+		inputStream >> tag;
+		inputStream >> low;
+		inputStream >> high;
+	} catch (const AStream::failure&) {
+		return false;
+	}
+	key = static_cast<uint64_t>(high) << 32 | low;
+	return tag == ImageCacheTag;
+}
+
+static std::mutex ImageCacheMutex;
+static bool ImageCacheMeasured = false;
+static int64_t ImageCacheBytes = 0;
+static size_t ImageCacheFiles = 0;
+
+// measures the cache and, if it's too big, removes the oldest files
+static void TrimImageCache()
+{
+	struct cached_file {
+		std::string name;
+		TimeType date;
+		int64_t bytes;
+	};
+
+	DirectorySpecifier directory = GetImageCacheDirectory();
+	std::vector<dir_entry> entries;
+	if (!directory.ReadDirectory(entries)) return;
+
+	std::vector<cached_file> files;
+	ImageCacheBytes = 0;
+	for (const auto& entry : entries)
+	{
+		if (entry.is_directory) continue;
+
+		FileSpecifier file = directory + entry.name;
+		OpenedFile opened;
+		int32 length = 0;
+		if (file.Open(opened)) opened.GetLength(length);
+
+		files.push_back({ entry.name, entry.date, length });
+		ImageCacheBytes += length;
+	}
+	ImageCacheFiles = files.size();
+	ImageCacheMeasured = true;
+
+	if (ImageCacheBytes <= MaximumImageCacheBytes && ImageCacheFiles <= MaximumImageCacheFiles) return;
+
+	std::sort(files.begin(), files.end(), [](const cached_file& a, const cached_file& b) { return a.date < b.date; });
+	for (const auto& file : files)
+	{
+		if (ImageCacheBytes <= MaximumImageCacheBytes / 4 * 3 && ImageCacheFiles <= MaximumImageCacheFiles / 4 * 3) break;
+
+		FileSpecifier cacheFile = directory + file.name;
+		if (cacheFile.Delete())
+		{
+			ImageCacheBytes -= file.bytes;
+			--ImageCacheFiles;
+		}
+	}
+}
+
+static void NoteImageCacheWrite(int64_t bytes)
+{
+	std::lock_guard<std::mutex> lock(ImageCacheMutex);
+
+	if (!ImageCacheMeasured)
+	{
+		TrimImageCache();
+	}
+
+	ImageCacheBytes += bytes;
+	++ImageCacheFiles;
+	if (ImageCacheBytes > MaximumImageCacheBytes || ImageCacheFiles > MaximumImageCacheFiles)
+	{
+		TrimImageCache();
+	}
+}
+
+static void WriteImageStamp(uint64_t stampKey, uint64_t key)
+{
+	uint8 stamp[12];
+	AOStreamLE outputStream(stamp, sizeof(stamp));
+	try {
+		outputStream << ImageCacheTag;
+		outputStream << uint32(key);
+		outputStream << uint32(key >> 32);
+	} catch (const AStream::failure&) {
+		return;
+	}
+
+	// a torn stamp fails the length check and is written again
+	FileSpecifier stampFile = GetImageCacheFile(stampKey, "stamp");
+	OpenedFile file;
+	if (!stampFile.Open(file, true)) return;
+	bool written = file.Write(sizeof(stamp), stamp);
+	file.Close();
+
+	if (written)
+		NoteImageCacheWrite(sizeof(stamp));
+	else
+		stampFile.Delete();
+}
+
+bool ImageDescriptor::LoadFromFileCached(FileSpecifier& File, FileSpecifier *OpacityFile, int flags, int actual_width, int actual_height, int maxSize)
+{
+	int32 keyFlags = flags & ImageCacheKeyFlags;
+	uint64_t key = 14695981039346656037ULL;
+	key = HashImageCacheKey(key, &ImageCacheVersion, sizeof(ImageCacheVersion));
+	key = HashImageCacheKey(key, &keyFlags, sizeof(keyFlags));
+	key = HashImageCacheKey(key, &actual_width, sizeof(actual_width));
+	key = HashImageCacheKey(key, &actual_height, sizeof(actual_height));
+
+	bool stamped = true;
+	uint64_t stampKey = HashImageFileStamp(key, File, stamped);
+	if (OpacityFile) stampKey = HashImageFileStamp(stampKey, *OpacityFile, stamped);
+
+	uint64_t stampedKey;
+	if (stamped && ReadImageStamp(stampKey, stampedKey))
+	{
+		FileSpecifier cacheFile = GetImageCacheFile(stampedKey, "dds");
+		if (cacheFile.Exists() && LoadFromImageCache(cacheFile, flags, maxSize)) return true;
+	}
+
+	// new to the cache, or moved or changed since; go by the contents
+	std::vector<uint8> contents;
+	bool cacheable = ReadFileContents(File, contents) && !(contents.size() >= 4 && memcmp(&contents.front(), "DDS ", 4) == 0);
+
+	if (cacheable)
+	{
+		int32 size = static_cast<int32>(contents.size());
+		key = HashImageCacheKey(key, &size, sizeof(size));
+		key = HashImageCacheKey(key, contents.data(), contents.size());
+
+		if (OpacityFile && ReadFileContents(*OpacityFile, contents))
+		{
+			size = static_cast<int32>(contents.size());
+			key = HashImageCacheKey(key, &size, sizeof(size));
+			key = HashImageCacheKey(key, contents.data(), contents.size());
+		}
+
+		FileSpecifier cacheFile = GetImageCacheFile(key, "dds");
+		if (cacheFile.Exists() && LoadFromImageCache(cacheFile, flags, maxSize))
+		{
+			if (stamped) WriteImageStamp(stampKey, key);
+			return true;
+		}
+	}
+
+	if (!LoadFromFile(File, ImageLoader_Colors, flags, actual_width, actual_height, maxSize)) return false;
+	if (OpacityFile) LoadFromFile(*OpacityFile, ImageLoader_Opacity, flags, actual_width, actual_height, maxSize);
+
+	if (cacheable && Format == RGBA8 && MipMapCount == 0)
+	{
+		FileSpecifier cacheFile = GetImageCacheFile(key, "dds");
+		if (SaveToImageCache(cacheFile))
+		{
+			NoteImageCacheWrite(128 + static_cast<int64_t>(Width) * Height * 4);
+			if (stamped) WriteImageStamp(stampKey, key);
+		}
+	}
+
+	return true;
+}
+
+bool ImageDescriptor::LoadFromImageCache(FileSpecifier& File, int flags, int maxSize)
+{
+	uint8 header[128];
+	{
+		OpenedFile file;
+		if (!File.Open(file) || !file.Read(sizeof(header), header)) return false;
+	}
+
+	uint32 tag, version, originalWidth, originalHeight;
+	AIStreamLE inputStream(header, sizeof(header));
+	try {
+		inputStream.ignore(32);
+		inputStream >> tag;
+		inputStream >> version;
+		inputStream >> originalWidth;
+		inputStream >> originalHeight;
+	} catch (const AStream::failure&) {
+		return false;
+	}
+	if (tag != ImageCacheTag || version != ImageCacheVersion) return false;
+
+	if (flags & ImageLoader_ImageIsAlreadyPremultiplied)
+		PremultipliedAlpha = true;
+
+	// the file holds the padded image, so this only sets the texture coordinate scales
+	if (!LoadDDSFromFile(File, flags | ImageLoader_LeaveOversized, originalWidth, originalHeight, maxSize))
+	{
+		Clear();
+		return false;
+	}
+
+	MipMapCount = 0;
+	return true;
+}
+
+// written under another name and renamed, so a half-written file is never read
+bool ImageDescriptor::SaveToImageCache(FileSpecifier& File)
+{
+	uint8 header[128];
+	memset(header, 0, sizeof(header));
+
+	uint32 redMask, greenMask, blueMask, alphaMask;
+	if (PlatformIsLittleEndian()) {
+		redMask = 0x000000ff; greenMask = 0x0000ff00; blueMask = 0x00ff0000; alphaMask = 0xff000000;
+	} else {
+		redMask = 0xff000000; greenMask = 0x00ff0000; blueMask = 0x0000ff00; alphaMask = 0x000000ff;
+	}
+
+	AOStreamLE outputStream(header, sizeof(header));
+	try {
+		outputStream << uint32(FOUR_CHARS_TO_INT(' ', 'S', 'D', 'D'));
+		outputStream << uint32(124);
+		outputStream << uint32(DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT);
+		outputStream << uint32(Height);
+		outputStream << uint32(Width);
+		outputStream << uint32(Width * 4);
+		outputStream << uint32(0);
+		outputStream << uint32(0);
+
+		outputStream << ImageCacheTag;
+		outputStream << ImageCacheVersion;
+		outputStream << uint32(std::lround(VScale * Width));
+		outputStream << uint32(std::lround(UScale * Height));
+		outputStream.ignore(28);
+
+		outputStream << uint32(32);
+		outputStream << uint32(DDPF_RGB | DDPF_ALPHAPIXELS);
+		outputStream << uint32(0);
+		outputStream << uint32(32);
+		// LoadDDSFromFile() reads the masks in the machine's own byte order
+		outputStream.write((char *) &redMask, 4);
+		outputStream.write((char *) &greenMask, 4);
+		outputStream.write((char *) &blueMask, 4);
+		outputStream.write((char *) &alphaMask, 4);
+
+		outputStream << uint32(DDSCAPS_TEXTURE);
+	} catch (const AStream::failure&) {
+		return false;
+	}
+
+	char name[32];
+	snprintf(name, sizeof(name), "%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id()));
+	FileSpecifier temporaryFile(std::string(File.GetPath()) + "." + name);
+
+	OpenedFile file;
+	if (!temporaryFile.Open(file, true)) return false;
+	bool written = file.Write(sizeof(header), header) && file.Write(Width * Height * 4, Pixels);
+	file.Close();
+
+	if (!written || !temporaryFile.Rename(File))
+	{
+		temporaryFile.Delete();
+		return false;
+	}
+	return true;
+}
+
 bool ImageDescriptor::MakeDXTC3()
 {
 	if (Format != DXTC1) return false;
@@ -270,15 +270,24 @@ bool hasS3TC = false;
 
 void OGL_TextureOptionsBase::Load()
 {
-	FileSpecifier File;
+	if (LoadImages()) FinishLoading();
+}
 
+static GLint MaxLoadedTextureSize(OGL_TextureOptionsBase& Options)
+{
 	GLint maxTextureSize = glMaxTextureSize;
-	if (GetMaxSize())
+	if (Options.GetMaxSize())
 	{
-		maxTextureSize = MIN(maxTextureSize, GetMaxSize());
+		maxTextureSize = MIN(maxTextureSize, Options.GetMaxSize());
 	}
+	return maxTextureSize;
+}
+
+bool OGL_TextureOptionsBase::LoadImages()
+{
+	GLint maxTextureSize = MaxLoadedTextureSize(*this);
 	
-	int flags = npotTextures ? 0 : ImageLoader_ResizeToPowersOfTwo;
+	int flags = (npotTextures ? 0 : ImageLoader_ResizeToPowersOfTwo) | ImageLoader_LeaveOversized;
 		
 	if (Type >= 0 && Type < OGL_NUMBER_OF_TEXTURE_TYPES && Get_OGL_ConfigureData().TxtrConfigList[Type].FarFilter > 1 /* GL_LINEAR */)
 	{
@@ -294,37 +303,54 @@ void OGL_TextureOptionsBase::Load()
 
 	// Check to see if loading needs to be done;
 	// it does not need to be if an image is present.
-	if (NormalImg.IsPresent()) return;
+	if (NormalImg.IsPresent()) return false;
 
 	NormalImg.Clear();
 	
-	// Load the normal image if it has a filename specified for it
+	// Load the normal image if it has a filename specified for it,
+	// along with the normal mask if it has one
 	if (NormalColors != FileSpecifier() && NormalColors.Exists())
 	{
-		if (!NormalImg.LoadFromFile(NormalColors,ImageLoader_Colors, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize))
+		bool HasMask = NormalMask != FileSpecifier() && NormalMask.Exists();
+		if (!NormalImg.LoadFromFileCached(NormalColors, HasMask ? &NormalMask : NULL, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize))
 		{
 			// A texture must have a normal colored part
-			return;
+			return false;
 		}
 	}
 	else
 	{
-		return;
+		return false;
 	}
 
 	// load a heightmap
 	if (TEST_FLAG(Get_OGL_ConfigureData().Flags, OGL_Flag_BumpMap) && OffsetMap != FileSpecifier() && OffsetMap.Exists()) {
-		if(!OffsetImg.LoadFromFile(OffsetMap, ImageLoader_Colors, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize)) {
-			return;
+		if(!OffsetImg.LoadFromFileCached(OffsetMap, NULL, flags | (NormalIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize)) {
+			return false;
 		}
 	}
 
-	// Load the normal mask if it has a filename specified for it
-	if (NormalMask != FileSpecifier() && NormalMask.Exists())
+	// Load the glow image with alpha channel
+	if (!GlowImg.IsPresent())
 	{
-		NormalImg.LoadFromFile(NormalMask,ImageLoader_Opacity, flags, actual_width, actual_height, maxTextureSize);
+		GlowImg.Clear();
+		
+		// Load the glow image if it has a filename specified for it,
+		// along with the glow mask if it has one
+		if (GlowColors != FileSpecifier() && GlowColors.Exists())
+		{
+			bool HasMask = GlowMask != FileSpecifier() && GlowMask.Exists();
+			GlowImg.LoadFromFileCached(GlowColors, HasMask ? &GlowMask : NULL, flags | (GlowIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize);
+		}
 	}
 
+	return true;
+}
+
+void OGL_TextureOptionsBase::FinishLoading()
+{
+	GLint maxTextureSize = MaxLoadedTextureSize(*this);
+
 	if (maxTextureSize)
 	{
 		while (NormalImg.GetWidth() > maxTextureSize || NormalImg.GetHeight() > maxTextureSize)
@@ -339,29 +365,6 @@ void OGL_TextureOptionsBase::Load()
 		}
 	}
 	
-	// Load the glow image with alpha channel
-	if (!GlowImg.IsPresent())
-	{
-		GlowImg.Clear();
-		
-		// Load the glow image if it has a filename specified for it
-		if (GlowColors != FileSpecifier() && GlowColors.Exists())
-		{
-			if (GlowImg.LoadFromFile(GlowColors,ImageLoader_Colors, flags | (GlowIsPremultiplied ? ImageLoader_ImageIsAlreadyPremultiplied : 0), actual_width, actual_height, maxTextureSize))
-			{
-		
-				// Load the glow mask if it has a
-				// filename specified for it; only
-				// loaded if an image has been loaded
-				// for it
-				if (GlowMask != FileSpecifier() && GlowMask.Exists())
-				{
-					GlowImg.LoadFromFile(GlowMask,ImageLoader_Opacity, flags, actual_width, actual_height, maxTextureSize);
-				}
-			}
-		}
-	}
-	
 	if (GlowImg.IsPresent() && maxTextureSize)
 	{
 		while (GlowImg.GetWidth() > maxTextureSize || GlowImg.GetHeight() > maxTextureSize) 
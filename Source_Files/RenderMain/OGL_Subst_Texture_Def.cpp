@@ -30,8 +30,13 @@
 #include "Logging.h"
 #include "InfoTree.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
+#include <vector>
 #include <boost/unordered_map.hpp>
 
 #ifdef HAVE_OPENGL
@@ -63,14 +68,78 @@ int OGL_CountTextures(short Collection)
 
 extern void OGL_ProgressCallback(int);
 
+// Most of loading a texture is reading and decoding its images, which only touches that
+// texture's own options, so it's spread over worker threads. This thread finishes each one
+// (shrinking it uses GLU, which needs the GL context) and keeps the progress bar moving.
+// Nothing is uploaded here: that still happens on this thread, the first time each texture
+// is rendered.
+static const unsigned MaxTextureLoadingThreads = 8;
+
 void OGL_LoadTextures(short Collection)
 {
-
+	std::vector<OGL_TextureOptions *> Options;
+	Options.reserve(Collections[Collection].size());
 	for (TOHash::iterator it = Collections[Collection].begin(); it != Collections[Collection].end(); ++it)
 	{
-		it->second.Load();
-		OGL_ProgressCallback(1);
-		
+		Options.push_back(&it->second);
+	}
+
+	unsigned ThreadCount = std::min<size_t>(std::min(std::thread::hardware_concurrency(), MaxTextureLoadingThreads), Options.size());
+	if (ThreadCount <= 1)
+	{
+		for (size_t i = 0; i < Options.size(); i++)
+		{
+			Options[i]->Load();
+			OGL_ProgressCallback(1);
+		}
+		return;
+	}
+
+	std::mutex Lock;
+	std::condition_variable Loaded;
+	size_t NextToLoad = 0;
+	std::vector<std::pair<OGL_TextureOptions *, bool> > LoadedOptions; // and whether to finish loading it
+
+	auto LoadImages = [&]() {
+		std::unique_lock<std::mutex> Guard(Lock);
+		while (NextToLoad < Options.size())
+		{
+			OGL_TextureOptions *TextureOptions = Options[NextToLoad++];
+			Guard.unlock();
+			bool Finish = TextureOptions->LoadImages();
+			Guard.lock();
+			LoadedOptions.push_back(std::make_pair(TextureOptions, Finish));
+			Loaded.notify_one();
+		}
+	};
+
+	std::vector<std::thread> Threads;
+	for (unsigned i = 0; i < ThreadCount; i++)
+	{
+		Threads.emplace_back(LoadImages);
+	}
+
+	size_t FinishedCount = 0;
+	std::vector<std::pair<OGL_TextureOptions *, bool> > ToFinish;
+	while (FinishedCount < Options.size())
+	{
+		{
+			std::unique_lock<std::mutex> Guard(Lock);
+			Loaded.wait(Guard, [&]() { return !LoadedOptions.empty(); });
+			ToFinish.swap(LoadedOptions);
+		}
+		for (size_t i = 0; i < ToFinish.size(); i++)
+		{
+			if (ToFinish[i].second) ToFinish[i].first->FinishLoading();
+			OGL_ProgressCallback(1);
+		}
+		FinishedCount += ToFinish.size();
+		ToFinish.clear();
+	}
+
+	for (size_t i = 0; i < Threads.size(); i++)
+	{
+		Threads[i].join();
 	}
 }
 
@@ -145,6 +145,13 @@ struct OGL_TextureOptionsBase
 	void Load();
 	void Unload();
 
+	// Load() in two steps: reading the images from their files, which doesn't touch OpenGL
+	// and may run on any thread, and then shrinking them to the maximum texture size, which
+	// uses GLU and must run where the GL context is; FinishLoading() is only needed if
+	// LoadImages() returns true
+	bool LoadImages();
+	void FinishLoading();
+
 	virtual int GetMaxSize();
 	
 	OGL_TextureOptionsBase():
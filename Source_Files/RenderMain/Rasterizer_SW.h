@@ -32,6 +32,9 @@ class Rasterizer_SW_Class: public RasterizerClass
 {
 public:
 
+	Rasterizer_SW_Class();
+	~Rasterizer_SW_Class();
+
 	// Pointers to stuff used in scottish_textures:
 	view_data *view;
 	// Calling this one "screen" for scottish_textures convenience:
@@ -49,6 +52,22 @@ public:
 	void texture_vertical_polygon(polygon_definition& textured_polygon);
 	
 	void texture_rectangle(rectangle_definition& textured_rectangle);
+	
+	// Limits drawing to the screen columns [Left, Right); pixels inside the band come out
+	// exactly as they would without it.  Left must be a multiple of 4, so the column mapper
+	// groups the same columns it would for the whole screen.
+	void SetBand(short Left, short Right) {band_left = Left; band_right = Right;}
+
+private:
+	Rasterizer_SW_Class(const Rasterizer_SW_Class&);
+	Rasterizer_SW_Class& operator=(const Rasterizer_SW_Class&);
+
+	short band_left, band_right;
+	
+	// Scratch space for the texture mappers; one set per rasterizer, so that several can
+	// draw at once
+	short *scratch_table0, *scratch_table1;
+	void *precalculation_table;
 };
 
 
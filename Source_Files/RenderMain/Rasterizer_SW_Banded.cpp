@@ -0,0 +1,208 @@
+/*
+RASTERIZER_SW_BANDED.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "cseries.h"
+#include "Rasterizer_SW_Banded.h"
+
+#include <algorithm>
+#include <limits.h>
+
+// beyond this, bands get too narrow for the extra precalculation to pay off
+static const unsigned maximum_bands = 8;
+
+Rasterizer_SW_Banded_Class::Rasterizer_SW_Banded_Class() :
+	view(NULL), screen(NULL), first_surface(0), last_surface(0), generation(0), pending_bands(0), quitting(false)
+{
+}
+
+Rasterizer_SW_Banded_Class::~Rasterizer_SW_Banded_Class()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quitting = true;
+	}
+	start_bands.notify_all();
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void Rasterizer_SW_Banded_Class::Begin()
+{
+	surfaces.clear();
+	polygons.clear();
+	rectangles.clear();
+}
+
+void Rasterizer_SW_Banded_Class::End()
+{
+	if (bands.empty())
+	{
+		start_workers();
+	}
+
+	// band edges on multiples of 4, so the column mapper groups columns as it would unbanded
+	short band_width = ((screen->width + bands.size() - 1) / bands.size() + 3) & ~3;
+	for (size_t i = 0; i < bands.size(); ++i)
+	{
+		short left = std::min<int>(i * band_width, screen->width);
+		short right = (i == bands.size() - 1) ? SHRT_MAX : std::min<int>(left + band_width, screen->width);
+
+		bands[i]->SetView(*view);
+		bands[i]->screen = screen;
+		bands[i]->SetBand(left, right);
+	}
+	whole_screen.SetView(*view);
+	whole_screen.screen = screen;
+
+	size_t first = 0;
+	for (size_t i = 0; i < surfaces.size(); ++i)
+	{
+		if (surfaces[i].in_order)
+		{
+			draw_in_bands(first, i);
+			draw_surface(whole_screen, surfaces[i]);
+			first = i + 1;
+		}
+	}
+	draw_in_bands(first, surfaces.size());
+}
+
+void Rasterizer_SW_Banded_Class::texture_horizontal_polygon(polygon_definition& textured_polygon)
+{
+	Surface surface = { _horizontal_polygon, textured_polygon.transfer_mode == _static_transfer, polygons.size() };
+	surfaces.push_back(surface);
+	polygons.push_back(textured_polygon);
+}
+
+void Rasterizer_SW_Banded_Class::texture_vertical_polygon(polygon_definition& textured_polygon)
+{
+	Surface surface = { _vertical_polygon, textured_polygon.transfer_mode == _static_transfer, polygons.size() };
+	surfaces.push_back(surface);
+	polygons.push_back(textured_polygon);
+}
+
+void Rasterizer_SW_Banded_Class::texture_rectangle(rectangle_definition& textured_rectangle)
+{
+	Surface surface = { _rectangle, textured_rectangle.transfer_mode == _static_transfer, rectangles.size() };
+	surfaces.push_back(surface);
+	rectangles.push_back(textured_rectangle);
+}
+
+void Rasterizer_SW_Banded_Class::start_workers()
+{
+	unsigned band_count = std::max(1u, std::min(std::thread::hardware_concurrency(), maximum_bands));
+
+	for (unsigned i = 0; i < band_count; ++i)
+	{
+		bands.emplace_back(new Rasterizer_SW_Class);
+	}
+	for (unsigned i = 1; i < band_count; ++i)
+	{
+		workers.emplace_back(&Rasterizer_SW_Banded_Class::run_worker, this, i);
+	}
+}
+
+void Rasterizer_SW_Banded_Class::run_worker(size_t band)
+{
+	uint32 last_generation = 0;
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+		start_bands.wait(lock, [&] { return quitting || generation != last_generation; });
+		if (quitting)
+			return;
+
+		last_generation = generation;
+		size_t first = first_surface, last = last_surface;
+
+		lock.unlock();
+		draw_surfaces(*bands[band], first, last);
+		lock.lock();
+
+		if (--pending_bands == 0)
+		{
+			bands_done.notify_one();
+		}
+	}
+}
+
+void Rasterizer_SW_Banded_Class::draw_in_bands(size_t first, size_t last)
+{
+	if (first == last)
+		return;
+
+	if (bands.size() > 1)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			first_surface = first;
+			last_surface = last;
+			pending_bands = bands.size() - 1;
+			++generation;
+		}
+		start_bands.notify_all();
+	}
+
+	draw_surfaces(*bands[0], first, last);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	bands_done.wait(lock, [&] { return pending_bands == 0; });
+}
+
+void Rasterizer_SW_Banded_Class::draw_surfaces(Rasterizer_SW_Class& rasterizer, size_t first, size_t last)
+{
+	for (size_t i = first; i < last; ++i)
+	{
+		draw_surface(rasterizer, surfaces[i]);
+	}
+}
+
+// the texture mappers scribble on what they're given (rectangles get clipped in place), so
+// each band works on its own copy
+void Rasterizer_SW_Banded_Class::draw_surface(Rasterizer_SW_Class& rasterizer, const Surface& surface)
+{
+	switch (surface.type)
+	{
+		case _horizontal_polygon:
+		{
+			polygon_definition polygon = polygons[surface.index];
+			rasterizer.texture_horizontal_polygon(polygon);
+			break;
+		}
+
+		case _vertical_polygon:
+		{
+			polygon_definition polygon = polygons[surface.index];
+			rasterizer.texture_vertical_polygon(polygon);
+			break;
+		}
+
+		case _rectangle:
+		{
+			rectangle_definition rectangle = rectangles[surface.index];
+			rasterizer.texture_rectangle(rectangle);
+			break;
+		}
+	}
+}
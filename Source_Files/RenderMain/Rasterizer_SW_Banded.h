@@ -0,0 +1,99 @@
+#ifndef _RASTERIZER_SW_BANDED_CLASS_
+#define _RASTERIZER_SW_BANDED_CLASS_
+/*
+RASTERIZER_SW_BANDED.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Multithreaded software rasterizer.  It records the surfaces of a frame as the renderer
+	hands them over, and at End() splits the screen into bands of columns; each thread draws
+	every recorded surface, in order, clipped to its own band, so the frame comes out exactly
+	as the serial rasterizer would have drawn it.
+
+	Static transfer modes draw from one random seed shared in drawing order, so those surfaces
+	are drawn across the whole screen, by the calling thread, once every band has caught up
+	to them.
+*/
+
+#include "Rasterizer_SW.h"
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+class Rasterizer_SW_Banded_Class: public RasterizerClass
+{
+public:
+
+	view_data *view;
+	bitmap_definition *screen;
+
+	Rasterizer_SW_Banded_Class();
+	~Rasterizer_SW_Banded_Class();
+
+	void SetView(view_data& View) {view = &View;}
+
+	void Begin();
+	void End();
+
+	void texture_horizontal_polygon(polygon_definition& textured_polygon);
+
+	void texture_vertical_polygon(polygon_definition& textured_polygon);
+
+	void texture_rectangle(rectangle_definition& textured_rectangle);
+
+private:
+	enum {
+		_horizontal_polygon,
+		_vertical_polygon,
+		_rectangle
+	};
+
+	struct Surface {
+		int16 type;
+		bool in_order;		// must be drawn across the whole screen, in sequence
+		size_t index;		// into polygons or rectangles
+	};
+
+	std::vector<Surface> surfaces;
+	std::vector<polygon_definition> polygons;
+	std::vector<rectangle_definition> rectangles;
+
+	// Band 0 is drawn by the calling thread, the rest by workers
+	std::vector<std::unique_ptr<Rasterizer_SW_Class> > bands;
+	Rasterizer_SW_Class whole_screen;
+	std::vector<std::thread> workers;
+
+	std::mutex mutex;
+	std::condition_variable start_bands, bands_done;
+	size_t first_surface, last_surface;
+	uint32 generation;
+	size_t pending_bands;
+	bool quitting;
+
+	void start_workers();
+	void run_worker(size_t band);
+	void draw_in_bands(size_t first, size_t last);
+	void draw_surfaces(Rasterizer_SW_Class& rasterizer, size_t first, size_t last);
+	void draw_surface(Rasterizer_SW_Class& rasterizer, const Surface& surface);
+};
+
+
+#endif
@@ -54,6 +54,10 @@ enum /* build_clipping_window() window states */
 
 
 RenderSortPolyClass::RenderSortPolyClass():
+	sorted_nodes_are_reusable(false),
+	sorted_tree_generation(0),
+	sorted_clip_generation(0),
+	sorted_clipping_window_count(0),
 	view(NULL),	// Idiot-proofing
 	RVPtr(NULL)
 {
@@ -76,6 +80,10 @@ void RenderSortPolyClass::initialize_sorted_render_tree()
 {
 	// LP change: sorted nodes a growable list
 	SortedNodes.clear();
+	SortedNodeChains.clear();
+	
+	// normally already cleared by the visibility tree, but not if it kept its last tree
+	RVPtr->ClippingWindows.clear();
 }
 
 /*
@@ -96,6 +104,13 @@ void RenderSortPolyClass::sort_render_tree()
 	// LP: reference to simplify the code
 	RenderVisTreeClass::NodeList& Nodes = RVPtr->Nodes;
 
+	/* the tree we took apart last time is still the tree */
+	if (sorted_nodes_are_reusable && RVPtr->tree_generation == sorted_tree_generation)
+	{
+		reuse_sorted_render_tree();
+		return;
+	}
+
 	initialize_sorted_render_tree();
 	
 	leaf= NULL;
@@ -201,6 +216,7 @@ void RenderSortPolyClass::sort_render_tree()
 			
 			// LP change: using polygon-sorted node chain
 			sorted_node->clipping_windows= build_clipping_windows(FoundNode);
+			SortedNodeChains.push_back(FoundNode);
 			
 			/* remember which sorted nodes correspond to which polygons (only valid if
 				_polygon_is_visible) */
@@ -229,6 +245,47 @@ void RenderSortPolyClass::sort_render_tree()
 	}
 
 	while (last_leaf != &Nodes.front()); /* continue until we remove the root */
+	
+	sorted_nodes_are_reusable= true;
+	sorted_tree_generation= RVPtr->tree_generation;
+	sorted_clip_generation= RVPtr->clip_generation;
+	sorted_clipping_window_count= RVPtr->ClippingWindows.size();
+}
+
+/* same polygons in the same order; only the clipping windows may need redoing, and the objects
+	the last frame placed need clearing out */
+void RenderSortPolyClass::reuse_sorted_render_tree()
+{
+	vector<clipping_window_data>& ClippingWindows = RVPtr->ClippingWindows;
+	
+	for (auto& sorted_node : SortedNodes)
+	{
+		sorted_node.interior_objects= NULL;
+		sorted_node.exterior_objects= NULL;
+	}
+	
+	if (RVPtr->clip_generation != sorted_clip_generation)
+	{
+		/* in the same order as the sort built them, so the windows come out the same way */
+		ClippingWindows.clear();
+		for (auto& sorted_node : SortedNodes)
+		{
+			sorted_node.clipping_windows= nullptr;
+		}
+		for (size_t k=0; k<SortedNodes.size(); k++)
+		{
+			clipping_window_data *windows= build_clipping_windows(SortedNodeChains[k]);
+			SortedNodes[k].clipping_windows= windows;
+		}
+		
+		sorted_clip_generation= RVPtr->clip_generation;
+		sorted_clipping_window_count= ClippingWindows.size();
+	}
+	else
+	{
+		/* drop the windows object placement added */
+		ClippingWindows.resize(sorted_clipping_window_count);
+	}
 }
 
 /* ---------- initializing and calculating clip data */
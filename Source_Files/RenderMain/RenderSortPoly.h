@@ -64,6 +64,17 @@ class RenderSortPolyClass
 
 	void calculate_vertical_clip_data(line_clip_data **accumulated_line_clips,
 		size_t accumulated_line_clip_count, clipping_window_data *window, short x0, short x1);
+	
+	// Sorting takes the visibility tree apart, so when the tree is kept from the last frame,
+	// so are the sorted nodes; these say which tree (and which clips) they came from.
+	// The first node of each sorted node's polygon chain is kept for rebuilding its
+	// clipping windows if only the clips changed.
+	bool sorted_nodes_are_reusable;
+	uint32 sorted_tree_generation, sorted_clip_generation;
+	size_t sorted_clipping_window_count;
+	vector<node_data *> SortedNodeChains;
+	
+	void reuse_sorted_render_tree();
 		
 public:
 	
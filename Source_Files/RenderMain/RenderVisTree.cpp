@@ -37,6 +37,10 @@ Oct 13, 2000
 
 #include "map.h"
 #include "RenderVisTree.h"
+#include "world_snapshot.h"
+
+#include <algorithm>
+#include <string.h>
 
 
 // LP: "recommended" sizes of stuff in growable lists
@@ -54,6 +58,13 @@ enum /* cast_render_ray() flags */
 };
 
 
+enum /* classify_line_crossing() flags, besides _clip_up and _clip_down */
+{
+	_line_crossing_is_open= 0x0100, /* transparent, with a polygon on the other side */
+	_line_crossing_added_to_automap= 0x0200 /* only kept in line_crossing::flags */
+};
+
+
 enum /* cast_render_ray(), next_polygon_along_line() biases */
 {
 	_no_bias, /* will split at the given endpoint or travel clockwise otherwise */
@@ -81,9 +92,35 @@ inline void INITIALIZE_NODE(node_data *node, short node_polygon_index, uint16 no
 }
 
 
+/* can a ray get from polygon_index across line_index into next_polygon_index, and if so, does the
+	change in floor or ceiling height there clip what's beyond it? */
+static uint16 classify_line_crossing(
+	short line_index,
+	short polygon_index,
+	short next_polygon_index)
+{
+	line_data *line= get_line_data(line_index);
+	
+	// LP change: added test for there being a polygon on the other side
+	if (!LINE_IS_TRANSPARENT(line) || next_polygon_index==NONE) return 0;
+	
+	polygon_data *polygon= get_polygon_data(polygon_index);
+	polygon_data *next_polygon= get_polygon_data(next_polygon_index);
+	uint16 flags= _line_crossing_is_open;
+	
+	if (line->highest_adjacent_floor>next_polygon->floor_height ||
+		line->highest_adjacent_floor>polygon->floor_height) flags|= _clip_down; /* next polygon floor is lower */
+	if (line->lowest_adjacent_ceiling<next_polygon->ceiling_height ||
+		line->lowest_adjacent_ceiling<polygon->ceiling_height) flags|= _clip_up; /* next polygon ceiling is higher */
+	
+	return flags;
+}
+
+
 // Inits everything
 RenderVisTreeClass::RenderVisTreeClass():
-	view(NULL), mark_as_explored(false), add_to_automap(true)
+	tree_is_reusable(false), view(NULL), mark_as_explored(false), add_to_automap(true),
+	reuse_between_frames(false), tree_generation(0), clip_generation(0)
 {
 	PolygonQueue.reserve(POLYGON_QUEUE_SIZE);
 	EndpointClips.reserve(MAXIMUM_ENDPOINT_CLIPS);
@@ -97,6 +134,7 @@ void RenderVisTreeClass::Resize(size_t NumEndpoints, size_t NumLines)
 {
 	endpoint_x_coordinates.resize(NumEndpoints);
 	line_clip_indexes.resize(NumLines);
+	line_crossing_indexes.resize(NumLines, NONE);
 }
 
 // Add a polygon to the polygon queue
@@ -113,6 +151,8 @@ void RenderVisTreeClass::PUSH_POLYGON_INDEX(short polygon_index)
 		
 		// polygon_queue[polygon_queue_size++]= polygon_index;
 		SET_RENDER_FLAG(polygon_index, _polygon_is_visible);
+		
+		if (reuse_between_frames) VisiblePolygons.push_back(polygon_index);
 	}
 }
 
@@ -121,6 +161,14 @@ void RenderVisTreeClass::build_render_tree()
 {
 	assert(view);	// Idiot-proofing
 
+	/* if nothing the last tree was built from has changed, it's still the right one */
+	if (reuse_between_frames && tree_still_valid())
+	{
+		reuse_tree();
+		return;
+	}
+	forget_tree();
+
 	/* initialize the queue where we remember polygons we need to fire at */
 	initialize_polygon_queue();
 
@@ -155,6 +203,12 @@ void RenderVisTreeClass::build_render_tree()
 				/* transform all visited endpoints */
 				endpoint->transformed= endpoint->vertex;
 				transform_overflow_point2d(&endpoint->transformed, (world_point2d *) &view->origin, view->yaw, &endpoint->flags);
+				
+				if (reuse_between_frames)
+				{
+					visited_endpoint visited= { endpoint_index, endpoint->transformed, endpoint->flags, ENDPOINT_IS_TRANSPARENT(endpoint) != 0 };
+					VisitedEndpoints.push_back(visited);
+				}
 
 				/* calculate an outbound vector to this endpoint */
 				// LP: changed to do long distance correctly.	
@@ -185,6 +239,10 @@ void RenderVisTreeClass::build_render_tree()
 			}
 		}
 	}
+	
+	++tree_generation;
+	++clip_generation;
+	if (reuse_between_frames) remember_tree();
 }
 
 /* ---------- building the render tree */
@@ -356,7 +414,10 @@ uint16 RenderVisTreeClass::next_polygon_along_line(
 
 	if (add_to_automap) ADD_POLYGON_TO_AUTOMAP(*polygon_index);
 	if (mark_as_explored && polygon->type == _polygon_must_be_explored)
-        polygon->type = _polygon_is_normal;
+	{
+		world_changed(polygon);
+		polygon->type = _polygon_is_normal;
+	}
 	PUSH_POLYGON_INDEX(*polygon_index);
 
 	state= _looking_for_first_nonzero_vertex;
@@ -481,15 +542,12 @@ uint16 RenderVisTreeClass::next_polygon_along_line(
 
 		/* if this line is transparent we need to check for a change in elevation for clipping,
 			if it’s not transparent then we can’t pass through it */
-		// LP change: added test for there being a polygon on the other side
-		if (LINE_IS_TRANSPARENT(line) && next_polygon_index != NONE)
+		uint16 crossing_flags= classify_line_crossing(crossed_line_index, *polygon_index, next_polygon_index);
+		record_line_crossing(crossed_line_index, *polygon_index, next_polygon_index, add_to_automap);
+		
+		if (crossing_flags&_line_crossing_is_open)
 		{
-			polygon_data *next_polygon= get_polygon_data(next_polygon_index);
-			
-			if (line->highest_adjacent_floor>next_polygon->floor_height ||
-				line->highest_adjacent_floor>polygon->floor_height) clip_flags|= _clip_down; /* next polygon floor is lower */
-			if (line->lowest_adjacent_ceiling<next_polygon->ceiling_height ||
-				line->lowest_adjacent_ceiling<polygon->ceiling_height) clip_flags|= _clip_up; /* next polygon ceiling is higher */
+			clip_flags|= crossing_flags&(_clip_up|_clip_down);
 			if (clip_flags&(_clip_up|_clip_down)) *clipping_line_index= crossed_line_index;
 		}
 		else
@@ -516,6 +574,7 @@ uint16 RenderVisTreeClass::decide_where_vertex_leads(
 	short bias)
 {
 	polygon_data *polygon= get_polygon_data(*polygon_index);
+	short from_polygon_index= *polygon_index;
 	short endpoint_index= polygon->endpoint_indexes[endpoint_index_in_polygon_list];
 	short index;
 	
@@ -544,7 +603,6 @@ uint16 RenderVisTreeClass::decide_where_vertex_leads(
 	
 	if (index!=NONE)
 	{
-		line_data *line;
 		world_point2d *vertex;
 		CROSSPROD_TYPE cross_product;
 
@@ -552,8 +610,8 @@ uint16 RenderVisTreeClass::decide_where_vertex_leads(
 		*side_index= polygon->side_indexes[index];
 		*polygon_index= polygon->adjacent_polygon_indexes[index];
 		
-		line= get_line_data(*line_index);
-		if (*polygon_index!=NONE && LINE_IS_TRANSPARENT(line))
+		record_line_crossing(*line_index, from_polygon_index, *polygon_index, false);
+		if (classify_line_crossing(*line_index, from_polygon_index, *polygon_index)&_line_crossing_is_open)
 		{
 			polygon= get_polygon_data(*polygon_index);
 			
@@ -620,25 +678,30 @@ void RenderVisTreeClass::initialize_clip_data()
 	}
 	
 	LineClips.resize(NUMBER_OF_INITIAL_LINE_CLIPS);
+	LineClipSources.resize(NUMBER_OF_INITIAL_LINE_CLIPS);
 
 	/* set default line clip (top and bottom of screen) */
-	{
-		line_clip_data *line= &LineClips[indexTOP_AND_BOTTOM_OF_SCREEN];
-
-		line->flags= _clip_up|_clip_down;
-		line->x0 = INT16_MIN;
-		line->x1 = INT16_MAX;
-		line->top_y = 0;
-		line->bottom_y = view->screen_height;
-		// Top clip vector is negated to clip upward
-		line->top_vector = {-view->world_to_screen_y, -(+view->half_screen_height + view->dtanpitch)}; // {i, k}
-		line->bottom_vector = {view->world_to_screen_y, -view->half_screen_height + view->dtanpitch}; // {i, k}
-	}
+	fill_screen_line_clipping_information(&LineClips[indexTOP_AND_BOTTOM_OF_SCREEN]);
+	LineClipSources[indexTOP_AND_BOTTOM_OF_SCREEN].line_index= NONE;
+	LineClipSources[indexTOP_AND_BOTTOM_OF_SCREEN].clip_flags= _clip_up|_clip_down;
 
 	// LP change:
 	ClippingWindows.clear();
 }
 
+void RenderVisTreeClass::fill_screen_line_clipping_information(
+	line_clip_data *line)
+{
+	line->flags= _clip_up|_clip_down;
+	line->x0 = INT16_MIN;
+	line->x1 = INT16_MAX;
+	line->top_y = 0;
+	line->bottom_y = view->screen_height;
+	// Top clip vector is negated to clip upward
+	line->top_vector = {-view->world_to_screen_y, -(+view->half_screen_height + view->dtanpitch)}; // {i, k}
+	line->bottom_vector = {view->world_to_screen_y, -view->half_screen_height + view->dtanpitch}; // {i, k}
+}
+
 void RenderVisTreeClass::calculate_line_clipping_information(
 	short line_index,
 	uint16 clip_flags)
@@ -650,6 +713,26 @@ void RenderVisTreeClass::calculate_line_clipping_information(
 	assert(Length >= 1);
 	size_t LastIndex = Length-1;
 	
+	clip_flags&= _clip_up|_clip_down;	
+	assert(clip_flags&(_clip_up|_clip_down));
+	assert(!TEST_RENDER_FLAG(line_index, _line_has_clip_data));
+
+	SET_RENDER_FLAG(line_index, _line_has_clip_data);
+	line_clip_indexes[line_index]= static_cast<vector<size_t>::value_type>(LastIndex);
+	
+	line_clip_source source= { line_index, clip_flags };
+	LineClipSources.push_back(source);
+	
+	fill_line_clipping_information(data, line_index, clip_flags);
+}
+
+/* the clip itself, which only depends on the view and the line's heights, so it can be redone in
+	place when those change */
+void RenderVisTreeClass::fill_line_clipping_information(
+	line_clip_data *data,
+	short line_index,
+	uint16 clip_flags)
+{
 	line_data *line= get_line_data(line_index);
 	// LP change: relabeling p0 and p1 so as not to conflict with later use
 	world_point2d p0_orig= get_endpoint_data(line->endpoint_indexes[0])->vertex;
@@ -668,13 +751,6 @@ void RenderVisTreeClass::calculate_line_clipping_information(
 	overflow_short_to_long_2d(p0_orig,p0_flags,*pv0ptr);
 	overflow_short_to_long_2d(p1_orig,p1_flags,*pv1ptr);
 	
-	clip_flags&= _clip_up|_clip_down;	
-	assert(clip_flags&(_clip_up|_clip_down));
-	assert(!TEST_RENDER_FLAG(line_index, _line_has_clip_data));
-
-	SET_RENDER_FLAG(line_index, _line_has_clip_data);
-	line_clip_indexes[line_index]= static_cast<vector<size_t>::value_type>(LastIndex);
-	
 	data->flags= 0;
 
 	if (p0.x>0 && p1.x>0)
@@ -803,3 +879,162 @@ short RenderVisTreeClass::calculate_endpoint_clipping_information(
 	
 	return (short)LastIndex;
 }
+
+/* ---------- reusing the tree across frames */
+
+void RenderVisTreeClass::invalidate_tree()
+{
+	tree_is_reusable= false;
+}
+
+void RenderVisTreeClass::get_planar_view_key(
+	planar_view_key& key)
+{
+	// cleared first so keys can be compared with memcmp()
+	obj_clear(key);
+	key.origin_polygon_index= view->origin_polygon_index;
+	key.origin.x= view->origin.x;
+	key.origin.y= view->origin.y;
+	key.yaw= view->yaw;
+	key.left_edge= view->left_edge;
+	key.right_edge= view->right_edge;
+	key.world_to_screen_x= view->world_to_screen_x;
+	key.half_screen_width= view->half_screen_width;
+	key.screen_width= view->screen_width;
+}
+
+void RenderVisTreeClass::record_line_crossing(
+	short line_index,
+	short polygon_index,
+	short next_polygon_index,
+	bool added_to_automap)
+{
+	if (!reuse_between_frames) return;
+	
+	int32& index= line_crossing_indexes[line_index];
+	if (index==NONE)
+	{
+		line_crossing crossing= { line_index, polygon_index, next_polygon_index,
+			classify_line_crossing(line_index, polygon_index, next_polygon_index) };
+		index= static_cast<int32>(LineCrossings.size());
+		LineCrossings.push_back(crossing);
+	}
+	if (added_to_automap) LineCrossings[index].flags|= _line_crossing_added_to_automap;
+}
+
+void RenderVisTreeClass::forget_tree()
+{
+	tree_is_reusable= false;
+	
+	for (auto& crossing : LineCrossings)
+	{
+		line_crossing_indexes[crossing.line_index]= NONE;
+	}
+	LineCrossings.clear();
+	VisitedEndpoints.clear();
+	VisiblePolygons.clear();
+}
+
+void RenderVisTreeClass::remember_tree()
+{
+	get_planar_view_key(tree_view_key);
+	TreeRenderFlags= RenderFlagList;
+	tree_is_reusable= true;
+}
+
+bool RenderVisTreeClass::tree_still_valid()
+{
+	if (!tree_is_reusable) return false;
+	if (TreeRenderFlags.size()!=RenderFlagList.size()) return false;
+	
+	planar_view_key key;
+	get_planar_view_key(key);
+	if (memcmp(&key, &tree_view_key, sizeof(key))!=0) return false;
+	
+	/* platforms and doors open and close lines, and move the heights that decide which lines clip */
+	for (auto& crossing : LineCrossings)
+	{
+		if ((crossing.flags&~_line_crossing_added_to_automap) !=
+				classify_line_crossing(crossing.line_index, crossing.polygon_index, crossing.next_polygon_index))
+			return false;
+	}
+	
+	/* they also decide which endpoints rays split at */
+	for (auto& visited : VisitedEndpoints)
+	{
+		if ((ENDPOINT_IS_TRANSPARENT(get_endpoint_data(visited.endpoint_index)) != 0) != visited.transparent)
+			return false;
+	}
+	
+	return true;
+}
+
+static bool line_clips_equal(
+	const line_clip_data& a,
+	const line_clip_data& b)
+{
+	return a.flags==b.flags && a.x0==b.x0 && a.x1==b.x1 &&
+		a.top_vector.i==b.top_vector.i && a.top_vector.j==b.top_vector.j &&
+		a.bottom_vector.i==b.bottom_vector.i && a.bottom_vector.j==b.bottom_vector.j &&
+		a.top_y==b.top_y && a.bottom_y==b.bottom_y;
+}
+
+/* put back everything building the tree would have left behind */
+void RenderVisTreeClass::reuse_tree()
+{
+	std::copy(TreeRenderFlags.begin(), TreeRenderFlags.end(), RenderFlagList.begin());
+	
+	/* other views (M1 exploration) transform endpoints too; the upper byte of the flags holds the
+		overflow bits of the transformed point (see long_to_overflow_short_2d()) */
+	for (auto& visited : VisitedEndpoints)
+	{
+		endpoint_data *endpoint= get_endpoint_data(visited.endpoint_index);
+		
+		endpoint->transformed= visited.transformed;
+		endpoint->flags= (endpoint->flags&0x00ff) | (visited.flags&0xff00);
+	}
+	
+	if (add_to_automap)
+	{
+		for (auto polygon_index : VisiblePolygons)
+		{
+			ADD_POLYGON_TO_AUTOMAP(polygon_index);
+		}
+		for (auto& crossing : LineCrossings)
+		{
+			if (crossing.flags&_line_crossing_added_to_automap) ADD_LINE_TO_AUTOMAP(crossing.line_index);
+		}
+	}
+	
+	if (mark_as_explored)
+	{
+		for (auto polygon_index : VisiblePolygons)
+		{
+			polygon_data *polygon= get_polygon_data(polygon_index);
+			if (polygon->type == _polygon_must_be_explored)
+			{
+				world_changed(polygon);
+				polygon->type = _polygon_is_normal;
+			}
+		}
+	}
+	
+	/* the view's height and pitch, and moving platforms, only change the line clips */
+	bool clips_changed= false;
+	for (size_t i= 0; i<LineClips.size(); ++i)
+	{
+		line_clip_data data= {};
+		
+		if (LineClipSources[i].line_index==NONE)
+			fill_screen_line_clipping_information(&data);
+		else
+			fill_line_clipping_information(&data, LineClipSources[i].line_index, LineClipSources[i].clip_flags);
+		
+		if (!line_clips_equal(data, LineClips[i]))
+		{
+			LineClips[i]= data;
+			clips_changed= true;
+		}
+	}
+	if (clips_changed) ++clip_generation;
+}
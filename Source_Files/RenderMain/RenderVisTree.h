@@ -190,6 +190,69 @@ class RenderVisTreeClass
 	
 	short calculate_endpoint_clipping_information(short endpoint_index, uint16 clip_flags);
 	
+	void fill_line_clipping_information(line_clip_data *data, short line_index, uint16 clip_flags);
+	
+	void fill_screen_line_clipping_information(line_clip_data *data);
+	
+	// Reusing the tree across frames:
+	// the tree, its endpoint clips and which endpoints got transformed depend only on where the
+	// view is in the plane and on which lines could be seen through; the line clips also depend
+	// on the view's height and pitch and on polygon heights, but can be recalculated in place
+	struct planar_view_key
+	{
+		short origin_polygon_index;
+		world_point2d origin;
+		angle yaw;
+		long_vector2d left_edge, right_edge;
+		short world_to_screen_x;
+		short half_screen_width, screen_width;
+	};
+	
+	struct line_crossing
+	{
+		short line_index;
+		short polygon_index, next_polygon_index;
+		uint16 flags; /* what classify_line_crossing() said, plus whether the line went on the automap */
+	};
+	
+	struct visited_endpoint
+	{
+		short endpoint_index;
+		world_point2d transformed;
+		uint16 flags;
+		bool transparent;
+	};
+	
+	struct line_clip_source
+	{
+		short line_index; /* NONE for the top and bottom of the screen */
+		uint16 clip_flags;
+	};
+	
+	bool tree_is_reusable;
+	planar_view_key tree_view_key;
+	
+	// Every line the rays looked at, once each, with what they found there
+	vector<line_crossing> LineCrossings;
+	vector<int32> line_crossing_indexes;
+	
+	vector<visited_endpoint> VisitedEndpoints;
+	vector<short> VisiblePolygons;
+	vector<line_clip_source> LineClipSources;
+	vector<uint16> TreeRenderFlags;
+	
+	void get_planar_view_key(planar_view_key& key);
+	
+	void record_line_crossing(short line_index, short polygon_index, short next_polygon_index, bool added_to_automap);
+	
+	void forget_tree();
+	
+	void remember_tree();
+	
+	bool tree_still_valid();
+	
+	void reuse_tree();
+	
 public:
 
 	/* gives screen x-coordinates for a map endpoint (only valid if _endpoint_is_visible) */
@@ -229,6 +292,18 @@ public:
 	// the automap.
 	bool add_to_automap;
 	
+	// If true, build_render_tree() keeps the last frame's tree when nothing it was built
+	// from has changed, only redoing the line clips if heights or the pitch moved
+	bool reuse_between_frames;
+	
+	// Bumped every time the tree is built anew, and every time its clipping data changes;
+	// the polygon sorter keeps its own results for as long as these hold still
+	uint32 tree_generation;
+	uint32 clip_generation;
+	
+	// Forget the kept tree (the map changed under it)
+	void invalidate_tree();
+	
 	// Resizes all the objects defined inside;
 	// the resizing is lazy
 	void Resize(size_t NumEndpoints, size_t NumLines);
@@ -34,6 +34,7 @@ Jan 30, 2000 (Loren Petrich):
 #include "preferences.h"
 #include "textures.h"
 #include "scottish_textures.h"
+#include "low_level_textures_simd.h"
 
 /* ---------- global state */
 
@@ -204,6 +205,8 @@ void texture_horizontal_polygon_lines
 		bmask = fmt->Bmask;
 	}
 
+	const texture_mapper32& mapper= get_texture_mapper32();
+
 	while ((line_count-= 1)>=0)
 	{
 		short x0= *x0_table++, x1= *x1_table++;
@@ -217,7 +220,13 @@ void texture_horizontal_polygon_lines
 		uint32 source_dy= data->source_dy;
 		short count= x1-x0;
 		
-		while ((count-= 1)>=0)
+		if (sizeof(T)==sizeof(pixel32) && sw_alpha_blend!=_sw_alpha_nice)
+		{
+			texture_span32 span= { (pixel32 *)write, base_address, (pixel32 *)shading_table, source_x, source_y, source_dx, source_dy,
+				HORIZONTAL_WIDTH_DOWNSHIFT, HORIZONTAL_HEIGHT_DOWNSHIFT-TEXBITS, ((1<<TEXBITS)-1)<<TEXBITS };
+			mapper.map_span(span, count, sw_alpha_blend==_sw_alpha_fast);
+		}
+		else while ((count-= 1)>=0)
 		{
 			write_pixel<T, sw_alpha_blend, false>(write++, base_address[((source_y>>(HORIZONTAL_HEIGHT_DOWNSHIFT-TEXBITS))&(((1<<TEXBITS)-1)<<TEXBITS))+(source_x>>HORIZONTAL_WIDTH_DOWNSHIFT)], shading_table, opacity_table, rmask, gmask, bmask);
 			
@@ -243,6 +252,7 @@ void landscape_horizontal_polygon_lines(
 	short line_count)
 {
 	short landscape_texture_width_downshift= 32 - NextLowerExponent(texture->height);
+	const texture_mapper32& mapper= get_texture_mapper32();
 
 	(void) (view);
 
@@ -257,7 +267,14 @@ void landscape_horizontal_polygon_lines(
 		uint32 source_dx= data->source_dx;
 		short count= x1-x0;
 		
-		while ((count-= 1)>=0)
+		/* a single row, so no y stepping */
+		if (sizeof(T)==sizeof(pixel32) && landscape_texture_width_downshift<32)
+		{
+			texture_span32 span= { (pixel32 *)write, read, (pixel32 *)shading_table, source_x, 0, source_dx, 0,
+				landscape_texture_width_downshift, 0, 0 };
+			mapper.map_span(span, count, false);
+		}
+		else while ((count-= 1)>=0)
 		{
 			*write++= shading_table[read[source_x>>landscape_texture_width_downshift]];
 			source_x+= source_dx;
@@ -294,6 +311,7 @@ void texture_vertical_polygon_lines(
 	bool aborted= false;
 	int x= data->x0;
 	int count;
+	const texture_mapper32& mapper= get_texture_mapper32();
 
 	(void) (view);
 
@@ -421,7 +439,21 @@ void texture_vertical_polygon_lines(
 				count= MIN(dy0, dy1), count= MIN(count, dy2), count= MIN(count, dy3);
 				ymax+= count;
 				
-				for (; count>0; --count)
+				if (sizeof(T)==sizeof(pixel32) && sw_alpha_blend!=_sw_alpha_nice)
+				{
+					texture_columns32 columns= { (pixel32 *)write, bytes_per_row,
+						{ read0, read1, read2, read3 },
+						{ (pixel32 *)shading_table0, (pixel32 *)shading_table1, (pixel32 *)shading_table2, (pixel32 *)shading_table3 },
+						{ texture_y0, texture_y1, texture_y2, texture_y3 },
+						{ texture_dy0, texture_dy1, texture_dy2, texture_dy3 },
+						downshift };
+					mapper.map_columns(columns, count, check_transparent, sw_alpha_blend==_sw_alpha_fast);
+					
+					write= (T *)columns.write;
+					texture_y0= columns.texture_y[0], texture_y1= columns.texture_y[1];
+					texture_y2= columns.texture_y[2], texture_y3= columns.texture_y[3];
+				}
+				else for (; count>0; --count)
 				{
 					write_pixel<T, sw_alpha_blend, check_transparent>(write, read0[texture_y0>>downshift], shading_table0, opacity_table, rmask, gmask, bmask);
 					texture_y0+= texture_dy0;
@@ -0,0 +1,422 @@
+/*
+LOW_LEVEL_TEXTURES_SIMD.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "low_level_textures_simd.h"
+
+#include <SDL2/SDL_cpuinfo.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2_TEXTURES
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled in for any x86 target, and only used if the CPU has it
+#if defined(HAVE_SSE2_TEXTURES) && (defined(__GNUC__) || defined(_MSC_VER))
+#define HAVE_AVX2_TEXTURES
+#include <immintrin.h>
+#ifdef __GNUC__
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+#define HAVE_NEON_TEXTURES
+#include <arm_neon.h>
+#endif
+
+/* ---------- scalar reference */
+
+// badly assume that the pixel format is ARGB; the same as average<pixel32>()
+static inline pixel32 average_pixel32(pixel32 fg, pixel32 bg)
+{
+	return (((fg ^ bg) & 0xfffefefe) >> 1) + (fg & bg);
+}
+
+static inline pixel8 span_texel(const texture_span32& span)
+{
+	return span.texture[((span.source_y>>span.y_downshift)&span.y_mask) + (span.source_x>>span.x_downshift)];
+}
+
+template <bool average>
+static void map_span_scalar(texture_span32& span, int count)
+{
+	for (; count>0; --count)
+	{
+		pixel32 pixel= span.shading_table[span_texel(span)];
+
+		*span.write= average ? average_pixel32(pixel, *span.write) : pixel;
+		span.write+= 1;
+		span.source_x+= span.source_dx, span.source_y+= span.source_dy;
+	}
+}
+
+static void map_span_scalar(texture_span32& span, int count, bool average)
+{
+	if (average)
+		map_span_scalar<true>(span, count);
+	else
+		map_span_scalar<false>(span, count);
+}
+
+template <bool check_transparent, bool average>
+static void map_columns_scalar(texture_columns32& columns, int count)
+{
+	for (; count>0; --count)
+	{
+		for (int i= 0; i<4; ++i)
+		{
+			pixel8 texel= columns.read[i][columns.texture_y[i]>>columns.downshift];
+
+			if (!check_transparent || texel)
+			{
+				pixel32 pixel= columns.shading_table[i][texel];
+				columns.write[i]= average ? average_pixel32(pixel, columns.write[i]) : pixel;
+			}
+			columns.texture_y[i]+= columns.texture_dy[i];
+		}
+		columns.write= (pixel32 *)((byte *)columns.write + columns.bytes_per_row);
+	}
+}
+
+static void map_columns_scalar(texture_columns32& columns, int count, bool check_transparent, bool average)
+{
+	if (check_transparent)
+	{
+		if (average) map_columns_scalar<true, true>(columns, count);
+		else map_columns_scalar<true, false>(columns, count);
+	}
+	else
+	{
+		if (average) map_columns_scalar<false, true>(columns, count);
+		else map_columns_scalar<false, false>(columns, count);
+	}
+}
+
+/* ---------- SSE2 */
+
+#ifdef HAVE_SSE2_TEXTURES
+
+static inline __m128i average_pixel32_sse2(__m128i fg, __m128i bg)
+{
+	__m128i half_difference= _mm_srli_epi32(_mm_and_si128(_mm_xor_si128(fg, bg), _mm_set1_epi32((int)0xfffefefe)), 1);
+	return _mm_add_epi32(half_difference, _mm_and_si128(fg, bg));
+}
+
+// SSE2 has no gathers: the texture coordinates are stepped and turned into offsets four at
+// a time, and the texels and shading tables are read one by one from those
+template <bool average>
+static void map_span_sse2(texture_span32& span, int count)
+{
+	if (count>=4)
+	{
+		uint32 dx= span.source_dx, dy= span.source_dy;
+		__m128i x= _mm_setr_epi32(span.source_x, span.source_x+dx, span.source_x+2*dx, span.source_x+3*dx);
+		__m128i y= _mm_setr_epi32(span.source_y, span.source_y+dy, span.source_y+2*dy, span.source_y+3*dy);
+		__m128i x_step= _mm_set1_epi32(4*dx), y_step= _mm_set1_epi32(4*dy);
+		__m128i x_downshift= _mm_cvtsi32_si128(span.x_downshift), y_downshift= _mm_cvtsi32_si128(span.y_downshift);
+		__m128i y_mask= _mm_set1_epi32(span.y_mask);
+		uint32 offsets[4];
+
+		for (; count>=4; count-= 4)
+		{
+			__m128i offset= _mm_add_epi32(_mm_and_si128(_mm_srl_epi32(y, y_downshift), y_mask), _mm_srl_epi32(x, x_downshift));
+			_mm_storeu_si128((__m128i *)offsets, offset);
+
+			__m128i pixels= _mm_setr_epi32(
+				span.shading_table[span.texture[offsets[0]]], span.shading_table[span.texture[offsets[1]]],
+				span.shading_table[span.texture[offsets[2]]], span.shading_table[span.texture[offsets[3]]]);
+			if (average) pixels= average_pixel32_sse2(pixels, _mm_loadu_si128((__m128i *)span.write));
+			_mm_storeu_si128((__m128i *)span.write, pixels);
+
+			span.write+= 4;
+			x= _mm_add_epi32(x, x_step), y= _mm_add_epi32(y, y_step);
+		}
+
+		span.source_x= _mm_cvtsi128_si32(x), span.source_y= _mm_cvtsi128_si32(y);
+	}
+
+	map_span_scalar<average>(span, count);
+}
+
+static void map_span_sse2(texture_span32& span, int count, bool average)
+{
+	if (average)
+		map_span_sse2<true>(span, count);
+	else
+		map_span_sse2<false>(span, count);
+}
+
+template <bool check_transparent, bool average>
+static void map_columns_sse2(texture_columns32& columns, int count)
+{
+	__m128i y= _mm_loadu_si128((const __m128i *)columns.texture_y);
+	__m128i dy= _mm_loadu_si128((const __m128i *)columns.texture_dy);
+	__m128i downshift= _mm_cvtsi32_si128(columns.downshift);
+	uint32 offsets[4];
+
+	for (; count>0; --count)
+	{
+		_mm_storeu_si128((__m128i *)offsets, _mm_srl_epi32(y, downshift));
+
+		pixel8 texel0= columns.read[0][offsets[0]], texel1= columns.read[1][offsets[1]];
+		pixel8 texel2= columns.read[2][offsets[2]], texel3= columns.read[3][offsets[3]];
+		__m128i pixels= _mm_setr_epi32(
+			columns.shading_table[0][texel0], columns.shading_table[1][texel1],
+			columns.shading_table[2][texel2], columns.shading_table[3][texel3]);
+
+		if (check_transparent || average)
+		{
+			__m128i under= _mm_loadu_si128((__m128i *)columns.write);
+
+			if (average) pixels= average_pixel32_sse2(pixels, under);
+			if (check_transparent)
+			{
+				__m128i transparent= _mm_cmpeq_epi32(_mm_setr_epi32(texel0, texel1, texel2, texel3), _mm_setzero_si128());
+				pixels= _mm_or_si128(_mm_and_si128(transparent, under), _mm_andnot_si128(transparent, pixels));
+			}
+		}
+		_mm_storeu_si128((__m128i *)columns.write, pixels);
+
+		y= _mm_add_epi32(y, dy);
+		columns.write= (pixel32 *)((byte *)columns.write + columns.bytes_per_row);
+	}
+
+	_mm_storeu_si128((__m128i *)columns.texture_y, y);
+}
+
+static void map_columns_sse2(texture_columns32& columns, int count, bool check_transparent, bool average)
+{
+	if (check_transparent)
+	{
+		if (average) map_columns_sse2<true, true>(columns, count);
+		else map_columns_sse2<true, false>(columns, count);
+	}
+	else
+	{
+		if (average) map_columns_sse2<false, true>(columns, count);
+		else map_columns_sse2<false, false>(columns, count);
+	}
+}
+
+#endif
+
+/* ---------- AVX2 */
+
+#ifdef HAVE_AVX2_TEXTURES
+
+// texels are still read one at a time: gathering whole words could read past the ends of
+// the texture; the shading tables are always whole words, so those lookups are gathered
+template <bool average>
+AVX2_TARGET static void map_span_avx2(texture_span32& span, int count)
+{
+	if (count>=8)
+	{
+		uint32 dx= span.source_dx, dy= span.source_dy;
+		__m256i steps= _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		__m256i x= _mm256_add_epi32(_mm256_set1_epi32(span.source_x), _mm256_mullo_epi32(steps, _mm256_set1_epi32(dx)));
+		__m256i y= _mm256_add_epi32(_mm256_set1_epi32(span.source_y), _mm256_mullo_epi32(steps, _mm256_set1_epi32(dy)));
+		__m256i x_step= _mm256_set1_epi32(8*dx), y_step= _mm256_set1_epi32(8*dy);
+		__m128i x_downshift= _mm_cvtsi32_si128(span.x_downshift), y_downshift= _mm_cvtsi32_si128(span.y_downshift);
+		__m256i y_mask= _mm256_set1_epi32(span.y_mask);
+		__m256i average_mask= _mm256_set1_epi32((int)0xfffefefe);
+		alignas(32) uint32 offsets[8];
+
+		for (; count>=8; count-= 8)
+		{
+			__m256i offset= _mm256_add_epi32(_mm256_and_si256(_mm256_srl_epi32(y, y_downshift), y_mask), _mm256_srl_epi32(x, x_downshift));
+			_mm256_store_si256((__m256i *)offsets, offset);
+
+			__m256i texels= _mm256_setr_epi32(
+				span.texture[offsets[0]], span.texture[offsets[1]], span.texture[offsets[2]], span.texture[offsets[3]],
+				span.texture[offsets[4]], span.texture[offsets[5]], span.texture[offsets[6]], span.texture[offsets[7]]);
+			__m256i pixels= _mm256_i32gather_epi32((const int *)span.shading_table, texels, 4);
+			if (average)
+			{
+				__m256i under= _mm256_loadu_si256((__m256i *)span.write);
+				pixels= _mm256_add_epi32(_mm256_srli_epi32(_mm256_and_si256(_mm256_xor_si256(pixels, under), average_mask), 1), _mm256_and_si256(pixels, under));
+			}
+			_mm256_storeu_si256((__m256i *)span.write, pixels);
+
+			span.write+= 8;
+			x= _mm256_add_epi32(x, x_step), y= _mm256_add_epi32(y, y_step);
+		}
+
+		span.source_x= _mm_cvtsi128_si32(_mm256_castsi256_si128(x)), span.source_y= _mm_cvtsi128_si32(_mm256_castsi256_si128(y));
+	}
+
+	map_span_scalar<average>(span, count);
+}
+
+AVX2_TARGET static void map_span_avx2(texture_span32& span, int count, bool average)
+{
+	if (average)
+		map_span_avx2<true>(span, count);
+	else
+		map_span_avx2<false>(span, count);
+}
+
+#endif
+
+/* ---------- NEON */
+
+#ifdef HAVE_NEON_TEXTURES
+
+static inline uint32x4_t average_pixel32_neon(uint32x4_t fg, uint32x4_t bg)
+{
+	uint32x4_t half_difference= vshrq_n_u32(vandq_u32(veorq_u32(fg, bg), vdupq_n_u32(0xfffefefe)), 1);
+	return vaddq_u32(half_difference, vandq_u32(fg, bg));
+}
+
+template <bool average>
+static void map_span_neon(texture_span32& span, int count)
+{
+	if (count>=4)
+	{
+		uint32 dx= span.source_dx, dy= span.source_dy;
+		const uint32 x_start[4]= { span.source_x, span.source_x+dx, span.source_x+2*dx, span.source_x+3*dx };
+		const uint32 y_start[4]= { span.source_y, span.source_y+dy, span.source_y+2*dy, span.source_y+3*dy };
+		uint32x4_t x= vld1q_u32(x_start), y= vld1q_u32(y_start);
+		uint32x4_t x_step= vdupq_n_u32(4*dx), y_step= vdupq_n_u32(4*dy);
+		// negative shifts shift right
+		int32x4_t x_downshift= vdupq_n_s32(-span.x_downshift), y_downshift= vdupq_n_s32(-span.y_downshift);
+		uint32x4_t y_mask= vdupq_n_u32(span.y_mask);
+		uint32 offsets[4];
+
+		for (; count>=4; count-= 4)
+		{
+			vst1q_u32(offsets, vaddq_u32(vandq_u32(vshlq_u32(y, y_downshift), y_mask), vshlq_u32(x, x_downshift)));
+
+			const uint32 fetched[4]= {
+				span.shading_table[span.texture[offsets[0]]], span.shading_table[span.texture[offsets[1]]],
+				span.shading_table[span.texture[offsets[2]]], span.shading_table[span.texture[offsets[3]]] };
+			uint32x4_t pixels= vld1q_u32(fetched);
+			if (average) pixels= average_pixel32_neon(pixels, vld1q_u32(span.write));
+			vst1q_u32(span.write, pixels);
+
+			span.write+= 4;
+			x= vaddq_u32(x, x_step), y= vaddq_u32(y, y_step);
+		}
+
+		span.source_x= vgetq_lane_u32(x, 0), span.source_y= vgetq_lane_u32(y, 0);
+	}
+
+	map_span_scalar<average>(span, count);
+}
+
+static void map_span_neon(texture_span32& span, int count, bool average)
+{
+	if (average)
+		map_span_neon<true>(span, count);
+	else
+		map_span_neon<false>(span, count);
+}
+
+template <bool check_transparent, bool average>
+static void map_columns_neon(texture_columns32& columns, int count)
+{
+	uint32x4_t y= vld1q_u32(columns.texture_y);
+	uint32x4_t dy= vld1q_u32(columns.texture_dy);
+	int32x4_t downshift= vdupq_n_s32(-columns.downshift);
+	uint32 offsets[4];
+
+	for (; count>0; --count)
+	{
+		vst1q_u32(offsets, vshlq_u32(y, downshift));
+
+		const uint32 texels[4]= {
+			columns.read[0][offsets[0]], columns.read[1][offsets[1]],
+			columns.read[2][offsets[2]], columns.read[3][offsets[3]] };
+		const uint32 fetched[4]= {
+			columns.shading_table[0][texels[0]], columns.shading_table[1][texels[1]],
+			columns.shading_table[2][texels[2]], columns.shading_table[3][texels[3]] };
+		uint32x4_t pixels= vld1q_u32(fetched);
+
+		if (check_transparent || average)
+		{
+			uint32x4_t under= vld1q_u32(columns.write);
+
+			if (average) pixels= average_pixel32_neon(pixels, under);
+			if (check_transparent) pixels= vbslq_u32(vceqq_u32(vld1q_u32(texels), vdupq_n_u32(0)), under, pixels);
+		}
+		vst1q_u32(columns.write, pixels);
+
+		y= vaddq_u32(y, dy);
+		columns.write= (pixel32 *)((byte *)columns.write + columns.bytes_per_row);
+	}
+
+	vst1q_u32(columns.texture_y, y);
+}
+
+static void map_columns_neon(texture_columns32& columns, int count, bool check_transparent, bool average)
+{
+	if (check_transparent)
+	{
+		if (average) map_columns_neon<true, true>(columns, count);
+		else map_columns_neon<true, false>(columns, count);
+	}
+	else
+	{
+		if (average) map_columns_neon<false, true>(columns, count);
+		else map_columns_neon<false, false>(columns, count);
+	}
+}
+
+#endif
+
+/* ---------- dispatch */
+
+std::vector<texture_mapper32> get_available_texture_mappers32(
+	void)
+{
+	std::vector<texture_mapper32> mappers;
+
+	texture_mapper32 scalar= { "scalar", map_span_scalar, map_columns_scalar };
+	mappers.push_back(scalar);
+
+#ifdef HAVE_SSE2_TEXTURES
+	texture_mapper32 sse2= { "sse2", map_span_sse2, map_columns_sse2 };
+	mappers.push_back(sse2);
+#endif
+
+#ifdef HAVE_AVX2_TEXTURES
+	// four columns fit SSE2's registers; there's nothing for AVX2 to add there
+	if (SDL_HasAVX2())
+	{
+		texture_mapper32 avx2= { "avx2", map_span_avx2, map_columns_sse2 };
+		mappers.push_back(avx2);
+	}
+#endif
+
+#ifdef HAVE_NEON_TEXTURES
+	texture_mapper32 neon= { "neon", map_span_neon, map_columns_neon };
+	mappers.push_back(neon);
+#endif
+
+	return mappers;
+}
+
+const texture_mapper32& get_texture_mapper32(
+	void)
+{
+	static const texture_mapper32 mapper= get_available_texture_mappers32().back();
+	return mapper;
+}
@@ -0,0 +1,78 @@
+#ifndef __LOW_LEVEL_TEXTURES_SIMD_H
+#define __LOW_LEVEL_TEXTURES_SIMD_H
+
+/*
+LOW_LEVEL_TEXTURES_SIMD.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Vectorized inner loops for the 32-bit texture mappers in low_level_textures.h: texel
+	fetch, shading-table lookup and the fast (averaging) transparency blend, for SSE2, AVX2
+	and NEON.  Every implementation writes exactly the pixels the scalar loops do; the one
+	to use is picked once, at runtime, from what the CPU supports.
+*/
+
+#include "cseries.h"
+
+#include <vector>
+
+/* one horizontal span: for each pixel,
+	*write++= shading_table[texture[((source_y>>y_downshift)&y_mask) + (source_x>>x_downshift)]]
+	then source_x+= source_dx, source_y+= source_dy.  x_downshift and y_downshift must be
+	less than 32. */
+struct texture_span32
+{
+	pixel32 *write;
+	const pixel8 *texture;
+	const pixel32 *shading_table;
+	uint32 source_x, source_y;
+	uint32 source_dx, source_dy;
+	int x_downshift, y_downshift;
+	uint32 y_mask;
+};
+
+/* four adjacent columns, drawn downward for the same number of rows: column i reads
+	read[i][texture_y[i]>>downshift] and steps texture_y[i] by texture_dy[i].  texture_y and
+	write are left where the next row would start. */
+struct texture_columns32
+{
+	pixel32 *write;
+	int bytes_per_row;
+	const pixel8 *read[4];
+	const pixel32 *shading_table[4];
+	uint32 texture_y[4], texture_dy[4];
+	int downshift;
+};
+
+struct texture_mapper32
+{
+	const char *name;
+
+	/* average blends each new pixel with the one underneath (_sw_alpha_fast) */
+	void (*map_span)(texture_span32& span, int count, bool average);
+
+	/* check_transparent leaves pixels under color 0 of the texture alone */
+	void (*map_columns)(texture_columns32& columns, int count, bool check_transparent, bool average);
+};
+
+/* the fastest implementation this CPU can run */
+const texture_mapper32& get_texture_mapper32(void);
+
+/* every implementation this build and CPU can run, the scalar reference first */
+std::vector<texture_mapper32> get_available_texture_mappers32(void);
+
+#endif
@@ -234,6 +234,7 @@ extern WindowPtr screen_window;
 #include "RenderPlaceObjs.h"
 #include "RenderRasterize.h"
 #include "Rasterizer_SW.h"
+#include "Rasterizer_SW_Banded.h"
 #ifdef HAVE_OPENGL
 #include "Rasterizer_OGL.h"
 #include "RenderRasterize_Shader.h"
@@ -290,6 +291,7 @@ static RenderPlaceObjsClass RenderPlaceObjs;		// Object-placement object
 static RenderRasterizerClass Render_Classic;		// Clipping and rasterization class
 
 static Rasterizer_SW_Class Rasterizer_SW;			// Software rasterizer
+static Rasterizer_SW_Banded_Class Rasterizer_SW_Banded;	// Multithreaded software rasterizer
 #ifdef HAVE_OPENGL
 static Rasterizer_OGL_Class Rasterizer_OGL;			// OpenGL rasterizer
 static Rasterizer_Shader_Class Rasterizer_Shader;   // Shader rasterizer
@@ -348,6 +350,10 @@ void allocate_render_memory(
 	RenderVisTree.Resize(MAXIMUM_ENDPOINTS_PER_MAP,MAXIMUM_LINES_PER_MAP);
 	RenderSortPoly.Resize(MAXIMUM_POLYGONS_PER_MAP);
 	
+	// Keep the main view's tree while the view holds still; a new map means a new tree
+	RenderVisTree.reuse_between_frames = true;
+	RenderVisTree.invalidate_tree();
+	
 	// Reset to have the tree correctly resized if m1 exploration level
 	explore_tree.view = nullptr;
 	// LP change: set up pointers
@@ -472,8 +478,16 @@ void render_view(
 			{
 #endif
 				assert(software_render_dest);
-				Rasterizer_SW.screen = software_render_dest;
-				RasPtr = &Rasterizer_SW;
+				if (graphics_preferences->software_multithreaded_rendering)
+				{
+					Rasterizer_SW_Banded.screen = software_render_dest;
+					RasPtr = &Rasterizer_SW_Banded;
+				}
+				else
+				{
+					Rasterizer_SW.screen = software_render_dest;
+					RasPtr = &Rasterizer_SW;
+				}
 #ifdef HAVE_OPENGL
 			}
 #endif
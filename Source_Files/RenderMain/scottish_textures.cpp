@@ -170,16 +170,6 @@ static void calculate_shading_table(void * &result,view_data *view, void *shadin
 	} 
 }
 
-/* ---------- globals */
-
-/* these tables are used by the polygon rasterizer (to store the x-coordinates of the left and
-	right lines of the current polygon), the trapezoid rasterizer (to store the y-coordinates
-	of the top and bottom of the current trapezoid) and the rectangle mapper (for it’s
-	vertical and if necessary horizontal distortion tables).  these are not necessary as
-	globals, just as global storage. */
-static short *scratch_table0 = NULL, *scratch_table1 = NULL;
-static void *precalculation_table = NULL;
-
 /* ---------- private prototypes */
 
 template<int TEXBITS> static void _pretexture_horizontal_polygon_lines(struct polygon_definition *polygon,
@@ -197,17 +187,30 @@ static void _prelandscape_horizontal_polygon_lines(struct polygon_definition *po
 	struct bitmap_definition *screen, struct view_data *view, struct _horizontal_polygon_line_data *data,
 	short y0, short *x0_table, short *x1_table, short line_count);
 
+static void clip_horizontal_polygon_lines(short band_left, short band_right, struct _horizontal_polygon_line_data *data,
+	short *x0_table, short *x1_table, short line_count, bool step_source_y);
+
 /* ---------- code */
 
-/* set aside memory at launch for two line tables (remember, we precalculate all the y-values
-	for trapezoids and two lines worth of x-values for polygons before mapping them) */
-void allocate_texture_tables(
-	void)
+/* set aside memory for two line tables (remember, we precalculate all the y-values for
+	trapezoids and two lines worth of x-values for polygons before mapping them).  these are used
+	by the polygon rasterizer (to store the x-coordinates of the left and right lines of the
+	current polygon), the trapezoid rasterizer (to store the y-coordinates of the top and bottom
+	of the current trapezoid) and the rectangle mapper (for it’s vertical and if necessary
+	horizontal distortion tables). */
+Rasterizer_SW_Class::Rasterizer_SW_Class() :
+	view(NULL), screen(NULL), band_left(0), band_right(SHRT_MAX)
 {
 	scratch_table0= new short[MAXIMUM_SCRATCH_TABLE_ENTRIES];
 	scratch_table1= new short[MAXIMUM_SCRATCH_TABLE_ENTRIES];
 	precalculation_table= (void*)new char[MAXIMUM_PRECALCULATION_TABLE_ENTRY_SIZE*MAXIMUM_SCRATCH_TABLE_ENTRIES];
-	fc_assert(scratch_table0&&scratch_table1&&precalculation_table);
+}
+
+Rasterizer_SW_Class::~Rasterizer_SW_Class()
+{
+	delete[] scratch_table0;
+	delete[] scratch_table1;
+	delete[] (char *)precalculation_table;
 }
 
 void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& textured_polygon)
@@ -237,6 +240,18 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
 		else if (vertices[vertex].y>vertices[lowest_vertex].y) lowest_vertex= vertex;
 	}
 
+	/* skip polygons entirely outside our band */
+	{
+		short leftmost_x= vertices[0].x, rightmost_x= vertices[0].x;
+
+		for (vertex= 1; vertex<polygon->vertex_count; ++vertex)
+		{
+			leftmost_x= MIN(leftmost_x, vertices[vertex].x);
+			rightmost_x= MAX(rightmost_x, vertices[vertex].x);
+		}
+		if (rightmost_x<=band_left || leftmost_x>=band_right) return;
+	}
+
 	/* if this polygon is not a horizontal line, draw it */
 	if (highest_vertex!=lowest_vertex)
 	{
@@ -321,6 +336,10 @@ void Rasterizer_SW_Class::texture_horizontal_polygon(polygon_definition& texture
 				VHALT_DEBUG(csprintf(temporary, "horizontal_polygons dont support mode #%d", polygon->transfer_mode));
 		}
 		
+		/* landscape lines pick their texture row once, so only step source_x into the band */
+		clip_horizontal_polygon_lines(band_left, band_right, (struct _horizontal_polygon_line_data *)precalculation_table,
+			left_table, right_table, aggregate_total_line_count, polygon->transfer_mode!=_big_landscaped_transfer);
+		
 		/* render all lines */
 		switch (bit_depth)
 		{
@@ -520,11 +539,20 @@ void Rasterizer_SW_Class::texture_vertical_polygon(polygon_definition& textured_
 		fc_assert(aggregate_right_line_count==aggregate_total_line_count);
 		fc_assert(aggregate_left_line_count==aggregate_total_line_count);
 
+		/* only precalculate and map the columns in our band; every column is calculated on its
+			own, so this doesn’t change any of them */
+		short first_x= MAX(vertices[highest_vertex].x, band_left);
+		short last_x= MIN(vertices[lowest_vertex].x, band_right);
+		if (first_x>=last_x) return;
+		left_table+= first_x-vertices[highest_vertex].x;
+		right_table+= first_x-vertices[highest_vertex].x;
+		aggregate_total_line_count= last_x-first_x;
+
 		/* precalculate mode-specific data */
 
           if ((polygon->transfer_mode == _textured_transfer) || (polygon->transfer_mode == _static_transfer))
           {
-			  TEXBITS_DISPATCH(polygon->texture, _pretexture_vertical_polygon_lines, (polygon, screen, view, (struct _vertical_polygon_data *)precalculation_table, vertices[highest_vertex].x, left_table, right_table, aggregate_total_line_count));
+			  TEXBITS_DISPATCH(polygon->texture, _pretexture_vertical_polygon_lines, (polygon, screen, view, (struct _vertical_polygon_data *)precalculation_table, first_x, left_table, right_table, aggregate_total_line_count));
           }
           else VHALT_DEBUG(csprintf(temporary, "vertical_polygons dont support mode #%d", polygon->transfer_mode));
           
@@ -665,6 +693,8 @@ void Rasterizer_SW_Class::texture_rectangle(rectangle_definition& textured_recta
 		if (rectangle->clip_right>screen->width) rectangle->clip_right= screen->width;
 		if (rectangle->clip_top<0) rectangle->clip_top= 0;
 		if (rectangle->clip_bottom>screen->height) rectangle->clip_bottom= screen->height;
+		if (rectangle->clip_left<band_left) rectangle->clip_left= band_left;
+		if (rectangle->clip_right>band_right) rectangle->clip_right= band_right;
 	
 		/* subsume left and right sides of the rectangle into clipping parameters */
 		if (rectangle->clip_left<rectangle->x0) rectangle->clip_left= rectangle->x0;
@@ -1169,6 +1199,35 @@ static void _prelandscape_horizontal_polygon_lines(
 	}
 }
 
+/* narrow every line to [band_left, band_right), stepping the texture coordinates over the
+	skipped pixels exactly as the line mappers would have (the sums wrap the same way) */
+static void clip_horizontal_polygon_lines(
+	short band_left,
+	short band_right,
+	struct _horizontal_polygon_line_data *data,
+	short *x0_table,
+	short *x1_table,
+	short line_count,
+	bool step_source_y)
+{
+	while ((line_count-= 1)>=0)
+	{
+		short delta= band_left - *x0_table;
+
+		if (delta>0)
+		{
+			*x0_table= band_left;
+			data->source_x+= data->source_dx*(uint32)delta;
+			if (step_source_y) data->source_y+= data->source_dy*(uint32)delta;
+		}
+		if (*x1_table>band_right) *x1_table= band_right;
+		if (*x1_table<*x0_table) *x1_table= *x0_table;
+
+		x0_table++, x1_table++;
+		data+= 1;
+	}
+}
+
 /* y0<y1; this is for vertical polygons */
 static short *build_x_table(
 	short *table,
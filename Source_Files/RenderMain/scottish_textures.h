@@ -217,8 +217,4 @@ extern short interface_bit_depth;
 
 extern short number_of_shading_tables, shading_table_fractional_bits, shading_table_size;
 
-/* ---------- prototypes/SCOTTISH_TEXTURES.C */
-
-void allocate_texture_tables(void);
-
 #endif
@@ -51,6 +51,7 @@
 #include "fades.h"
 #include "game_window.h"
 #include "screen.h"
+#include "screen_blit.h"
 #include "preferences.h"
 #include "computer_interface.h"
 #include "Crosshairs.h"
@@ -87,7 +88,6 @@ static SDL_Texture *main_texture;
 // The HUD has a separate buffer.
 // It is initialized to NULL so as to allow its initing to be lazy.
 SDL_Surface *world_pixels = NULL;
-SDL_Surface *world_pixels_corrected = NULL;
 SDL_Surface *HUD_Buffer = NULL;
 SDL_Surface *Term_Buffer = NULL;
 SDL_Surface *Intro_Buffer = NULL; // intro screens, main menu, chapters, credits, etc.
@@ -133,7 +133,6 @@ static bool get_auto_resolution_size(short *w, short *h, struct screen_mode_data
 static void build_sdl_color_table(const color_table *color_table, SDL_Color *colors);
 static void reallocate_world_pixels(int width, int height);
 static void reallocate_map_pixels(int width, int height);
-static void apply_gamma(SDL_Surface *src, SDL_Surface *dst);
 static void update_screen(SDL_Rect &source, SDL_Rect &destination, bool hi_rez, bool every_other_line);
 static void update_fps_display(SDL_Surface *s);
 static void DisplayPosition(SDL_Surface *s);
@@ -282,11 +281,8 @@ void Screen::Initialize(screen_mode_data* mode)
 		unload_all_collections();
 		if (world_pixels)
 			SDL_FreeSurface(world_pixels);
-		if (world_pixels_corrected)
-			SDL_FreeSurface(world_pixels_corrected);
 	}
 	world_pixels = NULL;
-	world_pixels_corrected = NULL;
 
 	screen_mode = *mode;
 	change_screen_mode(&screen_mode, true);
@@ -592,10 +588,6 @@ static void reallocate_world_pixels(int width, int height)
 		SDL_FreeSurface(world_pixels);
 		world_pixels = NULL;
 	}
-	if (world_pixels_corrected) {
-		SDL_FreeSurface(world_pixels_corrected);
-		world_pixels_corrected = NULL;
-	}
 
 	switch (bit_depth)
 	{
@@ -617,8 +609,7 @@ static void reallocate_world_pixels(int width, int height)
 		SDL_Color colors[256];
 		build_sdl_color_table(world_color_table, colors);
 		SDL_SetPaletteColors(world_pixels->format->palette, colors, 0, 256);
-	} else
-		world_pixels_corrected = SDL_CreateRGBSurface(SDL_SWSURFACE, width, height, world_pixels->format->BitsPerPixel, world_pixels->format->Rmask, world_pixels->format->Gmask, world_pixels->format->Bmask, 0);
+	}
 }
 
 static void reallocate_map_pixels(int width, int height)
@@ -1597,166 +1588,50 @@ void render_screen(short ticks_elapsed)
  *  Blit world view to screen
  */
 
-template <class T>
-static inline void quadruple_surface(
-	const T *src,
-	int src_pitch,
-	T *dst, int dst_pitch,
-	const SDL_Rect &dst_rect,
-	bool every_other_line)
-{
-	int width = dst_rect.w / 2;
-	int height = dst_rect.h / 2;
-	dst += dst_rect.y * dst_pitch / sizeof(T) + dst_rect.x;
-	T *dst2 = dst + dst_pitch / sizeof(T);
-
-	uint32 black_pixel = SDL_MapRGB(main_surface->format, 0, 0, 0);
-	bool overlay_active = world_view->overhead_map_active
-		&& map_is_translucent();
-	
-	while (height-- > 0) {
-		if (every_other_line) {
-			if (overlay_active) {
-				// overlay map needs us to clear all the scanlines, so we have
-				// to put black in the "skipped" lines
-				for (int x=0; x<width; x++) {
-					dst[x * 2] = dst[x * 2 + 1] = src[x];
-					dst2[x * 2] = dst2[x * 2 + 1] = black_pixel;
-				}
-			} else {
-				for (int x=0; x<width; x++) {
-					dst[x * 2] = dst[x * 2 + 1] = src[x];
-				}
-			}
-		} else {
-			for (int x=0; x<width; x++) {
-				T p = src[x];
-				dst[x * 2] = dst[x * 2 + 1] = p;
-				dst2[x * 2] = dst2[x * 2 + 1] = p;
-			}
-		}
+static void update_screen(SDL_Rect &source, SDL_Rect &destination, bool hi_rez, bool every_other_line)
+{
+	SDL_Surface *s = world_pixels;
+	bool correct_gamma = !using_default_gamma && bit_depth > 8;
 
-		src += src_pitch / sizeof(T);
-		dst += dst_pitch * 2 / sizeof(T);
-		dst2 += dst_pitch * 2 / sizeof(T);
+	// nothing to do but copy; SDL's blitter is as good as it gets
+	if (hi_rez && !correct_gamma)
+	{
+		SDL_BlitSurface(s, NULL, main_surface, &destination);
+		return;
 	}
-}
 
-static void apply_gamma(SDL_Surface *src, SDL_Surface *dst)
-{
-	if (SDL_MUSTLOCK(dst)) {
-	    if (SDL_LockSurface(dst) < 0) return;
+	if (SDL_MUSTLOCK(main_surface))
+	{
+		if (SDL_LockSurface(main_surface) < 0) return;
 	}
-	uint32 px, dst_px;
-	uint8 src_r, src_g, src_b;
-	uint8 dst_r, dst_g, dst_b;
-	
-	uint32 srm = src->format->Rmask, sgm = src->format->Gmask, sbm = src->format->Bmask;
-	uint32 drm = dst->format->Rmask, dgm = dst->format->Gmask, dbm = dst->format->Bmask;
-	uint32 srs = src->format->Rshift, sgs = src->format->Gshift, sbs = src->format->Bshift;
-	uint32 drs = dst->format->Rshift, dgs = dst->format->Gshift, dbs = dst->format->Bshift;
-	uint32 srl = src->format->Rloss, sgl = src->format->Gloss, sbl = src->format->Bloss;
-	uint32 drl = dst->format->Rloss, dgl = dst->format->Gloss, dbl = dst->format->Bloss;
-	
-	int sbpp = src->format->BytesPerPixel;
-	int dbpp = dst->format->BytesPerPixel;
-	uint8 *sptr = static_cast<uint8*>(src->pixels);
-	uint8 *dptr = static_cast<uint8*>(dst->pixels);
-	size_t numpixels = src->w * src->h;
-	for (size_t i = 0; i < numpixels; ++i) {
-		switch (sbpp) {
-			case 2:
-				px = reinterpret_cast<uint16*>(sptr)[i];
-				break;
-			case 4:
-				px = reinterpret_cast<uint32*>(sptr)[i];
-				break;
-			default:
-				return;
-		}
-	
-		src_r = ((px & srm) >> srs) << srl;
-		src_g = ((px & sgm) >> sgs) << sgl;
-		src_b = ((px & sbm) >> sbs) << sbl;
-		dst_r = current_gamma_r[src_r] >> 8;
-		dst_g = current_gamma_g[src_g] >> 8;
-		dst_b = current_gamma_b[src_b] >> 8;
-		dst_px = (((dst_r >> drl) << drs) & drm) |
-				 (((dst_g >> dgl) << dgs) & dgm) |
-				 (((dst_b >> dbl) << dbs) & dbm);
-			
-		switch (dbpp) {
-			case 2:
-				reinterpret_cast<uint16*>(dptr)[i] = dst_px;
-				break;
-			case 4:
-				reinterpret_cast<uint32*>(dptr)[i] = dst_px;
-				break;
-			default:
-				return;
-		}
+
+	// 8-bit gets its gamma from the palette, so all that's left is to convert it
+	SDL_Surface* intermediary = 0;
+	if (s->format->BytesPerPixel == 1)
+	{
+		intermediary = SDL_ConvertSurface(s, main_surface->format, s->flags);
+		s = intermediary;
 	}
-	if (SDL_MUSTLOCK(dst))
-		SDL_UnlockSurface(dst);
-}
 
-static inline bool pixel_formats_equal(SDL_PixelFormat* a, SDL_PixelFormat* b)
-{
-	return (a->BytesPerPixel == b->BytesPerPixel &&
-		a->Rmask == b->Rmask &&
-		a->Gmask == b->Gmask &&
-		a->Bmask == b->Bmask);
-}
+	// overlay map needs us to clear all the scanlines, so we have to put black in the
+	// "skipped" lines
+	bool overlay_active = world_view->overhead_map_active && map_is_translucent();
 
-static void update_screen(SDL_Rect &source, SDL_Rect &destination, bool hi_rez, bool every_other_line)
-{
-	SDL_Surface *s = world_pixels;
-	if (!using_default_gamma && bit_depth > 8) {
-		apply_gamma(world_pixels, world_pixels_corrected);
-		s = world_pixels_corrected;
-	}
-		
-	if (hi_rez) 
+	// gamma, conversion and doubling in one pass
+	if (s)
 	{
-		SDL_BlitSurface(s, NULL, main_surface, &destination);
-	} 
-	else 
-	{
-		SDL_Surface* intermediary = 0;
-		if (SDL_MUSTLOCK(main_surface)) 
-		{
-			if (SDL_LockSurface(main_surface) < 0) return;
-		}
-
-		if (!pixel_formats_equal(s->format, main_surface->format))
-		{
-			intermediary = SDL_ConvertSurface(s, main_surface->format, s->flags);
-			s = intermediary;
-		}
+		screen_blit(s, main_surface, destination.x, destination.y, hi_rez ? 1 : 2, every_other_line, overlay_active,
+			correct_gamma ? current_gamma_r : NULL, correct_gamma ? current_gamma_g : NULL, correct_gamma ? current_gamma_b : NULL);
+	}
 
-		switch (s->format->BytesPerPixel) 
-		{
-		case 1:
-			quadruple_surface((pixel8 *)s->pixels, s->pitch, (pixel8 *)main_surface->pixels, main_surface->pitch, destination, every_other_line);
-			break;
-		case 2:
-			quadruple_surface((pixel16 *)s->pixels, s->pitch, (pixel16 *)main_surface->pixels, main_surface->pitch, destination, every_other_line);
-			break;
-		case 4:
-			quadruple_surface((pixel32 *)s->pixels, s->pitch, (pixel32 *)main_surface->pixels, main_surface->pitch, destination, every_other_line);
-			break;
-		}
-		
-		if (SDL_MUSTLOCK(main_surface)) {
-			SDL_UnlockSurface(main_surface);
-		}
+	if (SDL_MUSTLOCK(main_surface)) {
+		SDL_UnlockSurface(main_surface);
+	}
 
-		if (intermediary) 
-		{
-			SDL_FreeSurface(intermediary);
-		}
+	if (intermediary)
+	{
+		SDL_FreeSurface(intermediary);
 	}
-//	SDL_UpdateRects(main_surface, 1, &destination);
 }
 
 
@@ -2115,7 +1990,7 @@ void draw_intro_screen(void)
 	{
 		SDL_Surface *s = Intro_Buffer;
 		if (!using_default_gamma) {
-			apply_gamma(Intro_Buffer, Intro_Buffer_corrected);
+			screen_blit(Intro_Buffer, Intro_Buffer_corrected, 0, 0, 1, false, false, current_gamma_r, current_gamma_g, current_gamma_b);
 			SDL_SetSurfaceBlendMode(Intro_Buffer_corrected, SDL_BLENDMODE_NONE);
 			s = Intro_Buffer_corrected;
 		}
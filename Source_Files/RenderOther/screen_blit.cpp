@@ -0,0 +1,370 @@
+/*
+SCREEN_BLIT.CPP
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+*/
+
+#include "screen_blit.h"
+
+#include <SDL2/SDL_cpuinfo.h>
+#include <algorithm>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SSE2_BLIT
+#include <emmintrin.h>
+#endif
+
+// AVX2 is compiled in for any x86 target, and only used if the CPU has it
+#if defined(HAVE_SSE2_BLIT) && (defined(__GNUC__) || defined(_MSC_VER))
+#define HAVE_AVX2_BLIT
+#include <immintrin.h>
+#ifdef __GNUC__
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#endif
+
+/* ---------- lookup tables */
+
+/* everything that happens to a pixel on its way to dst (gamma, then format conversion) is
+	per channel, so it fits in one table per channel, indexed by the source channel's bits
+	and holding that channel already shifted into place in dst; converting a pixel is then
+	three lookups ORed together */
+struct blit_tables
+{
+	bool convert;
+	int red_shift, green_shift, blue_shift;
+	uint32 red_index_mask, green_index_mask, blue_index_mask;
+	uint32 red[256], green[256], blue[256];
+	uint32 black;
+};
+
+static bool same_format(
+	const SDL_PixelFormat *a,
+	const SDL_PixelFormat *b)
+{
+	return a->BytesPerPixel == b->BytesPerPixel &&
+		a->Rmask == b->Rmask && a->Gmask == b->Gmask && a->Bmask == b->Bmask && a->Amask == b->Amask;
+}
+
+static void build_channel(
+	uint32 *table,
+	int channel,
+	uint32 src_mask,
+	int src_shift,
+	int src_loss,
+	uint32 dst_mask,
+	int dst_shift,
+	int dst_loss,
+	const uint16 *gamma,
+	SDL_PixelFormat *src_format,
+	bool convert)
+{
+	uint32 index_mask= src_mask >> src_shift;
+
+	for (uint32 value= 0; value <= index_mask; ++value)
+	{
+		uint32 raw= value;
+		if (gamma)
+		{
+			/* exactly what correcting into a surface of src's format used to leave there */
+			uint8 corrected= gamma[static_cast<uint8>(value << src_loss)] >> 8;
+			raw= (corrected >> src_loss) & index_mask;
+		}
+
+		if (convert)
+		{
+			/* widen the channel the way SDL does when it blits between formats */
+			Uint8 rgb[3];
+			SDL_GetRGB(raw << src_shift, src_format, &rgb[0], &rgb[1], &rgb[2]);
+			table[value]= ((rgb[channel] >> dst_loss) << dst_shift) & dst_mask;
+		}
+		else
+		{
+			table[value]= raw << src_shift;
+		}
+	}
+}
+
+static void build_blit_tables(
+	blit_tables& tables,
+	SDL_PixelFormat *src,
+	SDL_PixelFormat *dst,
+	const uint16 *gamma_red,
+	const uint16 *gamma_green,
+	const uint16 *gamma_blue)
+{
+	bool convert= !same_format(src, dst);
+
+	tables.convert= convert || gamma_red;
+	tables.red_shift= src->Rshift;
+	tables.green_shift= src->Gshift;
+	tables.blue_shift= src->Bshift;
+	tables.red_index_mask= src->Rmask >> src->Rshift;
+	tables.green_index_mask= src->Gmask >> src->Gshift;
+	tables.blue_index_mask= src->Bmask >> src->Bshift;
+	tables.black= SDL_MapRGB(dst, 0, 0, 0);
+
+	if (!tables.convert) return;
+
+	build_channel(tables.red, 0, src->Rmask, src->Rshift, src->Rloss,
+		dst->Rmask, dst->Rshift, dst->Rloss, gamma_red, src, convert);
+	build_channel(tables.green, 1, src->Gmask, src->Gshift, src->Gloss,
+		dst->Gmask, dst->Gshift, dst->Gloss, gamma_green, src, convert);
+	build_channel(tables.blue, 2, src->Bmask, src->Bshift, src->Bloss,
+		dst->Bmask, dst->Bshift, dst->Bloss, gamma_blue, src, convert);
+
+	/* src has no alpha, so SDL would have made every converted pixel opaque */
+	if (convert && dst->Amask)
+	{
+		for (int i= 0; i < 256; ++i)
+		{
+			tables.red[i]|= dst->Amask;
+		}
+	}
+}
+
+/* ---------- rows */
+
+typedef void (*blit_row_function)(const void *src, void *dst, int width, int scale, const blit_tables& tables);
+
+template <typename S, typename D, bool convert>
+static inline D blit_pixel(
+	S pixel,
+	const blit_tables& tables)
+{
+	if (!convert) return static_cast<D>(pixel);
+
+	return static_cast<D>(tables.red[(pixel >> tables.red_shift) & tables.red_index_mask] |
+		tables.green[(pixel >> tables.green_shift) & tables.green_index_mask] |
+		tables.blue[(pixel >> tables.blue_shift) & tables.blue_index_mask]);
+}
+
+template <typename S, typename D, bool convert>
+static void blit_row(
+	const void *src_row,
+	void *dst_row,
+	int width,
+	int scale,
+	const blit_tables& tables)
+{
+	const S *src= static_cast<const S *>(src_row);
+	D *dst= static_cast<D *>(dst_row);
+
+	if (scale == 1)
+	{
+		if (!convert)
+		{
+			memcpy(dst, src, width * sizeof(D));
+			return;
+		}
+
+		for (int x= 0; x < width; ++x)
+		{
+			dst[x]= blit_pixel<S, D, convert>(src[x], tables);
+		}
+	}
+	else
+	{
+		for (int x= 0; x < width; ++x)
+		{
+			D pixel= blit_pixel<S, D, convert>(src[x], tables);
+			dst[2 * x]= pixel;
+			dst[2 * x + 1]= pixel;
+		}
+	}
+}
+
+#ifdef HAVE_SSE2_BLIT
+/* the plain low-resolution case: nothing to convert, just double */
+static void blit_row_double32_sse2(
+	const void *src_row,
+	void *dst_row,
+	int width,
+	int scale,
+	const blit_tables& tables)
+{
+	if (scale == 1)
+	{
+		blit_row<uint32, uint32, false>(src_row, dst_row, width, scale, tables);
+		return;
+	}
+
+	const uint32 *src= static_cast<const uint32 *>(src_row);
+	uint32 *dst= static_cast<uint32 *>(dst_row);
+
+	int x= 0;
+	for (; x + 4 <= width; x+= 4)
+	{
+		__m128i pixels= _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * x), _mm_unpacklo_epi32(pixels, pixels));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2 * x + 4), _mm_unpackhi_epi32(pixels, pixels));
+	}
+	blit_row<uint32, uint32, false>(src + x, dst + 2 * x, width - x, scale, tables);
+}
+#endif
+
+#ifdef HAVE_AVX2_BLIT
+/* 32 bits to 32 bits through the tables, eight pixels at a time; the three lookups are
+	gathers */
+AVX2_TARGET static void blit_row_convert32_avx2(
+	const void *src_row,
+	void *dst_row,
+	int width,
+	int scale,
+	const blit_tables& tables)
+{
+	const uint32 *src= static_cast<const uint32 *>(src_row);
+	uint32 *dst= static_cast<uint32 *>(dst_row);
+
+	const __m128i red_shift= _mm_cvtsi32_si128(tables.red_shift);
+	const __m128i green_shift= _mm_cvtsi32_si128(tables.green_shift);
+	const __m128i blue_shift= _mm_cvtsi32_si128(tables.blue_shift);
+	const __m256i red_mask= _mm256_set1_epi32(tables.red_index_mask);
+	const __m256i green_mask= _mm256_set1_epi32(tables.green_index_mask);
+	const __m256i blue_mask= _mm256_set1_epi32(tables.blue_index_mask);
+	const __m256i low_half= _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+	const __m256i high_half= _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+
+	int x= 0;
+	for (; x + 8 <= width; x+= 8)
+	{
+		__m256i pixels= _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + x));
+
+		__m256i red= _mm256_i32gather_epi32(reinterpret_cast<const int *>(tables.red),
+			_mm256_and_si256(_mm256_srl_epi32(pixels, red_shift), red_mask), 4);
+		__m256i green= _mm256_i32gather_epi32(reinterpret_cast<const int *>(tables.green),
+			_mm256_and_si256(_mm256_srl_epi32(pixels, green_shift), green_mask), 4);
+		__m256i blue= _mm256_i32gather_epi32(reinterpret_cast<const int *>(tables.blue),
+			_mm256_and_si256(_mm256_srl_epi32(pixels, blue_shift), blue_mask), 4);
+		__m256i result= _mm256_or_si256(_mm256_or_si256(red, green), blue);
+
+		if (scale == 1)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + x), result);
+		}
+		else
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * x), _mm256_permutevar8x32_epi32(result, low_half));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 2 * x + 8), _mm256_permutevar8x32_epi32(result, high_half));
+		}
+	}
+	blit_row<uint32, uint32, true>(src + x, dst + scale * x, width - x, scale, tables);
+}
+#endif
+
+static blit_row_function choose_row_function(
+	int src_bytes,
+	int dst_bytes,
+	bool convert)
+{
+	if (src_bytes == 4 && dst_bytes == 4)
+	{
+		if (convert)
+		{
+#ifdef HAVE_AVX2_BLIT
+			static const bool have_avx2= SDL_HasAVX2();
+			if (have_avx2) return blit_row_convert32_avx2;
+#endif
+			return blit_row<uint32, uint32, true>;
+		}
+#ifdef HAVE_SSE2_BLIT
+		return blit_row_double32_sse2;
+#else
+		return blit_row<uint32, uint32, false>;
+#endif
+	}
+	else if (src_bytes == 2 && dst_bytes == 4)
+	{
+		return blit_row<uint16, uint32, true>;
+	}
+	else if (src_bytes == 4 && dst_bytes == 2)
+	{
+		return blit_row<uint32, uint16, true>;
+	}
+	else if (src_bytes == 2 && dst_bytes == 2)
+	{
+		return convert ? blit_row<uint16, uint16, true> : blit_row<uint16, uint16, false>;
+	}
+
+	return NULL;
+}
+
+/* ---------- the blit */
+
+void screen_blit(
+	SDL_Surface *src,
+	SDL_Surface *dst,
+	int x,
+	int y,
+	int scale,
+	bool every_other_line,
+	bool clear_skipped_lines,
+	const uint16 *gamma_red,
+	const uint16 *gamma_green,
+	const uint16 *gamma_blue)
+{
+	assert(scale == 1 || scale == 2);
+	assert(x >= 0 && y >= 0);
+
+	static blit_tables tables;
+	build_blit_tables(tables, src->format, dst->format, gamma_red, gamma_green, gamma_blue);
+
+	blit_row_function blit_row= choose_row_function(src->format->BytesPerPixel, dst->format->BytesPerPixel, tables.convert);
+	if (!blit_row) return;
+
+	int width= std::min(src->w, (dst->w - x) / scale);
+	int height= std::min(src->h, (dst->h - y) / scale);
+	if (width <= 0 || height <= 0) return;
+
+	int dst_bytes= dst->format->BytesPerPixel;
+	int row_bytes= width * scale * dst_bytes;
+	bool clear= every_other_line && clear_skipped_lines;
+
+	const uint8 *src_row= static_cast<const uint8 *>(src->pixels);
+	uint8 *dst_row= static_cast<uint8 *>(dst->pixels) + y * dst->pitch + x * dst_bytes;
+
+	for (int row= 0; row < height; ++row)
+	{
+		blit_row(src_row, dst_row, width, scale, tables);
+
+		if (scale == 2)
+		{
+			uint8 *second_row= dst_row + dst->pitch;
+			if (!every_other_line)
+			{
+				memcpy(second_row, dst_row, row_bytes);
+			}
+			else if (clear)
+			{
+				if (dst_bytes == 4)
+				{
+					std::fill_n(reinterpret_cast<uint32 *>(second_row), width * scale, tables.black);
+				}
+				else
+				{
+					std::fill_n(reinterpret_cast<uint16 *>(second_row), width * scale, static_cast<uint16>(tables.black));
+				}
+			}
+		}
+
+		src_row+= src->pitch;
+		dst_row+= scale * dst->pitch;
+	}
+}
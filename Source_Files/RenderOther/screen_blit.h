@@ -0,0 +1,43 @@
+#ifndef SCREEN_BLIT_H
+#define SCREEN_BLIT_H
+
+/*
+SCREEN_BLIT.H
+
+	Copyright (C) 2026 and beyond by the "Aleph One" developers.
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 3 of the License, or
+	(at your option) any later version.
+
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY; without even the implied warranty of
+	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+	GNU General Public License for more details.
+
+	This license is contained in the file "COPYING",
+	which is included with this source code; it is available online at
+	http://www.gnu.org/licenses/gpl.html
+
+	Gets a software-rendered frame onto the screen in one pass over its pixels: gamma
+	correction, conversion to the screen's pixel format and low-resolution pixel doubling
+	all happen in the same loop, instead of each walking the whole frame in turn.
+*/
+
+#include "cseries.h"
+
+/* copies src to dst with its top left corner at (x, y), clipped to dst.  if gamma_red,
+	gamma_green and gamma_blue are given (256 entries each, 8.8 fixed point as for
+	SDL_SetWindowGammaRamp()), each channel is corrected through them first, as if into a
+	surface with src's format.  pixels are converted to dst's format the same way
+	SDL_BlitSurface() would.  with scale 2, every pixel is doubled in both directions; if
+	every_other_line is also set, the second row of each pair is left alone, or filled with
+	black if clear_skipped_lines.
+
+	both surfaces must be 16 or 32 bits per pixel, and dst must be locked if it needs to be */
+void screen_blit(SDL_Surface *src, SDL_Surface *dst, int x, int y, int scale,
+	bool every_other_line, bool clear_skipped_lines,
+	const uint16 *gamma_red, const uint16 *gamma_green, const uint16 *gamma_blue);
+
+#endif
@@ -50,6 +50,7 @@
 #include "interface_menus.h"
 #include "weapons.h"
 #include "lua_script.h"
+#include "lua_profiler.h"
 
 #include "Crosshairs.h"
 #include "OGL_Render.h"
@@ -127,6 +128,7 @@ DirectorySpecifier saved_games_dir;   // Directory for saved games
 DirectorySpecifier quick_saves_dir;   // Directory for auto-named saved games
 DirectorySpecifier image_cache_dir;   // Directory for image cache
 DirectorySpecifier recordings_dir;    // Directory for recordings (except film buffer, which is stored in local_data_dir)
+DirectorySpecifier cache_dir;         // Directory for data worked out from maps and other files, kept to save redoing it
 DirectorySpecifier screenshots_dir;   // Directory for screenshots
 DirectorySpecifier log_dir;           // Directory for Aleph One Log.txt
 
@@ -232,6 +234,17 @@ void initialize_application(void)
 	SDL_setenv("SDL_AUDIODRIVER", "directsound", 0);
 #endif
 
+	if (shell_options.headless)
+	{
+		// SDL's dummy video driver still gives us a software surface to draw into
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 1);
+		shell_options.nogl = true;
+		shell_options.nosound = true;
+		shell_options.nojoystick = true;
+		shell_options.nogamma = true;
+		shell_options.no_chooser = true;
+	}
+
 	// Initialize SDL
 	int retval = SDL_Init(SDL_INIT_VIDEO |
 						  (shell_options.nosound ? 0 : SDL_INIT_AUDIO) |
@@ -391,6 +404,7 @@ void initialize_application(void)
 	
 	image_cache_dir = get_data_path(kPathImageCache);
 	recordings_dir = get_data_path(kPathRecordings);
+	cache_dir = get_data_path(kPathCache);
 	screenshots_dir = get_data_path(kPathScreenshots);
 	
 	if (!get_data_path(kPathBundleData).empty())
@@ -529,6 +543,7 @@ void initialize_application(void)
 	}
 	image_cache_dir.MakeDirectory();
 	recordings_dir.MakeDirectory();
+	cache_dir.MakeDirectory();
 	screenshots_dir.MakeDirectory();
 	
 	WadImageCache::instance()->initialize_cache();
@@ -571,6 +586,7 @@ void initialize_application(void)
 	initialize_gamma();
 	alephone::Screen::instance()->Initialize(&graphics_preferences->screen_mode);
 	initialize_marathon();
+	L_Register_Profiler_Commands();
 	initialize_screen_drawing();
 	initialize_dialogs();
 	initialize_terminal_manager();
@@ -96,12 +96,14 @@ static const std::vector<ShellOptionsFlag> shell_options_flags {
 	{"i", "insecure_lua", "", shell_options.insecure_lua},
 	{"Q", "skip-intro", "Skip intro screens", shell_options.skip_intro},
 	{"e", "editor", "Use editor prefs; jump directly to map", shell_options.editor},
-	{"", "no-chooser", "Disable the scenario chooser", shell_options.no_chooser}
+	{"", "no-chooser", "Disable the scenario chooser", shell_options.no_chooser},
+	{"", "headless", "Run without a window or audio device", shell_options.headless}
 };
 
 static const std::vector<ShellOptionsString> shell_options_strings {
 	{"o", "output", "With -e, output to [file] and exit on quit", shell_options.output},
 	{"l", "replay-directory", "Directory with replays to load", shell_options.replay_directory},
+	{"", "benchmark", "With -l, write replay timings as JSON to [file]", shell_options.benchmark},
 	{"NSDocumentRevisionsDebugMode", "", "", ignore} // annoying Xcode argument
 };
 
@@ -24,8 +24,10 @@ struct ShellOptions {
 	bool editor;
 
 	bool no_chooser;
+	bool headless;
 
 	std::string replay_directory;
+	std::string benchmark;
 
 	std::string directory;
 	std::vector<std::string> files;
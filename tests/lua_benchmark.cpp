@@ -0,0 +1,343 @@
+#include "lua_templates.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Times Lua property reads and writes on script objects through the class templates'
+// dispatch, next to a copy of the old dispatch that looked the methods up in the registry
+// and called them through lua_pcall() every time, and checks that both see the same
+// values and report errors the same way.  Reports as JSON; exits nonzero on any mismatch.
+//
+// alephone_lua_benchmark [<objects> [<rounds>]]
+
+// neither lua_script.cpp nor the alert dialogs are linked in
+void* L_Persistent_Table_Key()
+{
+	static const char *key = "persist";
+	return const_cast<char*>(key);
+}
+
+void _alephone_assert(const char *file, int32 line, const char *what)
+{
+	std::cerr << file << ":" << line << ": " << what << "\n";
+	std::abort();
+}
+
+struct Thing {
+	double x;
+	double y;
+};
+
+static std::vector<Thing> things;
+
+template<class T>
+static int Thing_Get_X(lua_State *L)
+{
+	lua_pushnumber(L, things[T::Index(L, 1)].x);
+	return 1;
+}
+
+template<class T>
+static int Thing_Get_Y(lua_State *L)
+{
+	lua_pushnumber(L, things[T::Index(L, 1)].y);
+	return 1;
+}
+
+template<class T>
+static int Thing_Set_X(lua_State *L)
+{
+	if (!lua_isnumber(L, 2))
+		return luaL_error(L, "x: incorrect argument type");
+
+	things[T::Index(L, 1)].x = lua_tonumber(L, 2);
+	return 0;
+}
+
+template<class T>
+static int Thing_Fail(lua_State *L)
+{
+	return luaL_error(L, "%s: always fails", T::Index(L, 1) ? "odd" : "even");
+}
+
+char Lua_Thing_Name[] = "thing";
+typedef L_Class<Lua_Thing_Name> Lua_Thing;
+
+char Lua_Legacy_Thing_Name[] = "legacy_thing";
+class Lua_Legacy_Thing : public L_Class<Lua_Legacy_Thing_Name>
+{
+public:
+	static void Register(lua_State *L, const luaL_Reg get[], const luaL_Reg set[]);
+private:
+	static int _get_legacy(lua_State *L);
+	static int _set_legacy(lua_State *L);
+};
+
+void Lua_Legacy_Thing::Register(lua_State *L, const luaL_Reg get[], const luaL_Reg set[])
+{
+	L_Class<Lua_Legacy_Thing_Name>::Register(L, get, set);
+
+	luaL_getmetatable(L, Lua_Legacy_Thing_Name);
+	lua_pushcfunction(L, _get_legacy);
+	lua_setfield(L, -2, "__index");
+	lua_pushcfunction(L, _set_legacy);
+	lua_setfield(L, -2, "__newindex");
+	lua_pop(L, 1);
+}
+
+// the registry and pcall dispatch, without custom fields
+int Lua_Legacy_Thing::_get_legacy(lua_State *L)
+{
+	if (lua_isstring(L, 2))
+	{
+		luaL_checktype(L, 1, LUA_TUSERDATA);
+		luaL_checkudata(L, 1, Lua_Legacy_Thing_Name);
+		if (!Valid(Index(L, 1)) && strcmp(lua_tostring(L, 2), "valid") != 0 && strcmp(lua_tostring(L, 2), "index") != 0)
+			luaL_error(L, "invalid object");
+
+		_push_get_methods_key(L);
+		lua_gettable(L, LUA_REGISTRYINDEX);
+
+		lua_pushvalue(L, 2);
+		lua_gettable(L, -2);
+		lua_remove(L, -2);
+
+		if (lua_isfunction(L, -1))
+		{
+			lua_pushvalue(L, 1);
+			if (lua_pcall(L, 1, 1, 0) == LUA_ERRRUN)
+			{
+				luaL_where(L, 1);
+				lua_pushvalue(L, -2);
+				lua_concat(L, 2);
+				lua_error(L);
+			}
+		}
+		else
+		{
+			lua_pop(L, 1);
+			lua_pushnil(L);
+		}
+	}
+	else
+	{
+		lua_pushnil(L);
+	}
+
+	return 1;
+}
+
+int Lua_Legacy_Thing::_set_legacy(lua_State *L)
+{
+	luaL_checktype(L, 1, LUA_TUSERDATA);
+	luaL_checkudata(L, 1, Lua_Legacy_Thing_Name);
+
+	_push_set_methods_key(L);
+	lua_gettable(L, LUA_REGISTRYINDEX);
+
+	lua_pushvalue(L, 2);
+	lua_gettable(L, -2);
+
+	if (lua_isnil(L, -1))
+	{
+		luaL_error(L, "no such index");
+	}
+
+	lua_pushvalue(L, 1);
+	lua_pushvalue(L, 3);
+	if (lua_pcall(L, 2, 0, 0) == LUA_ERRRUN)
+	{
+		luaL_where(L, 1);
+		lua_pushvalue(L, -2);
+		lua_concat(L, 2);
+		lua_error(L);
+	}
+
+	lua_pop(L, 1);
+	return 0;
+}
+
+template<class T>
+static void RegisterThing(lua_State *L)
+{
+	const luaL_Reg get[] = {
+		{"fail", Thing_Fail<T>},
+		{"x", Thing_Get_X<T>},
+		{"y", Thing_Get_Y<T>},
+		{0, 0}
+	};
+
+	const luaL_Reg set[] = {
+		{"fail", Thing_Fail<T>},
+		{"x", Thing_Set_X<T>},
+		{0, 0}
+	};
+
+	T::Register(L, get, set);
+}
+
+template<class T>
+static int Thing_Push(lua_State *L)
+{
+	T::Push(L, static_cast<int16>(luaL_checkinteger(L, 1)));
+	return 1;
+}
+
+static const char *benchmark_script =
+	"local objects, rounds = ...\n"
+	"local list = {}\n"
+	"for i = 0, objects - 1 do list[#list + 1] = get_thing(i) end\n"
+	"local clock = os.clock\n"
+	"local start = clock()\n"
+	"local sum = 0\n"
+	"for r = 1, rounds do\n"
+	"  for _, t in ipairs(list) do sum = sum + t.x + t.y end\n"
+	"end\n"
+	"local read = clock() - start\n"
+	"start = clock()\n"
+	"for r = 1, rounds do\n"
+	"  for _, t in ipairs(list) do t.x = t.x + 1 end\n"
+	"end\n"
+	"return read, clock() - start, sum\n";
+
+// run where the error lands on the script's own lines
+static const char *error_scripts[] = {
+	"local t = get_thing(1)\nreturn t.fail",
+	"local t = get_thing(0)\nt.fail = 1",
+	"local t = get_thing(0)\nt.x = 'x'",
+	"local t = get_thing(0)\nt.nothing = 1",
+	"return get_thing(0).nothing",
+	"local t = get_thing(0)\nreturn getmetatable(t).__index({}, 'x')",
+};
+
+struct DispatchResult {
+	const char *name;
+	double read_seconds;
+	double write_seconds;
+	double sum;
+	std::vector<Thing> things;
+	std::vector<std::string> errors;
+};
+
+template<class T>
+static bool run_dispatch(const char *name, int objects, int rounds, DispatchResult& result)
+{
+	things.assign(objects, Thing());
+	for (int i = 0; i < objects; ++i)
+	{
+		things[i].x = i;
+		things[i].y = objects - i * 0.5;
+	}
+
+	lua_State *L = luaL_newstate();
+	luaL_openlibs(L);
+	RegisterThing<T>(L);
+	lua_register(L, "get_thing", Thing_Push<T>);
+
+	result.name = name;
+
+	bool ok = true;
+	if (luaL_loadbuffer(L, benchmark_script, strlen(benchmark_script), "benchmark") != LUA_OK)
+	{
+		std::cerr << lua_tostring(L, -1) << "\n";
+		ok = false;
+	}
+	else
+	{
+		lua_pushinteger(L, objects);
+		lua_pushinteger(L, rounds);
+		if (lua_pcall(L, 2, 3, 0) != LUA_OK)
+		{
+			std::cerr << lua_tostring(L, -1) << "\n";
+			ok = false;
+		}
+		else
+		{
+			result.read_seconds = lua_tonumber(L, -3);
+			result.write_seconds = lua_tonumber(L, -2);
+			result.sum = lua_tonumber(L, -1);
+		}
+		lua_settop(L, 0);
+	}
+	result.things = things;
+
+	for (auto script : error_scripts)
+	{
+		if (luaL_loadbuffer(L, script, strlen(script), "errors") != LUA_OK || lua_pcall(L, 0, 1, 0) != LUA_OK)
+			result.errors.push_back(lua_isstring(L, -1) ? lua_tostring(L, -1) : "");
+		else
+			result.errors.push_back(std::string("no error: ") + (lua_isstring(L, -1) ? lua_tostring(L, -1) : luaL_typename(L, -1)));
+		lua_settop(L, 0);
+	}
+
+	lua_close(L);
+	return ok;
+}
+
+static bool same_things(const std::vector<Thing>& a, const std::vector<Thing>& b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		if (a[i].x != b[i].x || a[i].y != b[i].y)
+			return false;
+	}
+
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+
+	int objects = 1000;
+	int rounds = 1000;
+	if (argc > 1) {
+		objects = std::atoi(argv[1]);
+	}
+	if (argc > 2) {
+		rounds = std::atoi(argv[2]);
+	}
+	if (argc > 3 || objects <= 0 || objects > 32767 || rounds <= 0) {
+		std::cerr << "usage: " << argv[0] << " [<objects> [<rounds>]]\n";
+		return 1;
+	}
+
+	DispatchResult legacy{}, cached{};
+	bool ok = run_dispatch<Lua_Legacy_Thing>("registry_pcall", objects, rounds, legacy);
+	ok = run_dispatch<Lua_Thing>("cached", objects, rounds, cached) && ok;
+
+	bool matches = cached.sum == legacy.sum && same_things(cached.things, legacy.things) && cached.errors == legacy.errors;
+	if (!matches) {
+		for (size_t i = 0; i < cached.errors.size() && i < legacy.errors.size(); ++i) {
+			if (cached.errors[i] != legacy.errors[i]) {
+				std::cerr << "error " << i << ": \"" << cached.errors[i] << "\" instead of \"" << legacy.errors[i] << "\"\n";
+			}
+		}
+	}
+
+	double accesses = 2.0 * objects * rounds;
+	std::cout << std::setprecision(6) << "{\n  \"objects\": " << objects << ",\n"
+			  << "  \"rounds\": " << rounds << ",\n"
+			  << "  \"matches_legacy\": " << (matches ? "true" : "false") << ",\n  \"dispatch\": [";
+	const DispatchResult *results[] = { &legacy, &cached };
+	for (size_t i = 0; i < 2; ++i) {
+		const auto& result = *results[i];
+		std::cout << (i ? ",\n" : "\n") << "    {\n"
+				  << "      \"name\": \"" << result.name << "\",\n"
+				  << "      \"read_seconds\": " << result.read_seconds << ",\n"
+				  << "      \"write_seconds\": " << result.write_seconds << ",\n"
+				  << "      \"read_ns_per_access\": " << result.read_seconds * 1e9 / accesses << ",\n"
+				  << "      \"write_ns_per_access\": " << result.write_seconds * 1e9 / accesses << ",\n"
+				  << "      \"read_speedup\": " << (result.read_seconds > 0 ? legacy.read_seconds / result.read_seconds : 0) << ",\n"
+				  << "      \"write_speedup\": " << (result.write_seconds > 0 ? legacy.write_seconds / result.write_seconds : 0) << "\n"
+				  << "    }";
+	}
+	std::cout << "\n  ]\n}\n";
+
+	return ok && matches ? 0 : 1;
+}
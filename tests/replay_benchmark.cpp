@@ -0,0 +1,171 @@
+#include "shell.h"
+#include "world.h"
+#include "FileHandler.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "preferences.h"
+#include "tick_timings.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+extern ShellOptions shell_options;
+
+// Replays every film in the replay directory without a window or audio
+// device, and reports how fast the simulation ran as JSON.
+//
+// alephone_benchmark -l <replay directory> [--benchmark <file>] <scenario directory>
+
+struct BenchmarkResult {
+	std::string path;
+	bool opened;
+	uint16_t seed;
+	double seconds;
+	tick_timings_data timings;
+};
+
+static std::vector<std::string> get_replays(std::string& directory_path) {
+
+	FileSpecifier directory = directory_path;
+
+	std::vector<dir_entry> entries;
+	directory.ReadDirectory(entries);
+
+	std::vector<std::string> results;
+	for (std::vector<dir_entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+
+		FileSpecifier entry = directory + it->name;
+		std::string entry_path = entry.GetPath();
+
+		if (entry.IsDir()) {
+			auto sub_replays = get_replays(entry_path);
+			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
+		}
+		else if (entry.GetType() == _typecode_film) {
+			results.push_back(entry_path);
+		}
+	}
+
+	return results;
+}
+
+static std::string json_string(const std::string& s) {
+	std::ostringstream oss;
+	oss << '"';
+	for (auto c : s) {
+		switch (c) {
+			case '"': oss << "\\\""; break;
+			case '\\': oss << "\\\\"; break;
+			case '\n': oss << "\\n"; break;
+			case '\t': oss << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+				} else {
+					oss << c;
+				}
+		}
+	}
+	oss << '"';
+	return oss.str();
+}
+
+static double seconds(uint64_t nanoseconds) {
+	return nanoseconds / 1e9;
+}
+
+static void write_timings(std::ostream& s, const tick_timings_data& timings, double wall_seconds, const char* indent) {
+	s << indent << "\"ticks\": " << timings.ticks << ",\n"
+	  << indent << "\"seconds\": " << wall_seconds << ",\n"
+	  << indent << "\"ticks_per_second\": " << (wall_seconds > 0 ? timings.ticks / wall_seconds : 0) << ",\n"
+	  << indent << "\"simulation_seconds\": " << seconds(timings.total_nanoseconds) << ",\n"
+	  << indent << "\"simulation_ticks_per_second\": " << (timings.total_nanoseconds ? timings.ticks / seconds(timings.total_nanoseconds) : 0) << ",\n"
+	  << indent << "\"subsystem_seconds\": {";
+
+	for (int16_t i = 0; i < NUMBER_OF_TICK_TIMINGS; ++i) {
+		s << (i ? ", " : " ") << json_string(get_tick_timing_name(i)) << ": " << seconds(timings.nanoseconds[i]);
+	}
+
+	s << " }";
+}
+
+static void write_report(std::ostream& s, const std::vector<BenchmarkResult>& results) {
+	tick_timings_data total{};
+	double total_seconds = 0;
+
+	s << std::setprecision(6) << "{\n  \"films\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& result = results[i];
+
+		s << (i ? ",\n" : "\n") << "    {\n"
+		  << "      \"path\": " << json_string(result.path) << ",\n"
+		  << "      \"opened\": " << (result.opened ? "true" : "false") << ",\n"
+		  << "      \"seed\": " << result.seed << ",\n";
+		write_timings(s, result.timings, result.seconds, "      ");
+		s << "\n    }";
+
+		total.ticks += result.timings.ticks;
+		total.total_nanoseconds += result.timings.total_nanoseconds;
+		for (int j = 0; j < NUMBER_OF_TICK_TIMINGS; ++j) {
+			total.nanoseconds[j] += result.timings.nanoseconds[j];
+		}
+		total_seconds += result.seconds;
+	}
+
+	s << "\n  ],\n  \"total\": {\n";
+	write_timings(s, total, total_seconds, "    ");
+	s << "\n  }\n}\n";
+}
+
+int main(int argc, char* argv[]) {
+
+	shell_options.parse(argc, argv);
+	shell_options.headless = true;
+
+	if (shell_options.directory.empty() || shell_options.replay_directory.empty()) {
+		std::cerr << "usage: " << shell_options.program_name << " -l <replay directory> [--benchmark <file>] <scenario directory>\n";
+		return 1;
+	}
+
+	const auto replays = get_replays(shell_options.replay_directory);
+
+	initialize_application();
+	graphics_preferences->fps_target = 60;
+	set_tick_timings_enabled(true);
+
+	std::vector<BenchmarkResult> results;
+	for (const auto& replay : replays) {
+		BenchmarkResult result{ replay };
+		reset_tick_timings();
+
+		auto start = std::chrono::steady_clock::now();
+		result.opened = handle_open_document(replay);
+		if (result.opened) {
+			set_replay_speed(INT16_MAX);
+			main_event_loop();
+		}
+		result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		result.seed = get_random_seed();
+		result.timings = get_tick_timings();
+		results.push_back(result);
+	}
+
+	shutdown_application();
+
+	if (shell_options.benchmark.empty()) {
+		write_report(std::cout, results);
+	} else {
+		std::ofstream file(shell_options.benchmark);
+		write_report(file, results);
+		if (!file) {
+			std::cerr << "couldn't write " << shell_options.benchmark << "\n";
+			return 1;
+		}
+	}
+
+	return 0;
+}
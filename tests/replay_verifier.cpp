@@ -0,0 +1,423 @@
+#include "shell.h"
+#include "world.h"
+#include "FileHandler.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "preferences.h"
+#include "tick_timings.h"
+#include "world_snapshot.h"
+#include "vbl.h"
+#include "game_wad.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#ifndef __WIN32__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+extern ShellOptions shell_options;
+
+// Replays every film in the replay directory across several worker processes,
+// checks each film's final random seed (from its name.<seed>.ext file name, as
+// for the replay test) and, if the film has a <film>.hashes file next to it or
+// world hashes recorded into it, the world hash every N ticks. Films are run
+// with fast_forward_replay(), so nothing is rendered or played. Writes a JSON
+// report and exits non-zero if any film fails.
+//
+// alephone_verifier -l <replay directory> [--jobs <n>] [--record-hashes <n>]
+//                   [--save-at <tick>] [--benchmark <file>] <scenario directory>
+//
+// --record-hashes writes (or overwrites) the .hashes files, every n ticks,
+// instead of checking them.
+//
+// --save-at saves the game as <film>.<tick>.sgaA when each film reaches that
+// tick (counted from the start of the film, across levels), then carries on.
+
+struct VerifyResult {
+	std::string path;
+	bool opened = false;
+	int32_t expected_seed = -1; // -1 if the file name doesn't have one
+	uint16_t seed = 0;
+	uint64_t ticks = 0;
+	double seconds = 0;
+	int32_t hashes_checked = 0;
+	int32_t hash_mismatch_tick = -1;
+	bool hashes_recorded = false;
+	bool snapshot_saved = false;
+	bool snapshot_failed = false; // reached the tick but couldn't write the save
+
+	bool passed() const {
+		return opened && (expected_seed == -1 || expected_seed == seed) && hash_mismatch_tick == -1 && !snapshot_failed;
+	}
+};
+
+static std::vector<std::string> get_replays(std::string& directory_path) {
+
+	FileSpecifier directory = directory_path;
+
+	std::vector<dir_entry> entries;
+	directory.ReadDirectory(entries);
+
+	std::vector<std::string> results;
+	for (std::vector<dir_entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+
+		FileSpecifier entry = directory + it->name;
+		std::string entry_path = entry.GetPath();
+
+		if (entry.IsDir()) {
+			auto sub_replays = get_replays(entry_path);
+			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
+		}
+		else if (entry.GetType() == _typecode_film) {
+			results.push_back(entry_path);
+		}
+	}
+
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+static int32_t get_seed_from_filename(const std::string& path) {
+	auto name = path.substr(path.find_last_of("/\\") + 1);
+	auto name_without_ext = name.substr(0, name.find_last_of('.'));
+	auto seed_position = name_without_ext.find_last_of('.');
+	if (seed_position == std::string::npos) return -1;
+
+	try {
+		return std::stoi(name_without_ext.substr(seed_position + 1));
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+// first line "interval <n>", then "<tick> <hash>" per line
+static bool read_hashes(const std::string& path, int32_t& interval, std::vector<std::pair<int32, uint64_t>>& hashes) {
+	std::ifstream file(path);
+	std::string keyword;
+	if (!(file >> keyword >> interval) || keyword != "interval" || interval <= 0) return false;
+
+	int32 tick;
+	uint64_t hash;
+	while (file >> std::dec >> tick >> std::hex >> hash) {
+		hashes.push_back({ tick, hash });
+	}
+
+	return true;
+}
+
+static bool write_hashes(const std::string& path, int32_t interval, const std::vector<std::pair<int32, uint64_t>>& hashes) {
+	std::ofstream file(path);
+	file << "interval " << interval << "\n";
+	for (const auto& hash : hashes) {
+		file << std::dec << hash.first << " " << std::hex << std::setw(16) << std::setfill('0') << hash.second << "\n";
+	}
+
+	return static_cast<bool>(file);
+}
+
+static bool save_snapshot(const std::string& path, int32_t tick) {
+	auto name = path.substr(0, path.find_last_of('.')) + "." + std::to_string(tick) + ".sgaA";
+	FileSpecifier file = name;
+	return save_game_file(file, "", "");
+}
+
+static VerifyResult verify_replay(const std::string& path, int32_t record_interval, int32_t save_tick) {
+	VerifyResult result;
+	result.path = path;
+	result.expected_seed = get_seed_from_filename(path);
+
+	const auto hashes_path = path + ".hashes";
+	int32_t interval = record_interval;
+	std::vector<std::pair<int32, uint64_t>> expected_hashes;
+	if (!record_interval && !read_hashes(hashes_path, interval, expected_hashes)) {
+		interval = 0;
+	}
+
+	reset_tick_timings();
+	reset_world_hashes();
+	set_world_hash_interval(interval);
+
+	auto start = std::chrono::steady_clock::now();
+	result.opened = handle_open_document(path);
+	if (result.opened) {
+		set_replay_speed(INT16_MAX);
+		if (save_tick >= 0 && fast_forward_replay(save_tick)) {
+			result.snapshot_saved = save_snapshot(path, save_tick);
+			result.snapshot_failed = !result.snapshot_saved;
+		}
+
+		// leaves the end of the film for the main loop to clean up
+		fast_forward_replay(NONE);
+		main_event_loop();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	result.seed = get_random_seed();
+	result.ticks = get_tick_timings().ticks;
+
+	const auto& hashes = get_world_hashes();
+	if (record_interval) {
+		result.hashes_recorded = result.opened && write_hashes(hashes_path, record_interval, hashes);
+	} else {
+		if (!interval) {
+			// the replay hashed itself at the film's own interval, if it has one
+			expected_hashes = get_replay_world_hashes();
+		}
+
+		// in recording order; tick counts can repeat across levels
+		for (size_t i = 0; i < expected_hashes.size(); ++i) {
+			if (i >= hashes.size() || hashes[i] != expected_hashes[i]) {
+				result.hash_mismatch_tick = expected_hashes[i].first;
+				break;
+			}
+			++result.hashes_checked;
+		}
+	}
+
+	set_world_hash_interval(0);
+	return result;
+}
+
+// one result per line, tab separated, for passing results back from a worker
+static std::string serialize(const VerifyResult& result) {
+	std::ostringstream oss;
+	oss << std::setprecision(17) << result.opened << '\t' << result.expected_seed << '\t' << result.seed << '\t' << result.ticks << '\t'
+		<< result.seconds << '\t' << result.hashes_checked << '\t' << result.hash_mismatch_tick << '\t' << result.hashes_recorded << '\t'
+		<< result.snapshot_saved << '\t' << result.snapshot_failed << '\t' << result.path << '\n';
+	return oss.str();
+}
+
+static bool deserialize(const std::string& line, VerifyResult& result) {
+	std::istringstream iss(line);
+	if (!(iss >> result.opened >> result.expected_seed >> result.seed >> result.ticks >> result.seconds
+		  >> result.hashes_checked >> result.hash_mismatch_tick >> result.hashes_recorded
+		  >> result.snapshot_saved >> result.snapshot_failed)) {
+		return false;
+	}
+	iss.get();
+	std::getline(iss, result.path);
+	return !result.path.empty();
+}
+
+static std::string json_string(const std::string& s) {
+	std::ostringstream oss;
+	oss << '"';
+	for (auto c : s) {
+		switch (c) {
+			case '"': oss << "\\\""; break;
+			case '\\': oss << "\\\\"; break;
+			case '\n': oss << "\\n"; break;
+			case '\t': oss << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) < 0x20) {
+					oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+				} else {
+					oss << c;
+				}
+		}
+	}
+	oss << '"';
+	return oss.str();
+}
+
+static void write_report(std::ostream& s, const std::vector<VerifyResult>& results, int jobs, double wall_seconds) {
+	uint64_t total_ticks = 0;
+	double total_seconds = 0;
+	int failed = 0;
+
+	s << std::setprecision(6) << "{\n  \"films\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& result = results[i];
+
+		s << (i ? ",\n" : "\n") << "    {\n"
+		  << "      \"path\": " << json_string(result.path) << ",\n"
+		  << "      \"passed\": " << (result.passed() ? "true" : "false") << ",\n"
+		  << "      \"opened\": " << (result.opened ? "true" : "false") << ",\n"
+		  << "      \"seed\": " << result.seed << ",\n"
+		  << "      \"expected_seed\": ";
+		if (result.expected_seed == -1) s << "null"; else s << result.expected_seed;
+		s << ",\n"
+		  << "      \"hashes_checked\": " << result.hashes_checked << ",\n"
+		  << "      \"hash_mismatch_tick\": ";
+		if (result.hash_mismatch_tick == -1) s << "null"; else s << result.hash_mismatch_tick;
+		s << ",\n"
+		  << "      \"hashes_recorded\": " << (result.hashes_recorded ? "true" : "false") << ",\n"
+		  << "      \"snapshot_saved\": " << (result.snapshot_saved ? "true" : "false") << ",\n"
+		  << "      \"ticks\": " << result.ticks << ",\n"
+		  << "      \"seconds\": " << result.seconds << ",\n"
+		  << "      \"ticks_per_second\": " << (result.seconds > 0 ? result.ticks / result.seconds : 0) << "\n"
+		  << "    }";
+
+		total_ticks += result.ticks;
+		total_seconds += result.seconds;
+		if (!result.passed()) ++failed;
+	}
+
+	s << "\n  ],\n  \"total\": {\n"
+	  << "    \"films\": " << results.size() << ",\n"
+	  << "    \"failed\": " << failed << ",\n"
+	  << "    \"jobs\": " << jobs << ",\n"
+	  << "    \"ticks\": " << total_ticks << ",\n"
+	  << "    \"seconds\": " << wall_seconds << ",\n"
+	  << "    \"ticks_per_second\": " << (wall_seconds > 0 ? total_ticks / wall_seconds : 0) << ",\n"
+	  << "    \"worker_ticks_per_second\": " << (total_seconds > 0 ? total_ticks / total_seconds : 0) << "\n"
+	  << "  }\n}\n";
+}
+
+// replays films job, job + jobs, job + 2 * jobs, ...
+static std::vector<VerifyResult> run_worker(const std::vector<std::string>& replays, int job, int jobs, int32_t record_interval, int32_t save_tick) {
+	std::vector<VerifyResult> results;
+
+	initialize_application();
+	graphics_preferences->fps_target = 60;
+	set_tick_timings_enabled(true);
+
+	for (size_t i = job; i < replays.size(); i += jobs) {
+		results.push_back(verify_replay(replays[i], record_interval, save_tick));
+	}
+
+	shutdown_application();
+	return results;
+}
+
+static std::vector<VerifyResult> run_workers(const std::vector<std::string>& replays, int jobs, int32_t record_interval, int32_t save_tick) {
+	std::vector<VerifyResult> results;
+
+#ifndef __WIN32__
+	if (jobs > 1) {
+		std::vector<pid_t> pids;
+		std::vector<int> pipes;
+
+		// fork before anything is initialized, so every worker starts clean
+		for (int job = 0; job < jobs; ++job) {
+			int fds[2];
+			if (pipe(fds) != 0) break;
+
+			pid_t pid = fork();
+			if (pid == 0) {
+				close(fds[0]);
+				std::string output;
+				for (const auto& result : run_worker(replays, job, jobs, record_interval, save_tick)) {
+					output += serialize(result);
+				}
+
+				for (size_t written = 0; written < output.size(); ) {
+					auto n = write(fds[1], output.data() + written, output.size() - written);
+					if (n <= 0) break;
+					written += n;
+				}
+				_exit(0);
+			}
+
+			close(fds[1]);
+			if (pid < 0) {
+				close(fds[0]);
+				break;
+			}
+
+			pids.push_back(pid);
+			pipes.push_back(fds[0]);
+		}
+
+		for (auto fd : pipes) {
+			std::string output;
+			char buffer[4096];
+			ssize_t n;
+			while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+				output.append(buffer, n);
+			}
+			close(fd);
+
+			std::istringstream lines(output);
+			std::string line;
+			while (std::getline(lines, line)) {
+				VerifyResult result;
+				if (deserialize(line, result)) {
+					results.push_back(result);
+				}
+			}
+		}
+
+		for (auto pid : pids) {
+			int status;
+			waitpid(pid, &status, 0);
+		}
+
+		// a worker that crashed leaves its films out; report them as not opened
+		for (const auto& replay : replays) {
+			if (std::none_of(results.begin(), results.end(), [&](const VerifyResult& r) { return r.path == replay; })) {
+				VerifyResult result;
+				result.path = replay;
+				result.expected_seed = get_seed_from_filename(replay);
+				results.push_back(result);
+			}
+		}
+
+		std::sort(results.begin(), results.end(), [](const VerifyResult& a, const VerifyResult& b) { return a.path < b.path; });
+		return results;
+	}
+#endif
+
+	return run_worker(replays, 0, 1, record_interval, save_tick);
+}
+
+// removes "<name> <value>" from the arguments; shell_options doesn't know about it
+static bool take_int_option(std::vector<char*>& args, const char* name, int& value) {
+	for (size_t i = 1; i + 1 < args.size(); ++i) {
+		if (std::strcmp(args[i], name) == 0) {
+			value = std::atoi(args[i + 1]);
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+
+	std::vector<char*> args(argv, argv + argc);
+	int jobs = std::max(1u, std::thread::hardware_concurrency());
+	int record_interval = 0;
+	int save_tick = -1;
+	take_int_option(args, "--jobs", jobs);
+	take_int_option(args, "--record-hashes", record_interval);
+	take_int_option(args, "--save-at", save_tick);
+
+	shell_options.parse(static_cast<int>(args.size()), args.data());
+	shell_options.headless = true;
+
+	if (shell_options.directory.empty() || shell_options.replay_directory.empty() || jobs < 1 || record_interval < 0) {
+		std::cerr << "usage: " << shell_options.program_name << " -l <replay directory> [--jobs <n>] [--record-hashes <n>] [--save-at <tick>] [--benchmark <file>] <scenario directory>\n";
+		return 1;
+	}
+
+	const auto replays = get_replays(shell_options.replay_directory);
+	jobs = std::min<int>(jobs, std::max<size_t>(1, replays.size()));
+
+	auto start = std::chrono::steady_clock::now();
+	const auto results = run_workers(replays, jobs, record_interval, save_tick);
+	double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (shell_options.benchmark.empty()) {
+		write_report(std::cout, results, jobs, wall_seconds);
+	} else {
+		std::ofstream file(shell_options.benchmark);
+		write_report(file, results, jobs, wall_seconds);
+		if (!file) {
+			std::cerr << "couldn't write " << shell_options.benchmark << "\n";
+			return 1;
+		}
+	}
+
+	return std::all_of(results.begin(), results.end(), [](const VerifyResult& r) { return r.passed(); }) ? 0 : 1;
+}
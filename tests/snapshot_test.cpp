@@ -0,0 +1,185 @@
+#include "shell.h"
+#include "world.h"
+#include "map.h"
+#include "FileHandler.h"
+#include "shell_options.h"
+#include "interface.h"
+#include "world_snapshot.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+extern ShellOptions shell_options;
+
+// Replays every film in the replay directory and, every N ticks, takes a snapshot,
+// runs the film M ticks further, takes a second snapshot and restores both in turn.
+// The world hash after each restore must match the hash taken with the snapshot.
+// Restoring the second snapshot puts the world back where the film left it, so each
+// film must still end on the random seed in its name.<seed>.ext file name (if it has
+// one).  Snapshots that a level change left out of date are skipped.  Exits non-zero
+// if any hash or seed doesn't match.
+//
+// alephone_snapshot_test -l <replay directory> [--interval <n>] [--ahead <n>] <scenario directory>
+
+struct SnapshotResult {
+	bool opened = false;
+	int32_t expected_seed = -1; // -1 if the file name doesn't have one
+	uint16_t seed = 0;
+	int32_t restores_checked = 0;
+	int32_t restores_skipped = 0;
+	int32_t mismatch_tick = -1;
+
+	bool passed() const {
+		return opened && (expected_seed == -1 || expected_seed == seed) && mismatch_tick == -1;
+	}
+};
+
+static std::vector<std::string> get_replays(std::string& directory_path) {
+
+	FileSpecifier directory = directory_path;
+
+	std::vector<dir_entry> entries;
+	directory.ReadDirectory(entries);
+
+	std::vector<std::string> results;
+	for (std::vector<dir_entry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+
+		FileSpecifier entry = directory + it->name;
+		std::string entry_path = entry.GetPath();
+
+		if (entry.IsDir()) {
+			auto sub_replays = get_replays(entry_path);
+			results.insert(results.end(), sub_replays.begin(), sub_replays.end());
+		}
+		else if (entry.GetType() == _typecode_film) {
+			results.push_back(entry_path);
+		}
+	}
+
+	std::sort(results.begin(), results.end());
+	return results;
+}
+
+static int32_t get_seed_from_filename(const std::string& path) {
+	auto name = path.substr(path.find_last_of("/\\") + 1);
+	auto name_without_ext = name.substr(0, name.find_last_of('.'));
+	auto seed_position = name_without_ext.find_last_of('.');
+	if (seed_position == std::string::npos) return -1;
+
+	try {
+		return std::stoi(name_without_ext.substr(seed_position + 1));
+	}
+	catch (...) {
+		return -1;
+	}
+}
+
+// restores the snapshot and checks the world hashes the same as when it was taken
+static bool check_restore(WorldSnapshot& snapshot, uint64_t hash, SnapshotResult& result) {
+	if (!snapshot.restore()) {
+		++result.restores_skipped;
+		return true;
+	}
+
+	if (calculate_world_hash() != hash) {
+		result.mismatch_tick = dynamic_world->tick_count;
+		return false;
+	}
+
+	++result.restores_checked;
+	return true;
+}
+
+static SnapshotResult test_replay(const std::string& path, int32_t interval, int32_t ahead) {
+	SnapshotResult result;
+	result.expected_seed = get_seed_from_filename(path);
+
+	result.opened = handle_open_document(path);
+	if (result.opened) {
+		set_replay_speed(INT16_MAX);
+
+		WorldSnapshot before;
+		WorldSnapshot after;
+		for (int32_t tick = interval; fast_forward_replay(tick); tick += interval) {
+			before.take();
+			uint64_t before_hash = calculate_world_hash();
+
+			if (!fast_forward_replay(tick + ahead)) break;
+
+			after.take();
+			uint64_t after_hash = calculate_world_hash();
+
+			// back to the first snapshot, then forward to where the film is
+			if (!check_restore(before, before_hash, result) || !check_restore(after, after_hash, result)) break;
+
+			tick += ahead;
+		}
+
+		// leaves the end of the film for the main loop to clean up
+		fast_forward_replay(NONE);
+		main_event_loop();
+	}
+
+	result.seed = get_random_seed();
+	return result;
+}
+
+// removes "<name> <value>" from the arguments; shell_options doesn't know about it
+static bool take_int_option(std::vector<char*>& args, const char* name, int& value) {
+	for (size_t i = 1; i + 1 < args.size(); ++i) {
+		if (std::strcmp(args[i], name) == 0) {
+			value = std::atoi(args[i + 1]);
+			args.erase(args.begin() + i, args.begin() + i + 2);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int main(int argc, char* argv[]) {
+
+	std::vector<char*> args(argv, argv + argc);
+	int interval = 300;
+	int ahead = 30;
+	take_int_option(args, "--interval", interval);
+	take_int_option(args, "--ahead", ahead);
+
+	shell_options.parse(static_cast<int>(args.size()), args.data());
+	shell_options.headless = true;
+
+	if (shell_options.directory.empty() || shell_options.replay_directory.empty() || interval < 1 || ahead < 1) {
+		std::cerr << "usage: " << shell_options.program_name << " -l <replay directory> [--interval <n>] [--ahead <n>] <scenario directory>\n";
+		return 1;
+	}
+
+	initialize_application();
+
+	int failures = 0;
+	for (const auto& path : get_replays(shell_options.replay_directory)) {
+		auto result = test_replay(path, interval, ahead);
+
+		std::cout << path << ": ";
+		if (!result.opened) {
+			std::cout << "couldn't open\n";
+		} else {
+			std::cout << result.restores_checked << " restores checked, " << result.restores_skipped << " skipped";
+			if (result.mismatch_tick != -1) {
+				std::cout << ", hash mismatch restoring to tick " << result.mismatch_tick;
+			}
+			if (result.expected_seed != -1 && result.expected_seed != result.seed) {
+				std::cout << ", ended on seed " << result.seed << " instead of " << result.expected_seed;
+			}
+			std::cout << "\n";
+		}
+
+		if (!result.passed()) {
+			++failures;
+		}
+	}
+
+	shutdown_application();
+
+	return failures ? 1 : 0;
+}
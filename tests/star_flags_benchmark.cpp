@@ -0,0 +1,303 @@
+#include "network_star_flags.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Measures how many bytes the hub's game data packets take with raw ('H1') and compact ('H2')
+// action flags, using the flags players actually sent in recorded films.  For 2 to 8 players
+// (the first players of each film that has that many), every tick the hub sends each spoke
+// everyone else's flags:
+//
+//	bandwidth_reduction	the last 3 ticks, and every <latency> ticks a recovery update of
+//				4 x <latency> ticks, as with use_bandwidth_reduction
+//	full_window		the last <latency> ticks, as without it
+//
+// Every compact packet is decoded again and checked against the film.  Reports bytes per tick
+// (all spokes together, UDP and IP headers left out) as JSON; exits nonzero on any mismatch.
+//
+// alephone_star_flags_benchmark [--latency <ticks>] <film>...
+
+enum {
+	kFilmHeaderSize = 352,		// SIZEOF_recording_header
+	kFilmChunkSize = 256,		// RECORD_CHUNK_SIZE
+	kFilmEndOfRecording = 257,	// END_OF_RECORDING_INDICATOR
+	kMaximumPlayers = 8,
+	kPacketSize = 1500		// ddpMaxData
+};
+
+static uint32 read_big_endian(const std::vector<uint8>& data, size_t offset, size_t length)
+{
+	uint32 value = 0;
+	for (size_t i = 0; i < length; ++i)
+	{
+		value = (value << 8) | data[offset + i];
+	}
+	return value;
+}
+
+// every player's action flags, one per tick; empty if the file isn't a film
+static std::vector<std::vector<action_flags_t>> read_film_flags(const std::string& path)
+{
+	std::vector<std::vector<action_flags_t>> flags;
+
+	std::ifstream file(path, std::ios::binary);
+	std::vector<uint8> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() < kFilmHeaderSize)
+		return flags;
+
+	size_t length = std::min<size_t>(read_big_endian(data, 0, 4), data.size());
+	int num_players = static_cast<int16>(read_big_endian(data, 4, 2));
+	if (num_players < 1 || num_players > kMaximumPlayers)
+		return flags;
+
+	flags.resize(num_players);
+
+	// chunks of kFilmChunkSize ticks for each player in turn, as runs of (int16 count, uint32 flags)
+	size_t offset = kFilmHeaderSize;
+	bool ended = false;
+	while (!ended && offset < length)
+	{
+		for (int player = 0; player < num_players && !ended; ++player)
+		{
+			for (int count = 0; count < kFilmChunkSize; )
+			{
+				if (offset + 6 > length)
+				{
+					ended = true;
+					break;
+				}
+
+				int run = static_cast<int16>(read_big_endian(data, offset, 2));
+				action_flags_t action_flags = read_big_endian(data, offset + 2, 4);
+				offset += 6;
+
+				if (run == kFilmEndOfRecording || run <= 0)
+				{
+					ended = run == kFilmEndOfRecording ? player == num_players - 1 : true;
+					break;
+				}
+
+				flags[player].insert(flags[player].end(), run, action_flags);
+				count += run;
+			}
+		}
+	}
+
+	size_t ticks = flags[0].size();
+	for (auto& player_flags : flags)
+	{
+		ticks = std::min(ticks, player_flags.size());
+	}
+	for (auto& player_flags : flags)
+	{
+		player_flags.resize(ticks);
+	}
+
+	return flags;
+}
+
+struct Scenario {
+	const char *name;
+	bool bandwidth_reduction;
+	uint64_t raw_bytes = 0;
+	uint64_t compact_bytes = 0;
+};
+
+// one hub-to-spoke game data packet: header, ACK, end of messages, then the flags for
+// [start, end) of everyone but the spoke; returns its size
+static int encode_packet(uint8 *buffer, const std::vector<std::vector<action_flags_t>>& flags, size_t num_players, size_t spoke, int32 start, int32 end, bool compact)
+{
+	AOStreamBE ps(buffer, kPacketSize, 4);
+	if (compact)
+		write_compact_tick(ps, end);
+	else
+		ps << end;
+	ps << static_cast<uint16>(0x454d);	// kEndOfMessagesMessageType
+
+	CompactActionFlagsWriter writer(ps, num_players);
+	for (int32 tick = start; tick < end; ++tick)
+	{
+		if (compact && ps.maxp() - ps.tellp() < kCompactActionFlagsMaxLength * (2 * num_players + 2))
+			break;
+
+		if (tick == start)
+		{
+			if (compact)
+				write_compact_tick(ps, start);
+			else
+				ps << start;
+		}
+
+		for (size_t player = 0; player < num_players; ++player)
+		{
+			if (player == spoke)
+				continue;
+
+			if (compact)
+				writer.write(player, flags[player][tick]);
+			else
+				ps << flags[player][tick];
+		}
+	}
+	writer.flush();
+
+	return ps.tellp();
+}
+
+// reads a compact packet back as the spoke does
+static bool check_packet(const uint8 *buffer, int size, const std::vector<std::vector<action_flags_t>>& flags, size_t num_players, size_t spoke, int32 start, int32 end)
+{
+	try {
+		AIStreamBE ps(buffer, size, 4);
+		if (read_compact_tick(ps) != end)
+			return false;
+
+		uint16 end_of_messages;
+		ps >> end_of_messages;
+		if (ps.tellg() >= ps.maxg())
+			return start == end;
+
+		int32 tick = read_compact_tick(ps);
+		if (tick != start)
+			return false;
+
+		CompactActionFlagsReader reader(ps, num_players);
+		for (; ps.tellg() < ps.maxg() || reader.pending(); ++tick)
+		{
+			if (tick >= end)
+				return false;
+
+			for (size_t player = 0; player < num_players; ++player)
+			{
+				if (player != spoke && reader.read(player) != flags[player][tick])
+					return false;
+			}
+		}
+
+		return true;
+	}
+	catch (const AStream::failure&)
+	{
+		return false;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int latency = 5;
+	std::vector<std::string> films;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+		{
+			latency = std::atoi(argv[++i]);
+		}
+		else
+		{
+			films.push_back(argv[i]);
+		}
+	}
+
+	if (films.empty() || latency < 1 || latency > 15)
+	{
+		std::cerr << "usage: " << argv[0] << " [--latency <ticks>] <film>...\n";
+		return 1;
+	}
+
+	struct PlayerCount {
+		int films = 0;
+		uint64_t ticks = 0;
+		Scenario scenarios[2] = { { "bandwidth_reduction", true }, { "full_window", false } };
+	};
+	PlayerCount counts[kMaximumPlayers + 1];
+
+	bool round_trip = true;
+	int films_read = 0;
+	std::vector<uint8> buffer(kPacketSize);
+
+	for (const auto& path : films)
+	{
+		auto flags = read_film_flags(path);
+		if (flags.size() < 2 || flags[0].empty())
+		{
+			std::cerr << path << ": skipped (not a network film)\n";
+			continue;
+		}
+
+		++films_read;
+		int32 ticks = flags[0].size();
+		for (size_t num_players = 2; num_players <= flags.size(); ++num_players)
+		{
+			auto& count = counts[num_players];
+			++count.films;
+			count.ticks += ticks;
+
+			for (auto& scenario : count.scenarios)
+			{
+				for (int32 tick = 1; tick <= ticks; ++tick)
+				{
+					for (size_t spoke = 0; spoke < num_players; ++spoke)
+					{
+						int32 window = latency;
+						if (scenario.bandwidth_reduction)
+						{
+							// spokes' recovery updates fall on different ticks
+							window = ((tick + spoke) % latency == 0) ? 4 * latency : 3;
+						}
+						int32 start = std::max(0, tick - window);
+
+						scenario.raw_bytes += encode_packet(buffer.data(), flags, num_players, spoke, start, tick, false);
+
+						int size = encode_packet(buffer.data(), flags, num_players, spoke, start, tick, true);
+						scenario.compact_bytes += size;
+						if (!check_packet(buffer.data(), size, flags, num_players, spoke, start, tick))
+						{
+							if (round_trip)
+								std::cerr << path << ": compact packet for spoke " << spoke << " of " << num_players << " at tick " << tick << " doesn't decode\n";
+							round_trip = false;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(2) << "{\n  \"films\": " << films_read << ",\n"
+		  << "  \"latency_ticks\": " << latency << ",\n"
+		  << "  \"round_trip\": " << (round_trip ? "true" : "false") << ",\n  \"players\": [";
+	bool first = true;
+	for (int num_players = 2; num_players <= kMaximumPlayers; ++num_players)
+	{
+		const auto& count = counts[num_players];
+		if (!count.ticks)
+			continue;
+
+		std::cout << (first ? "\n" : ",\n") << "    {\n"
+			  << "      \"players\": " << num_players << ",\n"
+			  << "      \"films\": " << count.films << ",\n"
+			  << "      \"ticks\": " << count.ticks << ",\n";
+		first = false;
+		for (size_t i = 0; i < 2; ++i)
+		{
+			const auto& scenario = count.scenarios[i];
+			double raw = static_cast<double>(scenario.raw_bytes) / count.ticks;
+			double compact = static_cast<double>(scenario.compact_bytes) / count.ticks;
+			std::cout << "      \"" << scenario.name << "\": { "
+				  << "\"raw_bytes_per_tick\": " << raw << ", "
+				  << "\"compact_bytes_per_tick\": " << compact << ", "
+				  << "\"saved\": " << (raw > 0 ? 1 - compact / raw : 0) << " }"
+				  << (i == 0 ? ",\n" : "\n");
+		}
+		std::cout << "    }";
+	}
+	std::cout << "\n  ]\n}\n";
+
+	return films_read && round_trip ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+#include "low_level_textures_simd.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Runs every texture-mapper implementation this CPU supports over the same random spans and
+// columns, checks that each writes exactly the pixels the scalar reference does, and
+// reports how fast each one was as JSON.  Exits nonzero on any mismatch.
+//
+// alephone_texture_benchmark [<iterations>]
+
+static const int texture_bits = 7;
+static const int texture_size = 1 << texture_bits;
+static const int screen_width = 640;
+static const int screen_height = 480;
+static const int number_of_shading_tables = 4;
+
+struct TextureTestData {
+	std::vector<pixel8> texture;
+	std::vector<pixel32> shading_tables;
+	std::vector<pixel32> screen;
+
+	struct Span {
+		texture_span32 span;
+		int count;
+		bool average;
+	};
+	std::vector<Span> spans;
+
+	struct Columns {
+		texture_columns32 columns;
+		int count;
+		bool check_transparent;
+		bool average;
+	};
+	std::vector<Columns> columns;
+};
+
+static TextureTestData make_test_data(int iterations) {
+	std::mt19937 random(6906);
+	auto random_word = [&random]() { return static_cast<uint32>(random()); };
+
+	TextureTestData data;
+
+	data.texture.resize(texture_size * texture_size);
+	for (auto& texel : data.texture) {
+		// plenty of transparent texels
+		texel = (random() % 4 == 0) ? 0 : random() % 256;
+	}
+
+	data.shading_tables.resize(number_of_shading_tables * 256);
+	for (auto& pixel : data.shading_tables) {
+		pixel = random_word();
+	}
+
+	data.screen.resize(screen_width * screen_height);
+
+	for (int i = 0; i < iterations; ++i) {
+		TextureTestData::Span span = {};
+		span.span.write = nullptr; // pointed at the screen when run
+		span.span.texture = data.texture.data();
+		span.span.shading_table = &data.shading_tables[(random() % number_of_shading_tables) * 256];
+		span.span.source_x = random_word();
+		span.span.source_y = random_word();
+		span.span.source_dx = random_word() >> (random() % 12);
+		span.span.source_dy = random_word() >> (random() % 12);
+		span.span.x_downshift = 32 - texture_bits;
+		span.span.y_downshift = 32 - 2 * texture_bits;
+		span.span.y_mask = ((1 << texture_bits) - 1) << texture_bits;
+		span.count = 1 + random() % screen_width;
+		span.average = random() % 2;
+		data.spans.push_back(span);
+
+		TextureTestData::Columns columns = {};
+		columns.columns.bytes_per_row = screen_width * sizeof(pixel32);
+		for (int j = 0; j < 4; ++j) {
+			columns.columns.read[j] = &data.texture[(random() % texture_size) * texture_size];
+			columns.columns.shading_table[j] = &data.shading_tables[(random() % number_of_shading_tables) * 256];
+			columns.columns.texture_y[j] = random_word();
+			columns.columns.texture_dy[j] = random_word() >> (random() % 12);
+		}
+		columns.columns.downshift = 32 - texture_bits;
+		columns.count = 1 + random() % screen_height;
+		columns.check_transparent = random() % 2;
+		columns.average = random() % 2;
+		data.columns.push_back(columns);
+	}
+
+	return data;
+}
+
+struct MapperResult {
+	const char* name;
+	double span_seconds;
+	double column_seconds;
+	bool matches;
+};
+
+// runs every span, then every column set, each from the same starting screen, and returns
+// everything they left behind: where each stopped in the texture and both final screens
+static std::vector<pixel32> run_mapper(const texture_mapper32& mapper, TextureTestData& data, MapperResult& result) {
+	std::vector<pixel32> output;
+	std::mt19937 random(1);
+
+	auto reset_screen = [&]() {
+		for (auto& pixel : data.screen) {
+			pixel = static_cast<uint32>(random());
+		}
+	};
+
+	double span_seconds = 0;
+	reset_screen();
+	for (auto& test : data.spans) {
+		auto span = test.span;
+		span.write = &data.screen[(random() % screen_height) * screen_width + (screen_width - test.count)];
+
+		auto start = std::chrono::steady_clock::now();
+		mapper.map_span(span, test.count, test.average);
+		span_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// where the mapper left off has to match too
+		output.push_back(span.source_x);
+		output.push_back(span.source_y);
+	}
+	output.insert(output.end(), data.screen.begin(), data.screen.end());
+
+	double column_seconds = 0;
+	reset_screen();
+	for (auto& test : data.columns) {
+		auto columns = test.columns;
+		columns.write = &data.screen[(screen_height - test.count) * screen_width + random() % (screen_width - 3)];
+
+		auto start = std::chrono::steady_clock::now();
+		mapper.map_columns(columns, test.count, test.check_transparent, test.average);
+		column_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		output.insert(output.end(), columns.texture_y, columns.texture_y + 4);
+	}
+	output.insert(output.end(), data.screen.begin(), data.screen.end());
+
+	result.name = mapper.name;
+	result.span_seconds = span_seconds;
+	result.column_seconds = column_seconds;
+	return output;
+}
+
+int main(int argc, char* argv[]) {
+
+	int iterations = 20000;
+	if (argc > 1) {
+		iterations = std::atoi(argv[1]);
+	}
+	if (argc > 2 || iterations <= 0) {
+		std::cerr << "usage: " << argv[0] << " [<iterations>]\n";
+		return 1;
+	}
+
+	auto data = make_test_data(iterations);
+	auto mappers = get_available_texture_mappers32();
+
+	std::vector<MapperResult> results;
+	std::vector<pixel32> reference;
+	bool all_match = true;
+
+	for (const auto& mapper : mappers) {
+		MapperResult result{};
+		auto output = run_mapper(mapper, data, result);
+
+		if (reference.empty()) {
+			reference = output;
+		}
+		result.matches = (output == reference);
+		all_match = all_match && result.matches;
+		results.push_back(result);
+	}
+
+	std::cout << std::setprecision(6) << "{\n  \"iterations\": " << iterations << ",\n"
+			  << "  \"selected\": \"" << get_texture_mapper32().name << "\",\n  \"mappers\": [";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& result = results[i];
+		std::cout << (i ? ",\n" : "\n") << "    {\n"
+				  << "      \"name\": \"" << result.name << "\",\n"
+				  << "      \"matches_scalar\": " << (result.matches ? "true" : "false") << ",\n"
+				  << "      \"span_seconds\": " << result.span_seconds << ",\n"
+				  << "      \"column_seconds\": " << result.column_seconds << ",\n"
+				  << "      \"span_speedup\": " << (result.span_seconds > 0 ? results[0].span_seconds / result.span_seconds : 0) << ",\n"
+				  << "      \"column_speedup\": " << (result.column_seconds > 0 ? results[0].column_seconds / result.column_seconds : 0) << "\n"
+				  << "    }";
+	}
+	std::cout << "\n  ]\n}\n";
+
+	return all_match ? 0 : 1;
+}
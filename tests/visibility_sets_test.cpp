@@ -0,0 +1,153 @@
+#include "shell.h"
+#include "world.h"
+#include "map.h"
+#include "FileHandler.h"
+#include "shell_options.h"
+#include "game_wad.h"
+#include "wad.h"
+#include "dynamic_limits.h"
+#include "visibility_sets.h"
+#include "InfoTree.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+extern ShellOptions shell_options;
+
+// Checks that the potentially-visible sets are conservative on every level of the
+// scenario's map: wherever the line of sight (or sound) walk in line_is_obstructed()
+// gets from one polygon to another, the sets must say the second polygon may be seen
+// (or heard) from the first.  Walks start from each polygon's center and from a point
+// a quarter of the way in from each of its vertices, and end at the other polygon's
+// center.  Exits non-zero if the sets would hide anything the walk can reach.
+//
+// alephone_visibility_sets_test <scenario directory>
+
+struct Mismatch {
+	short polygon_index1;
+	short polygon_index2;
+	bool for_sounds;
+};
+
+static std::vector<world_point2d> sample_points(short polygon_index) {
+	polygon_data* polygon = get_polygon_data(polygon_index);
+
+	std::vector<world_point2d> points{ polygon->center };
+	for (short i = 0; i < polygon->vertex_count; ++i) {
+		world_point2d vertex = get_endpoint_data(polygon->endpoint_indexes[i])->vertex;
+		points.push_back({ static_cast<world_distance>(vertex.x + (polygon->center.x - vertex.x) / 4),
+		                   static_cast<world_distance>(vertex.y + (polygon->center.y - vertex.y) / 4) });
+	}
+
+	return points;
+}
+
+// which polygons the walk reaches from each polygon, with the sets out of the way
+static std::vector<std::vector<bool>> walk_reachable(bool for_sounds) {
+	short polygon_count = dynamic_world->polygon_count;
+	std::vector<std::vector<world_point2d>> points(polygon_count);
+	for (short i = 0; i < polygon_count; ++i) {
+		points[i] = sample_points(i);
+	}
+
+	std::vector<std::vector<bool>> reachable(polygon_count, std::vector<bool>(polygon_count, false));
+	for (short i = 0; i < polygon_count; ++i) {
+		if (POLYGON_IS_DETACHED(get_polygon_data(i))) continue;
+
+		for (short j = 0; j < polygon_count; ++j) {
+			if (POLYGON_IS_DETACHED(get_polygon_data(j))) continue;
+
+			for (auto& p1 : points[i]) {
+				if (line_is_obstructed(i, &p1, j, &points[j][0], for_sounds)) continue;
+
+				reachable[i][j] = true;
+				break;
+			}
+		}
+	}
+
+	return reachable;
+}
+
+static void find_mismatches(const std::vector<std::vector<bool>>& reachable, bool for_sounds, std::vector<Mismatch>& mismatches) {
+	for (short i = 0; i < static_cast<short>(reachable.size()); ++i) {
+		for (short j = 0; j < static_cast<short>(reachable.size()); ++j) {
+			if (!reachable[i][j]) continue;
+
+			bool may_reach = for_sounds ? polygon_may_hear_polygon(i, j) : polygon_may_see_polygon(i, j);
+			if (!may_reach) {
+				mismatches.push_back({ i, j, for_sounds });
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[]) {
+	shell_options.parse(argc, argv);
+	shell_options.headless = true;
+
+	if (shell_options.directory.empty()) {
+		std::cerr << "usage: " << shell_options.program_name << " <scenario directory>\n";
+		return 1;
+	}
+
+	initialize_application();
+
+	// build sets for every map, however small
+	std::istringstream limits("<dynamic_limits><visibility_sets value=\"1\"/></dynamic_limits>");
+	InfoTree limits_tree = InfoTree::load_xml(limits);
+	for (const InfoTree& child : limits_tree.children_named("dynamic_limits")) {
+		parse_mml_dynamic_limits(child);
+	}
+
+	FileSpecifier& map_file = get_map_file();
+	OpenedFile opened_map;
+	wad_header header;
+	if (!open_wad_file_for_reading(map_file, opened_map) || !read_wad_header(opened_map, &header)) {
+		std::cerr << "couldn't read the map " << map_file.GetPath() << "\n";
+		shutdown_application();
+		return 1;
+	}
+	opened_map.Close();
+
+	int failures = 0;
+	for (short level = 0; level < header.wad_count; ++level) {
+		if (!load_level_from_map(level)) {
+			std::cerr << "level " << level << ": couldn't load\n";
+			++failures;
+			continue;
+		}
+
+		// without sets, line_is_obstructed() always walks
+		clear_visibility_sets();
+		auto visible = walk_reachable(false);
+		auto audible = walk_reachable(true);
+
+		build_visibility_sets();
+		if (!wait_for_visibility_sets()) {
+			std::cerr << "level " << level << ": no visibility sets were built\n";
+			++failures;
+			continue;
+		}
+
+		std::vector<Mismatch> mismatches;
+		find_mismatches(visible, false, mismatches);
+		find_mismatches(audible, true, mismatches);
+
+		std::cout << "level " << level << ": " << dynamic_world->polygon_count << " polygons, "
+		          << mismatches.size() << " walks the sets would have skipped\n";
+		for (auto& mismatch : mismatches) {
+			std::cout << "  polygon " << mismatch.polygon_index1 << (mismatch.for_sounds ? " hears " : " sees ")
+			          << "polygon " << mismatch.polygon_index2 << "\n";
+		}
+		if (!mismatches.empty()) {
+			++failures;
+		}
+	}
+
+	clear_visibility_sets();
+	shutdown_application();
+
+	return failures ? 1 : 0;
+}